@@ -55,7 +55,8 @@ fi
 
 cd $scriptDir/build
 
-cmake -S $scriptDir/cmake -B $scriptDir/build
+# 额外参数透传给 cmake，如单体构建：./build.sh -DCMAKE_BUILD_TYPE=Release -DBASENODE_MONOLITH=ON
+cmake -S $scriptDir/cmake -B $scriptDir/build "$@"
 
 make -j8
 
@@ -28,6 +28,38 @@ if(NOT CMAKE_BUILD_TYPE)
     set(CMAKE_BUILD_TYPE Debug CACHE STRING "Build type" FORCE)
 endif()
 
+# ThreadSanitizer 构建（basenode_test 的并发用例需要在此构建下运行），对所有目标生效
+option(BASENODE_TSAN "Build everything with -fsanitize=thread" OFF)
+if(BASENODE_TSAN)
+    add_compile_options(-fsanitize=thread -g)
+    add_link_options(-fsanitize=thread)
+endif()
+
+# ============================================================================
+# 单体构建：basenode_core 和各模块不再编译成 .so，而是作为目标文件静态链接进 basenode，
+# 插件加载器从链接期注册表中查找模块入口（见 plugin_descriptor.h），plugins.modules 选择启用哪些模块
+# 示例: cmake -S cmake -B build -DCMAKE_BUILD_TYPE=Release -DBASENODE_MONOLITH=ON -DBASENODE_MONOLITH_MODULES="service_discovery;player_module;guild_module"
+# 单体构建是一种打包方式（单个可执行文件、不依赖 lib 目录），对启动耗时和 RPC 延迟的影响尚未测量，
+# 不要以性能为由选用它；需要对比时运行 ./monolith_compare.sh 并以其结果为准
+# ============================================================================
+option(BASENODE_MONOLITH "Link basenode_core and all modules statically into the basenode binary instead of loading .so plugins" OFF)
+option(BASENODE_MONOLITH_LTO "Enable link-time optimization across modules in the monolith build" ON)
+set(BASENODE_MONOLITH_MODULES "" CACHE STRING "Module targets linked into the monolith basenode binary (empty: all modules)")
+
+if(BASENODE_MONOLITH)
+    # OBJECT 库：目标文件直接链接进主程序，不会像静态库那样丢弃未被引用的目标文件（链接期注册表项）
+    set(BASENODE_LIBRARY_TYPE OBJECT)
+    if(BASENODE_MONOLITH_LTO)
+        include(CheckIPOSupported)
+        check_ipo_supported(RESULT BASENODE_IPO_SUPPORTED OUTPUT ipo_output LANGUAGES CXX)
+        if(NOT BASENODE_IPO_SUPPORTED)
+            message(WARNING "LTO is not supported by the compiler, monolith build without LTO: ${ipo_output}")
+        endif()
+    endif()
+else()
+    set(BASENODE_LIBRARY_TYPE SHARED)
+endif()
+
 # ============================================================================
 # 第三方库配置
 # ============================================================================
@@ -45,6 +77,10 @@ endfunction()
 
 # 设置目标的输出目录（库和可执行文件）
 function(SET_TARGET_OUTPUT_DIR target_name output_dir)
+    get_target_property(target_type ${target_name} TYPE)
+    if(target_type STREQUAL "OBJECT_LIBRARY")
+        return()  # 单体构建的 OBJECT 库没有输出文件，也不能添加 PRE_BUILD 命令
+    endif()
     set_target_properties(${target_name} PROPERTIES
         ARCHIVE_OUTPUT_DIRECTORY ${output_dir}
         LIBRARY_OUTPUT_DIRECTORY ${output_dir}
@@ -55,6 +91,18 @@ function(SET_TARGET_OUTPUT_DIR target_name output_dir)
     )
 endfunction()
 
+# 配置核心库 / 模块库的单体构建属性（内部函数）
+# 参数:
+#   target_name - 目标名称，动态构建时的库文件名为 lib${target_name}.so
+function(CONFIGURE_PLUGIN_LIBRARY target_name)
+    # 单体构建中插件按库文件名在链接期注册表中登记，与配置中的 plugins.modules 对应
+    target_compile_definitions(${target_name} PRIVATE BASENODE_PLUGIN_LIBRARY_NAME="lib${target_name}.so")
+    set_property(GLOBAL APPEND PROPERTY BASENODE_PLUGIN_TARGETS ${target_name})
+    if(BASENODE_MONOLITH AND BASENODE_MONOLITH_LTO AND BASENODE_IPO_SUPPORTED)
+        set_property(TARGET ${target_name} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+    endif()
+endfunction()
+
 # 设置目标的编译选项（通用部分）
 function(SET_TARGET_COMPILE_OPTIONS target_name export_symbols)
     if(export_symbols)
@@ -105,6 +153,11 @@ function(CONFIGURE_CORE_LIBRARY target_name)
     target_link_libraries(${target_name} PUBLIC toolbox)
     SET_TARGET_OUTPUT_DIR(${target_name} ${ROOT_PATH}/lib)
     SET_TARGET_COMPILE_OPTIONS(${target_name} TRUE)
+    CONFIGURE_PLUGIN_LIBRARY(${target_name})
+    if(BASENODE_MONOLITH)
+        # 链接 basenode_core 的目标（模块、主程序、基准）都按单体方式编译插件描述符和加载器
+        target_compile_definitions(${target_name} PUBLIC BASENODE_MONOLITH)
+    endif()
 endfunction()
 
 # 创建并配置核心共享库
@@ -120,8 +173,8 @@ function(ADD_CORE_LIBRARY name)
     # 收集所有源文件
     set(${name}_SRCS ${ARGN})
     
-    # 创建共享库
-    add_library(${name} SHARED ${${name}_SRCS})
+    # 创建共享库（单体构建时为 OBJECT 库）
+    add_library(${name} ${BASENODE_LIBRARY_TYPE} ${${name}_SRCS})
     
     # 配置核心库属性
     CONFIGURE_CORE_LIBRARY(${name})
@@ -158,6 +211,7 @@ function(CONFIGURE_MODULE_LIBRARY target_name source_dir)
     target_link_libraries(${target_name} PRIVATE basenode_core)
     SET_TARGET_OUTPUT_DIR(${target_name} ${ROOT_PATH}/lib)
     SET_TARGET_COMPILE_OPTIONS(${target_name} ${should_export_symbols})
+    CONFIGURE_PLUGIN_LIBRARY(${target_name})
     
     if(should_export_symbols)
         message(STATUS "Configured ${target_name} with exported symbols (base library)")
@@ -340,9 +394,9 @@ function(ADD_SHARED_LIBRARY_FROM_DIR name source_dir)
 
     # 收集源文件
     AUX_SOURCE_DIRECTORY(${source_dir} ${name}_SRCS)
-    # 收集 module 目录的源文件，但排除 module_router.cpp 和 module_interface.cpp（它们在 basenode_core 中编译）
+    # 收集 module 目录的源文件，但排除 module_*.cpp（它们在 basenode_core 中编译，进程内只能有一份）
     AUX_SOURCE_DIRECTORY(${SRC_CORE_PATH}/module ${name}_TMP_MODULE_SRCS)
-    list(FILTER ${name}_TMP_MODULE_SRCS EXCLUDE REGEX ".*module_(router|interface)\\.cpp$")
+    list(FILTER ${name}_TMP_MODULE_SRCS EXCLUDE REGEX ".*/module_[^/]*\\.cpp$")
     
     # 如果是 config 模块，添加 pugixml.cpp
     if(${name} STREQUAL "config")
@@ -352,8 +406,8 @@ function(ADD_SHARED_LIBRARY_FROM_DIR name source_dir)
     list(APPEND ${name}_SRCS ${${name}_TMP_MODULE_SRCS})
     message(STATUS "${name}_SRCS -> ${${name}_SRCS}")
     
-    # 创建共享库
-    ADD_LIBRARY(${name} SHARED ${${name}_SRCS})
+    # 创建共享库（单体构建时为 OBJECT 库）
+    ADD_LIBRARY(${name} ${BASENODE_LIBRARY_TYPE} ${${name}_SRCS})
     
     # 确保 basenode_core 在模块之前构建
     if(TARGET basenode_core)
@@ -495,3 +549,27 @@ function(ADD_EXECUTABLE_FROM_DIRS name)
     endif()
 endfunction()
 
+
+# 单体构建：把选中的模块链接进可执行文件
+# 参数:
+#   name - 可执行文件名称（已链接 basenode_core 和 config）
+# 选中的模块由 BASENODE_MONOLITH_MODULES 指定（为空时链接全部模块），运行时再由 plugins.modules 选择启用哪些
+function(LINK_MONOLITH_MODULES name)
+    get_property(plugin_targets GLOBAL PROPERTY BASENODE_PLUGIN_TARGETS)
+    if(BASENODE_MONOLITH_MODULES)
+        set(selected_targets ${BASENODE_MONOLITH_MODULES})
+    else()
+        set(selected_targets ${plugin_targets})
+    endif()
+    foreach(module ${selected_targets})
+        if(NOT module IN_LIST plugin_targets)
+            message(FATAL_ERROR "LINK_MONOLITH_MODULES: unknown module ${module}, available: ${plugin_targets}")
+        endif()
+    endforeach()
+    # OBJECT 库只有直接链接时目标文件才会进入可执行文件，重复链接的目标由 CMake 去重
+    target_link_libraries(${name} PRIVATE ${selected_targets})
+    if(BASENODE_MONOLITH_LTO AND BASENODE_IPO_SUPPORTED)
+        set_property(TARGET ${name} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+    endif()
+    message(STATUS "Linked modules into ${name}: ${selected_targets}")
+endfunction()
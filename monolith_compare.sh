@@ -0,0 +1,37 @@
+#!/usr/bin/sh
+
+# 对比动态插件构建与单体构建（-DBASENODE_MONOLITH=ON）：
+#   启动耗时：插件加载的 startup timing（wall 和各插件的 dlopen / initSo）
+#   RPC 延迟：config/loadgen.json 的压测结果（吞吐、p50/p99/p999）
+# 用法: ./monolith_compare.sh [每种构建的运行次数，默认 3]
+# 两种构建先后输出到同一个 bin/lib，结果保存在 build/monolith_compare/ 下的 {dynamic,monolith}-<n>.log / .json
+# 单体构建目前没有经过测量的性能结论，选用前先用本脚本在目标机器上对比
+
+scriptDir=$(cd $(dirname $0); pwd)
+runs=${1:-3}
+outDir=$scriptDir/build/monolith_compare
+mkdir -p $outDir $scriptDir/logs
+
+# 日志级别改为 INFO 才会输出 startup timing；配置名取自文件名，复制后仍叫 loadgen.json
+sed 's/"level": "WARN"/"level": "INFO"/' $scriptDir/config/loadgen.json > $outDir/loadgen.json
+
+for variant in dynamic monolith; do
+    if [ $variant = monolith ]; then
+        monolith=ON
+    else
+        monolith=OFF
+    fi
+    $scriptDir/build.sh -DCMAKE_BUILD_TYPE=Release -DBASENODE_MONOLITH=$monolith || exit 1
+
+    cd $scriptDir
+    i=1
+    while [ $i -le $runs ]; do
+        # loadgen 配置了 exit_on_finish，压测结束后进程自行退出
+        ./bin/basenode $outDir/loadgen.json > $outDir/$variant-$i.log 2>&1
+        cp ./logs/loadgen_report.json $outDir/$variant-$i.json
+        echo "== $variant run $i"
+        grep "startup timing" $outDir/$variant-$i.log
+        sed -n '/\[LoadGen\] .*throughput/,$p' $outDir/$variant-$i.log
+        i=$((i + 1))
+    done
+done
@@ -0,0 +1,61 @@
+#include "bench_harness.h"
+#include "bench_modules.h"
+#include <cstdint>
+
+// 完整调用往返的微基准：调用方发出请求 -> 路由 -> 被调用方处理 -> 回包路由 -> 调用方继续执行
+// 两个模块在同一个线程上交替 Update，测得的是框架本身的开销，不含线程切换和网络
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_CALL_BATCH_CALLS 64          // 批量调用用例每次迭代发出的调用数（达到 rpc_batch.max_calls 立即发送）
+
+// 交替驱动两个模块直到完成的调用数达到 expected
+void PumpUntil(BenchModules& modules, const uint64_t& completed, uint64_t expected)
+{
+    while (completed < expected) {
+        modules.echo.Update();
+        modules.client.Update();
+    }
+}
+
+} // namespace
+
+void RegisterCallBenchmarks(BenchRunner& runner)
+{
+    // 序列化 + 路由 + 反序列化 + 回包
+    runner.Add("call/rpc_round_trip", [](BenchState& state) {
+        BenchModules& modules = GetBenchModules();
+        uint64_t completed = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            modules.client.CallModuleService<&BenchEcho::Echo>(i).then([&completed](auto) { ++completed; });
+            PumpUntil(modules, completed, i + 1);
+        }
+    });
+    // 进程内直接调用：参数和结果以闭包投递，不序列化
+    runner.Add("call/local_round_trip", [](BenchState& state) {
+        BenchModules& modules = GetBenchModules();
+        uint64_t completed = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            modules.client.CallModuleServiceLocal<&BenchEcho::Echo>([&completed](uint64_t) { ++completed; }, i);
+            PumpUntil(modules, completed, i + 1);
+        }
+    });
+    // 批量调用：64 个请求合并为一个批量帧，结果按单个调用折算
+    runner.Add("call/batch_round_trip", [](BenchState& state) {
+        BenchModules& modules = GetBenchModules();
+        uint64_t completed = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            for (uint32_t j = 0; j < BENCH_CALL_BATCH_CALLS; ++j) {
+                modules.client.CallModuleServiceBatch<&BenchEcho::Echo>(i).then([&completed](auto) { ++completed; });
+            }
+            PumpUntil(modules, completed, (i + 1) * BENCH_CALL_BATCH_CALLS);
+        }
+        state.SetItemsPerIteration(BENCH_CALL_BATCH_CALLS);
+    });
+}
+
+} // namespace BaseNode
@@ -0,0 +1,203 @@
+#include "bench_harness.h"
+#include "module/module_buffer.h"
+#include "module/module_event.h"
+#include "module/module_mailbox.h"
+#include "module/module_options.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ModuleEvent、模块邮箱和数据包缓冲区的微基准
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_EVENT_PAYLOAD_SIZE 128       // 典型的小 RPC 请求帧大小
+#define BENCH_MAILBOX_BURST 256            // 邮箱用例每次连续入队的事件数（不超过一个块）
+
+ModuleEvent MakeEvent(size_t payload_size)
+{
+    ModuleEvent event;
+    event.type_ = ModuleEvent::EventType::ET_RPC_REQUEST;
+    event.payload_ = ModuleBufferPoolMgr->Allocate(payload_size);
+    event.envelope_.service_id = 1;
+    event.envelope_.client_id = 2;
+    event.envelope_.valid = true;
+    return event;
+}
+
+MailboxOptions BenchMailboxOptions()
+{
+    MailboxOptions options;
+    options.capacity = 64 * 1024;
+    options.release_idle_ms = 0;
+    return options;
+}
+
+// 单线程入队再出队，测量每个事件的入队 + 出队开销（不含线程间缓存行传递）
+void BenchMailboxPushPop(BenchState& state)
+{
+    state.PauseTiming();
+    auto mailbox = std::make_unique<ModuleMailbox>();
+    mailbox->Configure(BenchMailboxOptions());
+    mailbox->BindConsumerThread();
+    ModuleEvent templ = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+    ModuleEvent out;
+    state.ResumeTiming();
+    for (uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (uint32_t j = 0; j < BENCH_MAILBOX_BURST; ++j) {
+            ModuleEvent event;
+            event.type_ = templ.type_;
+            event.envelope_ = templ.envelope_;
+            event.payload_ = templ.payload_;
+            mailbox->Push(std::move(event));
+        }
+        while (mailbox->TryPop(out)) {
+            DoNotOptimize(out.envelope_.service_id);
+        }
+    }
+    state.SetItemsPerIteration(BENCH_MAILBOX_BURST);
+}
+
+// 三个优先级通道交替入队，按权重出队
+void BenchPriorityMailboxPushPop(BenchState& state)
+{
+    state.PauseTiming();
+    auto mailbox = std::make_unique<ModulePriorityMailbox>();
+    mailbox->Configure(BenchMailboxOptions());
+    mailbox->BindConsumerThread();
+    ModuleEvent templ = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+    ModuleEvent out;
+    state.ResumeTiming();
+    for (uint64_t i = 0; i < state.Iterations(); ++i) {
+        for (uint32_t j = 0; j < BENCH_MAILBOX_BURST; ++j) {
+            ModuleEvent event;
+            event.type_ = templ.type_;
+            event.envelope_ = templ.envelope_;
+            event.payload_ = templ.payload_;
+            mailbox->Push(std::move(event), static_cast<RpcPriority>(j % MODULE_MAILBOX_LANE_NUM));
+        }
+        while (mailbox->TryPop(out)) {
+            DoNotOptimize(out.envelope_.service_id);
+        }
+    }
+    state.SetItemsPerIteration(BENCH_MAILBOX_BURST);
+}
+
+// producers 个生产者线程持续入队，当前线程作为消费者出队，测量跨线程吞吐（每个事件的平均耗时）
+void BenchMailboxThreaded(BenchState& state, uint32_t producers)
+{
+    state.PauseTiming();
+    auto mailbox = std::make_unique<ModuleMailbox>();
+    mailbox->Configure(BenchMailboxOptions());
+    mailbox->BindConsumerThread();
+    const uint64_t total = state.Iterations() * BENCH_MAILBOX_BURST;
+    const uint64_t per_producer = total / producers;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            ModuleEvent templ = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+            uint64_t count = per_producer + (p == 0 ? total % producers : 0);
+            while (!start.load(std::memory_order_acquire)) {
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                ModuleEvent event;
+                event.type_ = templ.type_;
+                event.envelope_ = templ.envelope_;
+                event.payload_ = templ.payload_;
+                while (mailbox->Push(std::move(event)) != ErrorCode::BN_SUCCESS) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    ModuleEvent out;
+    state.ResumeTiming();
+    start.store(true, std::memory_order_release);
+    uint64_t received = 0;
+    while (received < total) {
+        if (mailbox->TryPop(out)) {
+            ++received;
+        }
+    }
+    state.PauseTiming();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    state.SetItemsPerIteration(BENCH_MAILBOX_BURST);
+}
+
+} // namespace
+
+void RegisterEventBenchmarks(BenchRunner& runner)
+{
+    // 事件移动：路由和入队全程只移动事件
+    runner.Add("event/move", [](BenchState& state) {
+        ModuleEvent a = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+        ModuleEvent b;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            b = std::move(a);
+            a = std::move(b);
+            ClobberMemory();
+        }
+        state.SetItemsPerIteration(2);
+    });
+    // 事件拷贝（ModuleEvent 只能移动，这里拷贝协议头和负载切片，即共享缓冲区时的开销）
+    runner.Add("event/copy_shared_payload", [](BenchState& state) {
+        ModuleEvent a = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            ModuleEvent b;
+            b.type_ = a.type_;
+            b.envelope_ = a.envelope_;
+            b.payload_ = a.payload_;
+            DoNotOptimize(b.payload_.Data());
+        }
+    });
+    // 事件深拷贝（负载拷贝到新的缓冲区），即切片化之前每一跳的开销
+    runner.Add("event/copy_deep_payload", [](BenchState& state) {
+        ModuleEvent a = MakeEvent(BENCH_EVENT_PAYLOAD_SIZE);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            ModuleEvent b;
+            b.type_ = a.type_;
+            b.envelope_ = a.envelope_;
+            b.payload_ = BufferSlice::CopyFrom(a.payload_.Data(), a.payload_.Size());
+            DoNotOptimize(b.payload_.Data());
+        }
+    });
+
+    runner.Add("mailbox/push_pop", BenchMailboxPushPop);
+    runner.Add("mailbox/priority_push_pop", BenchPriorityMailboxPushPop);
+    runner.Add("mailbox/spsc_threaded", [](BenchState& state) { BenchMailboxThreaded(state, 1); });
+    runner.Add("mailbox/mpsc_4_producers", [](BenchState& state) { BenchMailboxThreaded(state, 4); });
+
+    // 数据包缓冲区：缓冲池分配 vs 每个数据包一次堆分配
+    runner.Add("buffer/pool_allocate_release", [](BenchState& state) {
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            BufferSlice slice = ModuleBufferPoolMgr->Allocate(BENCH_EVENT_PAYLOAD_SIZE);
+            DoNotOptimize(slice.Data());
+        }
+    });
+    runner.Add("buffer/std_string_allocate_release", [](BenchState& state) {
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            std::string data(BENCH_EVENT_PAYLOAD_SIZE, '\0');
+            DoNotOptimize(data.data());
+        }
+    });
+    runner.Add("buffer/adopt_string", [](BenchState& state) {
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            state.PauseTiming();
+            std::string data(BENCH_EVENT_PAYLOAD_SIZE, '\0');
+            state.ResumeTiming();
+            BufferSlice slice = BufferSlice::Adopt(std::move(data));
+            DoNotOptimize(slice.Data());
+        }
+    });
+}
+
+} // namespace BaseNode
@@ -0,0 +1,194 @@
+#include "bench_harness.h"
+#include "3rdparty/nlohmann_json/json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+#ifndef BASENODE_BENCH_BUILD_TYPE
+#define BASENODE_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace BaseNode
+{
+
+BenchState::BenchState(uint64_t iterations)
+    : iterations_(iterations), started_(Clock::now())
+{
+}
+
+void BenchState::PauseTiming()
+{
+    if (running_) {
+        elapsed_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started_).count();
+        running_ = false;
+    }
+}
+
+void BenchState::ResumeTiming()
+{
+    if (!running_) {
+        started_ = Clock::now();
+        running_ = true;
+    }
+}
+
+int64_t BenchState::ElapsedNs() const
+{
+    if (running_) {
+        return elapsed_ns_ + std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started_).count();
+    }
+    return elapsed_ns_;
+}
+
+void BenchRunner::Add(const std::string& name, BenchFunc func)
+{
+    cases_.push_back(BenchCase{name, std::move(func)});
+}
+
+int BenchRunner::Run(const BenchOptions& options)
+{
+    results_.clear();
+    for (const BenchCase& bench_case : cases_) {
+        if (!options.filter.empty() && bench_case.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.list_only) {
+            printf("%s\n", bench_case.name.c_str());
+            continue;
+        }
+        BenchResult result = Measure_(bench_case.name, bench_case.func, options);
+        printf("%-44s %12.1f ns/op  %14.0f ops/s  (min %.1f, max %.1f, %lu iterations x %u)\n",
+               result.name.c_str(), result.ns_per_op, result.ops_per_sec, result.min_ns_per_op, result.max_ns_per_op,
+               result.iterations, result.repetitions);
+        fflush(stdout);
+        results_.push_back(std::move(result));
+    }
+    if (options.list_only) {
+        return 0;
+    }
+    if (!options.json_path.empty() && !WriteJson_(options)) {
+        return 2;
+    }
+    if (!options.baseline_path.empty()) {
+        return CompareBaseline_(options);
+    }
+    return 0;
+}
+
+BenchResult BenchRunner::Measure_(const std::string& name, const BenchFunc& func, const BenchOptions& options)
+{
+    const int64_t min_time_ns = static_cast<int64_t>(options.min_time_ms) * 1000000;
+
+    // 放大迭代数直到单次测量足够长，预热也在这个过程中完成
+    uint64_t iterations = 1;
+    uint64_t items_per_iteration = 1;
+    while (true) {
+        BenchState state(iterations);
+        func(state);
+        int64_t elapsed_ns = state.ElapsedNs();
+        items_per_iteration = state.GetItemsPerIteration();
+        if (elapsed_ns >= min_time_ns || iterations >= 1000000000ULL) {
+            break;
+        }
+        // 按本次耗时预测需要的迭代数，多留 40% 余量，每次最多放大 10 倍
+        double predicted = elapsed_ns > 0 ? static_cast<double>(iterations) * 1.4 * min_time_ns / elapsed_ns : iterations * 10.0;
+        uint64_t next = static_cast<uint64_t>(std::min(predicted, iterations * 10.0));
+        iterations = std::max(next, iterations + 1);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (uint32_t i = 0; i < std::max<uint32_t>(options.repetitions, 1); ++i) {
+        BenchState state(iterations);
+        func(state);
+        items_per_iteration = state.GetItemsPerIteration();
+        samples.push_back(static_cast<double>(state.ElapsedNs()) / static_cast<double>(iterations * items_per_iteration));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.repetitions = static_cast<uint32_t>(samples.size());
+    result.ns_per_op = samples[samples.size() / 2];
+    result.min_ns_per_op = samples.front();
+    result.max_ns_per_op = samples.back();
+    result.ops_per_sec = result.ns_per_op > 0 ? 1e9 / result.ns_per_op : 0;
+    return result;
+}
+
+bool BenchRunner::WriteJson_(const BenchOptions& options) const
+{
+    nlohmann::json json;
+    json["schema_version"] = BENCH_RESULT_SCHEMA_VERSION;
+    json["label"] = options.label;
+    json["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+    json["build_type"] = BASENODE_BENCH_BUILD_TYPE;
+    json["hardware_concurrency"] = std::thread::hardware_concurrency();
+    json["min_time_ms"] = options.min_time_ms;
+    nlohmann::json results = nlohmann::json::array();
+    for (const BenchResult& result : results_) {
+        results.push_back({
+            {"name", result.name},
+            {"iterations", result.iterations},
+            {"repetitions", result.repetitions},
+            {"ns_per_op", result.ns_per_op},
+            {"min_ns_per_op", result.min_ns_per_op},
+            {"max_ns_per_op", result.max_ns_per_op},
+            {"ops_per_sec", result.ops_per_sec},
+        });
+    }
+    json["results"] = std::move(results);
+
+    std::ofstream file(options.json_path);
+    if (!file) {
+        fprintf(stderr, "failed to open %s for writing\n", options.json_path.c_str());
+        return false;
+    }
+    file << json.dump(2) << "\n";
+    printf("results written to %s\n", options.json_path.c_str());
+    return true;
+}
+
+int BenchRunner::CompareBaseline_(const BenchOptions& options) const
+{
+    std::ifstream file(options.baseline_path);
+    if (!file) {
+        fprintf(stderr, "failed to open baseline %s\n", options.baseline_path.c_str());
+        return 2;
+    }
+    nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("results")) {
+        fprintf(stderr, "invalid baseline %s\n", options.baseline_path.c_str());
+        return 2;
+    }
+    std::unordered_map<std::string, double> baseline_ns;
+    for (const auto& item : baseline["results"]) {
+        baseline_ns[item.value("name", "")] = item.value("ns_per_op", 0.0);
+    }
+
+    printf("\ncompared with %s (%s):\n", options.baseline_path.c_str(), baseline.value("label", "").c_str());
+    int regressions = 0;
+    for (const BenchResult& result : results_) {
+        auto it = baseline_ns.find(result.name);
+        if (it == baseline_ns.end() || it->second <= 0) {
+            printf("%-44s %12.1f ns/op  (new)\n", result.name.c_str(), result.ns_per_op);
+            continue;
+        }
+        double delta_pct = (result.ns_per_op - it->second) * 100.0 / it->second;
+        bool regressed = options.max_regression_pct > 0 && delta_pct > options.max_regression_pct;
+        printf("%-44s %12.1f -> %12.1f ns/op  %+7.1f%%%s\n",
+               result.name.c_str(), it->second, result.ns_per_op, delta_pct, regressed ? "  REGRESSION" : "");
+        regressions += regressed ? 1 : 0;
+    }
+    if (regressions > 0) {
+        printf("%d benchmark(s) regressed by more than %.1f%%\n", regressions, options.max_regression_pct);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace BaseNode
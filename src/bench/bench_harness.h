@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace BaseNode
+{
+
+#define BENCH_DEFAULT_MIN_TIME_MS 200       // 每次测量至少运行的时间
+#define BENCH_DEFAULT_REPETITIONS 5         // 每个用例重复测量的次数（结果取中位数）
+#define BENCH_RESULT_SCHEMA_VERSION 1       // JSON 结果的格式版本，字段变化时递增
+
+/**
+ * @brief 阻止编译器把被测表达式优化掉
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief 阻止编译器重排或消除对内存的读写
+ */
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/**
+ * @brief 一次测量的状态：用例按 Iterations() 循环，准备工作放在 PauseTiming / ResumeTiming 之间不计时
+ */
+class BenchState
+{
+public:
+    explicit BenchState(uint64_t iterations);
+
+    uint64_t Iterations() const { return iterations_; }
+
+    void PauseTiming();
+    void ResumeTiming();
+
+    /**
+     * @brief 每次迭代处理的条目数（如一次迭代发出 64 个批量调用），结果按条目折算，默认 1
+     */
+    void SetItemsPerIteration(uint64_t items) { items_per_iteration_ = items; }
+    uint64_t GetItemsPerIteration() const { return items_per_iteration_; }
+
+    /**
+     * @brief 计时部分的耗时（纳秒）
+     */
+    int64_t ElapsedNs() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t iterations_;
+    uint64_t items_per_iteration_ = 1;
+    int64_t elapsed_ns_ = 0;
+    Clock::time_point started_;
+    bool running_ = true;
+};
+
+using BenchFunc = std::function<void(BenchState&)>;
+
+/**
+ * @brief 单个用例的结果
+ */
+struct BenchResult
+{
+    std::string name;
+    uint64_t iterations = 0;        // 每次测量的迭代数
+    uint32_t repetitions = 0;
+    double ns_per_op = 0;           // 各次测量的中位数（按条目折算）
+    double min_ns_per_op = 0;
+    double max_ns_per_op = 0;
+    double ops_per_sec = 0;
+};
+
+/**
+ * @brief 运行参数（命令行）
+ */
+struct BenchOptions
+{
+    std::string filter;                         // 只运行名称包含该子串的用例
+    std::string json_path;                      // 结果写入的 JSON 文件，空表示不写
+    std::string baseline_path;                  // 与之比较的基线 JSON 文件（之前某个提交的结果）
+    std::string label;                          // 写入结果的标签（如提交哈希）
+    double max_regression_pct = 0;              // 有用例比基线慢超过该百分比时返回非 0，0 表示只打印不判定
+    uint32_t min_time_ms = BENCH_DEFAULT_MIN_TIME_MS;
+    uint32_t repetitions = BENCH_DEFAULT_REPETITIONS;
+    bool list_only = false;
+};
+
+/**
+ * @brief 微基准运行器
+ *
+ * 每个用例先逐步放大迭代数直到单次测量超过 min_time_ms，然后按该迭代数重复测量 repetitions 次，取中位数。
+ * 结果以 JSON 输出（见 WriteJson），指定基线文件时逐项打印与基线的差异，用于比较两个提交之间的回归。
+ */
+class BenchRunner
+{
+public:
+    void Add(const std::string& name, BenchFunc func);
+
+    /**
+     * @brief 运行匹配的用例
+     * @return 进程退出码：有用例超过允许的回归幅度时返回 1
+     */
+    int Run(const BenchOptions& options);
+
+private:
+    BenchResult Measure_(const std::string& name, const BenchFunc& func, const BenchOptions& options);
+    bool WriteJson_(const BenchOptions& options) const;
+    int CompareBaseline_(const BenchOptions& options) const;
+
+private:
+    struct BenchCase
+    {
+        std::string name;
+        BenchFunc func;
+    };
+    std::vector<BenchCase> cases_;
+    std::vector<BenchResult> results_;
+};
+
+// 各组用例的注册函数
+void RegisterEventBenchmarks(BenchRunner& runner);
+void RegisterRpcBenchmarks(BenchRunner& runner);
+void RegisterRouterBenchmarks(BenchRunner& runner);
+void RegisterRouterIndexBenchmarks(BenchRunner& runner);
+void RegisterCallBenchmarks(BenchRunner& runner);
+void RegisterTimerBenchmarks(BenchRunner& runner);
+void RegisterPluginBenchmarks(BenchRunner& runner);
+
+} // namespace BaseNode
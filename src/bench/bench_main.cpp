@@ -0,0 +1,68 @@
+#include "bench_harness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// 核心消息路径的微基准
+// 用法: ./basenode_bench [--filter=mailbox] [--json=bench.json] [--baseline=old.json --max-regression=10]
+//                        [--label=<commit>] [--min-time-ms=200] [--repetitions=5] [--list]
+// 结果只有在 Release 构建下才有意义（cmake -DCMAKE_BUILD_TYPE=Release -DBASENODE_BUILD_BENCH=ON）
+
+static bool ParseOption(const char* arg, const char* name, std::string& value)
+{
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = arg + length + 1;
+    return true;
+}
+
+static void PrintUsage(const char* program)
+{
+    printf("usage: %s [--filter=<substring>] [--json=<path>] [--baseline=<path>] [--max-regression=<pct>]\n"
+           "          [--label=<text>] [--min-time-ms=<ms>] [--repetitions=<n>] [--list]\n", program);
+}
+
+int main(int argc, char* argv[])
+{
+    BaseNode::BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (strcmp(argv[i], "--list") == 0) {
+            options.list_only = true;
+        } else if (ParseOption(argv[i], "--filter", value)) {
+            options.filter = value;
+        } else if (ParseOption(argv[i], "--json", value)) {
+            options.json_path = value;
+        } else if (ParseOption(argv[i], "--baseline", value)) {
+            options.baseline_path = value;
+        } else if (ParseOption(argv[i], "--label", value)) {
+            options.label = value;
+        } else if (ParseOption(argv[i], "--max-regression", value)) {
+            options.max_regression_pct = atof(value.c_str());
+        } else if (ParseOption(argv[i], "--min-time-ms", value)) {
+            options.min_time_ms = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (ParseOption(argv[i], "--repetitions", value)) {
+            options.repetitions = static_cast<uint32_t>(atoi(value.c_str()));
+        } else {
+            PrintUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+
+#ifndef NDEBUG
+    fprintf(stderr, "warning: benchmarks built without optimization, configure with -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+
+    BaseNode::BenchRunner runner;
+    BaseNode::RegisterEventBenchmarks(runner);
+    BaseNode::RegisterRpcBenchmarks(runner);
+    BaseNode::RegisterRouterBenchmarks(runner);
+    BaseNode::RegisterRouterIndexBenchmarks(runner);
+    BaseNode::RegisterCallBenchmarks(runner);
+    BaseNode::RegisterTimerBenchmarks(runner);
+    BaseNode::RegisterPluginBenchmarks(runner);
+    return runner.Run(options);
+}
@@ -0,0 +1,25 @@
+#include "bench_modules.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace BaseNode
+{
+
+BenchModules& GetBenchModules()
+{
+    static BenchModules* modules = []() {
+        BenchModules* created = new BenchModules();
+        IModule* all[] = {&created->echo, &created->client, &created->probe};
+        for (IModule* module : all) {
+            ErrorCode err = module->Init();
+            if (err != ErrorCode::BN_SUCCESS) {
+                fprintf(stderr, "failed to init bench module %s, error: %d\n", module->GetModuleName().c_str(), static_cast<int>(err));
+                exit(2);
+            }
+        }
+        return created;
+    }();
+    return *modules;
+}
+
+} // namespace BaseNode
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "module_interface.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 基准用例使用的模块：在同一个线程上用 Update() 驱动，不经过执行线程和网络
+
+namespace BaseNode
+{
+
+/**
+ * @brief 被调用方：提供一个最小的 RPC 服务
+ */
+class BenchEcho : public ModuleBase<BenchEcho>
+{
+public:
+    uint64_t Echo(uint64_t value) { return value + 1; }
+
+protected:
+    virtual ErrorCode DoInit() override
+    {
+        RegisterService<&BenchEcho::Echo>(this);
+        return ErrorCode::BN_SUCCESS;
+    }
+    virtual ErrorCode DoUpdate() override { return ErrorCode::BN_SUCCESS; }
+    virtual ErrorCode DoUninit() override { return ErrorCode::BN_SUCCESS; }
+};
+
+/**
+ * @brief 调用方：发起调用，回包经路由回到本模块
+ */
+class BenchClient : public ModuleBase<BenchClient>
+{
+protected:
+    virtual ErrorCode DoInit() override { return ErrorCode::BN_SUCCESS; }
+    virtual ErrorCode DoUpdate() override { return ErrorCode::BN_SUCCESS; }
+    virtual ErrorCode DoUninit() override { return ErrorCode::BN_SUCCESS; }
+};
+
+/**
+ * @brief 抓包模块：发出的请求帧不路由，保存下来作为路由和解析用例的输入
+ */
+class BenchProbe : public ModuleBase<BenchProbe>
+{
+public:
+    /**
+     * @brief 生成 count 个发往 BenchEcho::Echo 的完整请求帧
+     */
+    std::vector<std::string> CaptureEchoFrames(size_t count)
+    {
+        std::vector<std::string> frames;
+        frames.reserve(count);
+        SetClientSendCallback([&frames](std::string&& frame) { frames.push_back(std::move(frame)); });
+        for (size_t i = 0; i < count; ++i) {
+            CallModuleService<&BenchEcho::Echo>(static_cast<uint64_t>(i)).then([](auto) {});
+        }
+        // 恢复为丢弃，调用方不会收到回包
+        SetClientSendCallback([](std::string&&) {});
+        return frames;
+    }
+
+protected:
+    virtual ErrorCode DoInit() override { return ErrorCode::BN_SUCCESS; }
+    virtual ErrorCode DoUpdate() override { return ErrorCode::BN_SUCCESS; }
+    virtual ErrorCode DoUninit() override { return ErrorCode::BN_SUCCESS; }
+};
+
+/**
+ * @brief 进程内的基准模块（第一次调用时初始化并注册到路由）
+ */
+struct BenchModules
+{
+    BenchEcho echo;
+    BenchClient client;
+    BenchProbe probe;
+};
+
+BenchModules& GetBenchModules();
+
+} // namespace BaseNode
@@ -0,0 +1,79 @@
+#include "bench_harness.h"
+#include "plugin_system/plugin_descriptor.h"
+#include "tools/safe_call.h"
+#include "utils/basenode_def_internal.h"
+#include <dlfcn.h>
+#include <string>
+
+// 主循环每次 tick 调用插件 update 的开销：旧方式（每次拼接上下文 + dlsym + SafeCall）
+// 与描述符方式（入口加载时解析一次，受保护 / trusted 直接调用）对比
+// update_cached_safecall 与 update_trusted 的差值即 SafeCall 的开销，只有链接真实的 toolbox 时才有意义
+
+// 被调用的空 update，导出后通过 dlsym 查找（basenode_bench 链接时使用 -rdynamic）
+extern "C" SO_EXPORT_SYMBOL void benchPluginUpdateSo()
+{
+    BaseNode::ClobberMemory();
+}
+
+namespace BaseNode
+{
+
+namespace
+{
+
+const std::string kBenchSoPath = "./lib/libbench_plugin.so";
+
+void OnSafeCallError(const std::string& ctx, const std::string& error_msg)
+{
+    BaseNodeLogError("[bench] SafeCall Error - Plugin: [%s], Error: %s", ctx.c_str(), error_msg.c_str());
+}
+
+} // namespace
+
+void RegisterPluginBenchmarks(BenchRunner& runner)
+{
+    // 改动前 PluginLoadManager::Update 对每个插件的处理
+    runner.Add("plugin/update_dlsym_safecall", [](BenchState& state) {
+        void* handle = dlopen(nullptr, RTLD_NOW);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            std::string symbol_name = "benchPluginUpdateSo";
+            std::string context = kBenchSoPath + " FUNC[" + symbol_name + "]";
+            void* func = dlsym(handle, symbol_name.c_str());
+            if (func) {
+                DoNotOptimize(ToolBox::SafeCallSimple(reinterpret_cast<PluginEntryFunc>(func), context, OnSafeCallError));
+            }
+        }
+        dlclose(handle);
+    });
+    // 旧方式每次 tick 的查找开销（拼接上下文 + dlsym，不调用），与 SafeCall 的实现无关，描述符方式省去的就是这一部分
+    runner.Add("plugin/update_dlsym_lookup", [](BenchState& state) {
+        void* handle = dlopen(nullptr, RTLD_NOW);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            std::string symbol_name = "benchPluginUpdateSo";
+            std::string context = kBenchSoPath + " FUNC[" + symbol_name + "]";
+            DoNotOptimize(context);
+            DoNotOptimize(dlsym(handle, symbol_name.c_str()));
+        }
+        dlclose(handle);
+    });
+    runner.Add("plugin/update_cached_safecall", [](BenchState& state) {
+        void* handle = dlopen(nullptr, RTLD_NOW);
+        auto func = reinterpret_cast<PluginEntryFunc>(dlsym(handle, "benchPluginUpdateSo"));
+        const std::string context = kBenchSoPath + " FUNC[update]";
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(ToolBox::SafeCallSimple(func, context, OnSafeCallError));
+        }
+        dlclose(handle);
+    });
+    runner.Add("plugin/update_trusted", [](BenchState& state) {
+        void* handle = dlopen(nullptr, RTLD_NOW);
+        auto func = reinterpret_cast<PluginEntryFunc>(dlsym(handle, "benchPluginUpdateSo"));
+        DoNotOptimize(func);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            func();
+        }
+        dlclose(handle);
+    });
+}
+
+} // namespace BaseNode
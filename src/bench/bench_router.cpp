@@ -0,0 +1,105 @@
+#include "bench_harness.h"
+#include "bench_modules.h"
+#include "module/module_buffer.h"
+#include "module/module_route_table.h"
+#include "module/module_router.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 路由查找和入队的微基准
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_ROUTE_TABLE_SIZE 64          // 查找用例的路由表条目数（一个进程内的服务数量级）
+#define BENCH_ROUTE_BURST 256              // 路由用例每次连续路由的数据包数，之后不计时地清空目标邮箱
+
+// 服务ID本身是散列值，这里用同样分布的随机键
+std::vector<uint32_t> MakeRouteKeys(size_t count)
+{
+    std::vector<uint32_t> keys;
+    uint32_t seed = 0x9E3779B9u;
+    while (keys.size() < count) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        if (seed != 0) {
+            keys.push_back(seed);
+        }
+    }
+    return keys;
+}
+
+std::unordered_map<uint32_t, IModule*> MakeRouteMap(const std::vector<uint32_t>& keys)
+{
+    // 查找只比较指针，不会解引用
+    std::unordered_map<uint32_t, IModule*> routes;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        routes[keys[i]] = reinterpret_cast<IModule*>(static_cast<uintptr_t>((i + 1) * 64));
+    }
+    return routes;
+}
+
+// 数据包入口：解析协议头、查找目标模块、入队（RouteRpcData_ 的完整路径）
+void BenchRouteProtocolPacket(BenchState& state)
+{
+    state.PauseTiming();
+    BenchModules& modules = GetBenchModules();
+    static const std::vector<std::string> frames = modules.probe.CaptureEchoFrames(BENCH_ROUTE_BURST);
+    std::vector<BufferSlice> packets;
+    packets.reserve(frames.size());
+    for (uint64_t i = 0; i < state.Iterations(); ++i) {
+        packets.clear();
+        for (const std::string& frame : frames) {
+            packets.push_back(BufferSlice::CopyFrom(frame.data(), frame.size()));
+        }
+        state.ResumeTiming();
+        for (BufferSlice& packet : packets) {
+            ModuleRouterMgr->RouteProtocolPacket(std::move(packet));
+        }
+        state.PauseTiming();
+        // BenchEcho 处理请求，回包路由回 BenchProbe（重复的请求序号会被调用方忽略）
+        modules.echo.Update();
+        modules.probe.Update();
+    }
+    state.SetItemsPerIteration(frames.size());
+}
+
+} // namespace
+
+void RegisterRouterBenchmarks(BenchRunner& runner)
+{
+    runner.Add("router/flat_table_find", [](BenchState& state) {
+        std::vector<uint32_t> keys = MakeRouteKeys(BENCH_ROUTE_TABLE_SIZE);
+        FlatRouteTable table;
+        table.Build(MakeRouteMap(keys));
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(table.Find(keys[i % BENCH_ROUTE_TABLE_SIZE]));
+        }
+    });
+    runner.Add("router/unordered_map_find", [](BenchState& state) {
+        std::vector<uint32_t> keys = MakeRouteKeys(BENCH_ROUTE_TABLE_SIZE);
+        std::unordered_map<uint32_t, IModule*> routes = MakeRouteMap(keys);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            auto it = routes.find(keys[i % BENCH_ROUTE_TABLE_SIZE]);
+            DoNotOptimize(it->second);
+        }
+    });
+    runner.Add("router/route_protocol_packet", BenchRouteProtocolPacket);
+
+    runner.Add("module/get_module_id", [](BenchState& state) {
+        // 通过基类引用读取，与路由和调用路径上的用法一致
+        IModule* module = &GetBenchModules().echo;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(module);
+            DoNotOptimize(module->GetModuleId());
+        }
+    });
+}
+
+} // namespace BaseNode
@@ -0,0 +1,144 @@
+#include "bench_harness.h"
+#include "router/router_instance_index.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// RouterModule 实例簿记的查找：旧方式（遍历全部实例比较 host:port / conn_id）与 RouterInstanceIndex 对比
+// 计时的循环只访问 RouterInstanceIndex 和标准容器，不调用网络库。*_scan 每次迭代是全表遍历，discovery_storm_scan
+// 每次迭代约 200ms，结果波动较大，用多次重复取中位数：./basenode_bench --filter=router_index --repetitions=5
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_ROUTER_INSTANCES 10000           // 实例总数
+#define BENCH_ROUTER_INSTANCES_PER_HOST 4      // 同一 host:port（同一进程）下的实例数，共用一条连接
+
+using InstanceMap = std::unordered_map<uint64_t, ServiceDiscovery::ServiceInstance>;
+
+std::vector<ServiceDiscovery::ServiceInstance> MakeInstances()
+{
+    std::vector<ServiceDiscovery::ServiceInstance> instances;
+    instances.reserve(BENCH_ROUTER_INSTANCES);
+    for (uint64_t i = 0; i < BENCH_ROUTER_INSTANCES; ++i) {
+        uint64_t process = i / BENCH_ROUTER_INSTANCES_PER_HOST;
+        ServiceDiscovery::ServiceInstance instance;
+        instance.service_name = "bench_service";
+        instance.module_name = "BenchModule" + std::to_string(i % BENCH_ROUTER_INSTANCES_PER_HOST);
+        instance.instance_id = 0x100000000ull + i * 7919;
+        instance.host = "10.0." + std::to_string(process / 250) + "." + std::to_string(process % 250);
+        instance.port = static_cast<uint16_t>(20000 + process % 16);
+        instance.connection_id = process + 1;
+        instances.push_back(std::move(instance));
+    }
+    return instances;
+}
+
+InstanceMap MakeInstanceMap(const std::vector<ServiceDiscovery::ServiceInstance>& instances)
+{
+    InstanceMap map;
+    for (const auto& instance : instances) {
+        map[instance.instance_id] = instance;
+    }
+    return map;
+}
+
+void MakeInstanceIndex(const std::vector<ServiceDiscovery::ServiceInstance>& instances, RouterInstanceIndex& index)
+{
+    for (const auto& instance : instances) {
+        index.Upsert(instance);
+    }
+}
+
+// 改动前 RouterModule::GetConnectionIDbyIPPort / GetInstanceIDsByConnectionID 的实现
+uint64_t ScanConnectionID(const InstanceMap& map, const std::string& ip, uint16_t port)
+{
+    for (const auto& [key, instance] : map) {
+        if (instance.host == ip && instance.port == port) {
+            return instance.connection_id;
+        }
+    }
+    return 0;
+}
+
+std::vector<uint64_t> ScanInstanceIDs(const InstanceMap& map, uint64_t connection_id)
+{
+    std::vector<uint64_t> instance_ids;
+    for (const auto& [key, instance] : map) {
+        if (instance.connection_id == connection_id) {
+            instance_ids.push_back(instance.instance_id);
+        }
+    }
+    return instance_ids;
+}
+
+} // namespace
+
+void RegisterRouterIndexBenchmarks(BenchRunner& runner)
+{
+    runner.Add("router_index/endpoint_lookup_scan", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        InstanceMap map = MakeInstanceMap(instances);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            const auto& instance = instances[(i * 7) % BENCH_ROUTER_INSTANCES];
+            DoNotOptimize(ScanConnectionID(map, instance.host, instance.port));
+        }
+    });
+    runner.Add("router_index/endpoint_lookup", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        RouterInstanceIndex index;
+        MakeInstanceIndex(instances, index);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            const auto& instance = instances[(i * 7) % BENCH_ROUTER_INSTANCES];
+            DoNotOptimize(index.GetConnectionID(instance.host, instance.port));
+        }
+    });
+    runner.Add("router_index/conn_instances_scan", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        InstanceMap map = MakeInstanceMap(instances);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(ScanInstanceIDs(map, instances[(i * 7) % BENCH_ROUTER_INSTANCES].connection_id));
+        }
+    });
+    runner.Add("router_index/conn_instances", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        RouterInstanceIndex index;
+        MakeInstanceIndex(instances, index);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(index.GetInstanceIDsByConnectionID(instances[(i * 7) % BENCH_ROUTER_INSTANCES].connection_id));
+        }
+    });
+
+    // 一次 watch 通知带来全部实例：每个实例查找同一地址的已有连接并更新（ConnectToInstance 的复用路径），按实例折算
+    runner.Add("router_index/discovery_storm_scan", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        InstanceMap map = MakeInstanceMap(instances);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            for (const auto& instance : instances) {
+                auto inst_copy = instance;
+                inst_copy.connection_id = ScanConnectionID(map, instance.host, instance.port);
+                map[instance.instance_id] = inst_copy;
+            }
+        }
+        state.SetItemsPerIteration(BENCH_ROUTER_INSTANCES);
+    });
+    runner.Add("router_index/discovery_storm", [](BenchState& state) {
+        std::vector<ServiceDiscovery::ServiceInstance> instances = MakeInstances();
+        RouterInstanceIndex index;
+        MakeInstanceIndex(instances, index);
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            for (const auto& instance : instances) {
+                auto inst_copy = instance;
+                inst_copy.connection_id = index.GetConnectionID(instance.host, instance.port);
+                index.Upsert(inst_copy);
+            }
+        }
+        state.SetItemsPerIteration(BENCH_ROUTER_INSTANCES);
+    });
+}
+
+} // namespace BaseNode
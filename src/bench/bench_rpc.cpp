@@ -0,0 +1,106 @@
+#include "bench_harness.h"
+#include "bench_modules.h"
+#include "coro_rpc/coro_rpc_server.h"
+#include "module/module_options.h"
+#include "module/module_rpc_batch.h"
+#include "module/module_rpc_deadline.h"
+#include "module/module_rpc_envelope.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// RPC 协议头、框架元数据和批量帧编解码的微基准
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_RPC_BATCH_CALLS 64           // 批量帧用例每帧合并的请求数（与 rpc_batch.max_calls 默认值一致）
+
+const std::string& EchoFrame()
+{
+    static const std::string frame = GetBenchModules().probe.CaptureEchoFrames(1).front();
+    return frame;
+}
+
+RpcMetadataFields MakeTracedFields()
+{
+    RpcMetadataFields fields;
+    fields.deadline_ms = RpcDeadlineClock::NowMs() + 5000;
+    fields.priority = static_cast<uint8_t>(RpcPriority::NORMAL);
+    fields.trace_id = 0x1122334455667788ULL;
+    fields.span_id = 0x99AABBCCDDEEFF00ULL;
+    fields.trace_send_us = 1700000000000000LL;
+    return fields;
+}
+
+} // namespace
+
+void RegisterRpcBenchmarks(BenchRunner& runner)
+{
+    runner.Add("rpc/read_header", [](BenchState& state) {
+        std::string_view frame = EchoFrame();
+        ToolBox::CoroRpc::CoroRpcProtocol::ReqHeader header;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(frame);
+            DoNotOptimize(ToolBox::CoroRpc::CoroRpcProtocol::ReadHeader(frame, header));
+            DoNotOptimize(header);
+        }
+    });
+    // 协议头 + 服务键 + 框架元数据，路由入口对每个数据包做一次
+    runner.Add("rpc/envelope_parse", [](BenchState& state) {
+        std::string_view frame = EchoFrame();
+        RpcEnvelope envelope;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(frame);
+            DoNotOptimize(RpcEnvelope::Parse(frame, envelope));
+            DoNotOptimize(envelope.service_id);
+        }
+    });
+    runner.Add("rpc/metadata_encode", [](BenchState& state) {
+        RpcMetadataFields fields = MakeTracedFields();
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            std::string attachment = RpcMetadata::Encode(fields, std::string_view());
+            DoNotOptimize(attachment.data());
+        }
+    });
+    runner.Add("rpc/metadata_decode", [](BenchState& state) {
+        std::string attachment = RpcMetadata::Encode(MakeTracedFields(), std::string_view());
+        RpcMetadataFields fields;
+        uint32_t metadata_length = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(RpcMetadata::Decode(attachment, fields, metadata_length));
+            DoNotOptimize(fields.trace_id);
+        }
+    });
+    runner.Add("rpc/batch_frame_append", [](BenchState& state) {
+        std::string_view frame = EchoFrame();
+        std::string batch;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            batch.clear();
+            for (uint32_t j = 0; j < BENCH_RPC_BATCH_CALLS; ++j) {
+                RpcBatchFrame::Append(batch, frame);
+            }
+            DoNotOptimize(batch.data());
+        }
+        state.SetItemsPerIteration(BENCH_RPC_BATCH_CALLS);
+    });
+    runner.Add("rpc/batch_frame_next", [](BenchState& state) {
+        std::string batch;
+        for (uint32_t j = 0; j < BENCH_RPC_BATCH_CALLS; ++j) {
+            RpcBatchFrame::Append(batch, EchoFrame());
+        }
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            size_t offset = 0;
+            std::string_view frame;
+            while (RpcBatchFrame::Next(batch, offset, frame)) {
+                DoNotOptimize(frame);
+            }
+        }
+        state.SetItemsPerIteration(BENCH_RPC_BATCH_CALLS);
+    });
+}
+
+} // namespace BaseNode
@@ -0,0 +1,91 @@
+#include "bench_harness.h"
+#include "module/module_reactor.h"
+#include "module/module_timer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+// 模块定时器的微基准，与按到期时间排序的二叉堆对比
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define BENCH_TIMER_BURST 1024             // 触发用例每次迭代添加的定时器数
+#define BENCH_TIMER_MAX_DELAY_MS 1000      // 定时器延迟范围（1 ~ 1000ms，跨越第 0 层和第 1 层）
+
+struct HeapTimer
+{
+    int64_t expire_ns = 0;
+    uint64_t id = 0;
+    std::function<void()> callback;
+
+    bool operator>(const HeapTimer& other) const { return expire_ns > other.expire_ns; }
+};
+
+using TimerHeap = std::priority_queue<HeapTimer, std::vector<HeapTimer>, std::greater<HeapTimer>>;
+
+uint32_t BenchDelayMs(uint64_t i)
+{
+    return static_cast<uint32_t>((i * 7919) % BENCH_TIMER_MAX_DELAY_MS) + 1;
+}
+
+} // namespace
+
+void RegisterTimerBenchmarks(BenchRunner& runner)
+{
+    // 添加后立即取消（请求超时定时器的常见情况：回包先于超时到达）
+    runner.Add("timer/wheel_add_cancel", [](BenchState& state) {
+        auto wheel = std::make_unique<ModuleTimerWheel>();
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            TimerId timer_id = wheel->AddTimer(BenchDelayMs(i), []() {});
+            DoNotOptimize(wheel->Cancel(timer_id));
+        }
+    });
+    // 二叉堆不支持按 ID 删除，这里按添加 + 弹出计算（惰性删除最终也要弹出）
+    runner.Add("timer/heap_add_pop", [](BenchState& state) {
+        TimerHeap heap;
+        int64_t now_ns = ModuleReactor::NowNs();
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            heap.push(HeapTimer{now_ns + static_cast<int64_t>(BenchDelayMs(i)) * 1000000, i, []() {}});
+            heap.pop();
+        }
+    });
+    // 添加一批定时器后一次推进到全部到期，结果按单个定时器折算
+    runner.Add("timer/wheel_fire", [](BenchState& state) {
+        auto wheel = std::make_unique<ModuleTimerWheel>();
+        uint64_t fired = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            for (uint32_t j = 0; j < BENCH_TIMER_BURST; ++j) {
+                wheel->AddTimer(BenchDelayMs(j), [&fired]() { ++fired; });
+            }
+            // 时间轮只向前推进，每批使用更晚的时间点
+            wheel->Advance(ModuleReactor::NowNs() + static_cast<int64_t>(i + 1) * (BENCH_TIMER_MAX_DELAY_MS + 1) * 1000000);
+        }
+        DoNotOptimize(fired);
+        state.SetItemsPerIteration(BENCH_TIMER_BURST);
+    });
+    runner.Add("timer/heap_fire", [](BenchState& state) {
+        TimerHeap heap;
+        uint64_t fired = 0;
+        for (uint64_t i = 0; i < state.Iterations(); ++i) {
+            int64_t now_ns = ModuleReactor::NowNs();
+            for (uint32_t j = 0; j < BENCH_TIMER_BURST; ++j) {
+                heap.push(HeapTimer{now_ns + static_cast<int64_t>(BenchDelayMs(j)) * 1000000, j, [&fired]() { ++fired; }});
+            }
+            int64_t target_ns = now_ns + static_cast<int64_t>(BENCH_TIMER_MAX_DELAY_MS + 1) * 1000000;
+            while (!heap.empty() && heap.top().expire_ns <= target_ns) {
+                heap.top().callback();
+                heap.pop();
+            }
+        }
+        DoNotOptimize(fired);
+        state.SetItemsPerIteration(BENCH_TIMER_BURST);
+    });
+}
+
+} // namespace BaseNode
@@ -1,12 +1,18 @@
 
-#include <thread>
-#include <chrono>
+#include <algorithm>
 #include <atomic>
 #include <csignal>
 #include <cstring>
 
 #include "plugin_system_proc.h"
 #include "config/config_manager.h"
+#include "module/module_reactor.h"
+#include "module/module_options.h"
+#include "module/module_buffer.h"
+#include "module/module_actor.h"
+#include "module/module_executor.h"
+#include "module/module_rpc_deadline.h"
+#include "module/module_rpc_trace.h"
 
 // 全局退出标志
 static std::atomic<bool> g_running(true);
@@ -21,6 +27,34 @@ void signalHandler(int signal)
 
 int processNode(const std::string& config_file);
 
+// 主循环配置，对应配置文件中的 {config_name}.loop
+struct MainLoopOptions
+{
+    int tick_rate_hz = 100;             // 正常负载下的 tick 频率
+    int idle_after_ms = 1000;           // 连续多久没有被事件唤醒后进入空闲模式
+    int idle_tick_interval_ms = 100;    // 空闲模式下的 tick 间隔
+    int report_interval_ms = 10000;     // tick 统计汇总日志的输出间隔
+};
+
+// tick 统计（汇总周期内）
+struct MainLoopStats
+{
+    uint64_t ticks = 0;
+    uint64_t wakeups = 0;
+    int64_t tick_time_sum_us = 0;
+    int64_t tick_time_max_us = 0;
+    int64_t wakeup_latency_sum_us = 0;
+    int64_t wakeup_latency_max_us = 0;
+};
+
+static void LoadModuleOptions();
+static void LoadTracingOptions();
+static void DumpTraces();
+static void StartModuleActors();
+static void StartModuleExecutor();
+static MainLoopOptions LoadMainLoopOptions();
+static void RunMainLoop(const MainLoopOptions& options);
+
 int main(int argc, char* argv[]) 
 {
     // 支持通过命令行参数指定配置文件
@@ -49,11 +83,218 @@ int processNode(const std::string& config_file)
         return -1;
     }
 
+    // 模块级配置需要在插件加载（模块 Init）之前载入
+    LoadModuleOptions();
+    LoadTracingOptions();
+
+    // 工作线程池在插件加载前启动，模块 Init 中即可使用
+    StartModuleExecutor();
     PluginLoadMgr->Init();
+    // 模块全部注册后，按配置把部分模块交给独立的执行线程驱动
+    StartModuleActors();
+    RunMainLoop(LoadMainLoopOptions());
+    // 先停止工作线程池（剩余任务执行完）和执行线程，模块交还主线程后再卸载插件
+    ModuleExecutorMgr->Stop();
+    ModuleActorMgr->Stop();
+    DumpTraces();
+    PluginLoadMgr->Uninit();
+    return 0;
+}
+
+static void LoadModuleOptions()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    ModuleOptionsMgr->Load(ConfigMgr->Get<nlohmann::json>(config_name, config_name + ".modules", nlohmann::json::object()));
+}
+
+static void LoadTracingOptions()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    BaseNode::RpcTraceOptions options;
+    options.sample_rate = ConfigMgr->Get<double>(config_name, config_name + ".tracing.sample_rate", options.sample_rate);
+    options.ring_capacity = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, config_name + ".tracing.ring_capacity", static_cast<int>(options.ring_capacity)));
+    RpcTracerMgr->Configure(options);
+    RpcTracerMgr->SetProcessName(ConfigMgr->Get<std::string>(config_name, config_name + ".process.process_id", config_name));
+}
+
+// 退出前把环形缓冲区中的 span 写入 {config_name}.tracing.dump_path（Chrome trace JSON），未配置时不写
+static void DumpTraces()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty() || RpcTracerMgr->GetRecorded() == 0) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    std::string dump_path = ConfigMgr->Get<std::string>(config_name, config_name + ".tracing.dump_path", "");
+    if (dump_path.empty()) {
+        return;
+    }
+    std::string json = RpcTracerMgr->ExportChromeJson();
+    FILE* file = fopen(dump_path.c_str(), "w");
+    if (!file) {
+        BaseNodeLogError("[MainLoop] DumpTraces: failed to open %s", dump_path.c_str());
+        return;
+    }
+    fwrite(json.data(), 1, json.size(), file);
+    fclose(file);
+    BaseNodeLogInfo("[MainLoop] DumpTraces: wrote %zu bytes to %s", json.size(), dump_path.c_str());
+}
+
+static void StartModuleActors()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    ModuleActorMgr->Start(ConfigMgr->Get<nlohmann::json>(config_name, config_name + ".execution", nlohmann::json::object()));
+}
+
+static void StartModuleExecutor()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    nlohmann::json executor_json = ConfigMgr->Get<nlohmann::json>(config_name, config_name + ".executor", nlohmann::json::object());
+    BaseNode::ModuleExecutorOptions options;
+    options.workers = executor_json.value("workers", options.workers);
+    options.cpus = executor_json.value("cpus", options.cpus);
+    ModuleExecutorMgr->Start(options);
+}
+
+static MainLoopOptions LoadMainLoopOptions()
+{
+    MainLoopOptions options;
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return options;
+    }
+    const std::string& config_name = loaded_configs[0];
+    options.tick_rate_hz = ConfigMgr->Get<int>(config_name, config_name + ".loop.tick_rate_hz", options.tick_rate_hz);
+    options.idle_after_ms = ConfigMgr->Get<int>(config_name, config_name + ".loop.idle_after_ms", options.idle_after_ms);
+    options.idle_tick_interval_ms = ConfigMgr->Get<int>(config_name, config_name + ".loop.idle_tick_interval_ms", options.idle_tick_interval_ms);
+    options.report_interval_ms = ConfigMgr->Get<int>(config_name, config_name + ".loop.report_interval_ms", options.report_interval_ms);
+    if (options.tick_rate_hz <= 0) {
+        options.tick_rate_hz = 100;
+    }
+    BaseNodeLogInfo("[MainLoop] tick_rate_hz: %d, idle_after_ms: %d, idle_tick_interval_ms: %d",
+                    options.tick_rate_hz, options.idle_after_ms, options.idle_tick_interval_ms);
+    return options;
+}
+
+// 事件驱动主循环：
+// 1. 按 tick_rate_hz 周期驱动所有插件 Update（模块的 DoUpdate、网络库轮询等依赖周期 tick）
+// 2. 两次 tick 之间阻塞在 ModuleReactor 上，PushModuleEvent 到达时立即唤醒执行下一次 tick
+// 3. 长时间没有事件时切换到 idle_tick_interval_ms 的低频 tick，空闲进程不占用 CPU
+static void RunMainLoop(const MainLoopOptions& options)
+{
+    using BaseNode::ModuleReactor;
+
+    const int64_t tick_interval_ns = 1000000000LL / options.tick_rate_hz;
+    const int64_t idle_tick_interval_ns = static_cast<int64_t>(options.idle_tick_interval_ms) * 1000000LL;
+    const int64_t idle_after_ns = static_cast<int64_t>(options.idle_after_ms) * 1000000LL;
+    const int64_t report_interval_ns = static_cast<int64_t>(options.report_interval_ms) * 1000000LL;
+
+    MainLoopStats stats;
+    uint64_t tick_seq = 0;
+    bool woken = false;
+    int64_t last_wakeup_ns = ModuleReactor::NowNs();
+    int64_t last_report_ns = last_wakeup_ns;
+    BaseNode::ModuleBufferStats last_buffer_stats = ModuleBufferPoolMgr->GetStats();
+
     while (g_running) {
+        int64_t tick_begin_ns = ModuleReactor::NowNs();
+        int64_t wakeup_latency_us = woken ? ModuleReactorMgr->TakeWakeupLatencyUs() : -1;
+
         PluginLoadMgr->Update();
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+        int64_t tick_end_ns = ModuleReactor::NowNs();
+        int64_t tick_time_us = (tick_end_ns - tick_begin_ns) / 1000;
+        if (woken) {
+            last_wakeup_ns = tick_end_ns;
+        }
+        bool idle = idle_after_ns > 0 && tick_end_ns - last_wakeup_ns >= idle_after_ns;
+        ++tick_seq;
+
+        BaseNodeLogTrace("[MainLoop] tick %lu: tick_time: %ldus, wakeup_latency: %ldus, woken: %d, idle: %d",
+                         tick_seq, tick_time_us, wakeup_latency_us, woken, idle);
+        stats.ticks++;
+        stats.tick_time_sum_us += tick_time_us;
+        stats.tick_time_max_us = std::max(stats.tick_time_max_us, tick_time_us);
+        if (wakeup_latency_us >= 0) {
+            stats.wakeups++;
+            stats.wakeup_latency_sum_us += wakeup_latency_us;
+            stats.wakeup_latency_max_us = std::max(stats.wakeup_latency_max_us, wakeup_latency_us);
+        }
+        if (report_interval_ns > 0 && tick_end_ns - last_report_ns >= report_interval_ns) {
+            BaseNodeLogInfo("[MainLoop] ticks: %lu, tick_time avg: %ldus max: %ldus, wakeups: %lu, wakeup_latency avg: %ldus max: %ldus",
+                            stats.ticks, stats.tick_time_sum_us / static_cast<int64_t>(stats.ticks), stats.tick_time_max_us,
+                            stats.wakeups, stats.wakeups ? stats.wakeup_latency_sum_us / static_cast<int64_t>(stats.wakeups) : 0,
+                            stats.wakeup_latency_max_us);
+            // 缓冲池自身的堆分配次数，折算为每百万个数据包的分配次数；接管的字符串（adopted）在池外分配，不计入其中
+            BaseNode::ModuleBufferStats buffer_stats = ModuleBufferPoolMgr->GetStats();
+            uint64_t packets = buffer_stats.slices - last_buffer_stats.slices;
+            uint64_t pool_heap_allocs = buffer_stats.pool_heap_allocs - last_buffer_stats.pool_heap_allocs;
+            if (packets > 0) {
+                BaseNodeLogInfo("[MainLoop] packet buffers: packets: %lu, pool_heap_allocs: %lu (%lu per 1M packets), adopted (allocated outside the pool): %lu, oversize: %lu, cached_bytes: %lu",
+                                packets, pool_heap_allocs, pool_heap_allocs * 1000000 / packets,
+                                buffer_stats.adopted - last_buffer_stats.adopted, buffer_stats.oversize - last_buffer_stats.oversize,
+                                buffer_stats.cached_bytes);
+            }
+            last_buffer_stats = buffer_stats;
+            if (ModuleExecutorMgr->IsRunning()) {
+                BaseNode::ModuleExecutorStats executor_stats = ModuleExecutorMgr->GetStats();
+                BaseNodeLogInfo("[MainLoop] executor: workers: %zu, submitted: %lu, executed: %lu, steals: %lu, depth: %u",
+                                executor_stats.workers.size(), executor_stats.submitted, executor_stats.executed,
+                                executor_stats.steals, executor_stats.depth);
+                for (size_t i = 0; i < executor_stats.workers.size(); ++i) {
+                    const BaseNode::ExecutorWorkerStats& worker = executor_stats.workers[i];
+                    BaseNodeLogDebug("[MainLoop] executor worker %zu: executed: %lu, steals: %lu/%lu, sleeps: %lu, depth: %u",
+                                     i, worker.executed, worker.steals, worker.steal_attempts, worker.sleeps, worker.depth);
+                }
+            }
+            // 因截止时间丢弃的请求（累计值），没有时不输出
+            uint64_t drops[static_cast<size_t>(BaseNode::RpcDropReason::COUNT)];
+            uint64_t drop_total = 0;
+            for (size_t i = 0; i < static_cast<size_t>(BaseNode::RpcDropReason::COUNT); ++i) {
+                drops[i] = RpcDropStatsMgr->Get(static_cast<BaseNode::RpcDropReason>(i));
+                drop_total += drops[i];
+            }
+            if (drop_total > 0) {
+                BaseNodeLogInfo("[MainLoop] rpc drops: deadline_at_router: %lu, deadline_at_forward: %lu, deadline_at_dispatch: %lu, handler_cancelled: %lu",
+                                drops[0], drops[1], drops[2], drops[3]);
+            }
+            stats = MainLoopStats{};
+            last_report_ns = tick_end_ns;
+        }
+
+        // 等待到下一个 tick，期间有事件到达则提前进入下一次 tick
+        int64_t next_tick_ns = tick_begin_ns + (idle ? idle_tick_interval_ns : tick_interval_ns);
+        // 模块定时器请求的唤醒时间早于下一个 tick 时提前醒来
+        int64_t timer_deadline_ns = ModuleReactorMgr->TakeWakeDeadlineNs();
+        if (timer_deadline_ns > 0 && timer_deadline_ns < next_tick_ns) {
+            next_tick_ns = timer_deadline_ns;
+        }
+        woken = false;
+        while (g_running) {
+            int64_t now_ns = ModuleReactor::NowNs();
+            if (now_ns >= next_tick_ns) {
+                break;
+            }
+            if (ModuleReactorMgr->Wait((next_tick_ns - now_ns) / 1000)) {
+                woken = true;
+                break;
+            }
+        }
     }
-    PluginLoadMgr->Uninit();
-    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "module_actor.h"
+#include "module_interface.h"
+#include "module_router.h"
+#include "tools/singleton.h"
+#include <algorithm>
+#include <unordered_map>
+#if defined(PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace BaseNode
+{
+
+ModuleActor::ModuleActor(const ModuleActorOptions& options)
+    : options_(options)
+{
+    if (options_.tick_rate_hz <= 0) {
+        options_.tick_rate_hz = DEFAULT_MODULE_ACTOR_TICK_RATE_HZ;
+    }
+}
+
+ModuleActor::~ModuleActor()
+{
+    Stop();
+}
+
+void ModuleActor::Attach(IModule* module)
+{
+    if (running_.load(std::memory_order_acquire)) {
+        BaseNodeLogError("[ModuleActor] %s: cannot attach module %s after start", options_.name.c_str(), module->GetModuleName().c_str());
+        return;
+    }
+    modules_.push_back(module);
+}
+
+ErrorCode ModuleActor::Start()
+{
+    if (modules_.empty()) {
+        BaseNodeLogWarn("[ModuleActor] %s: no module attached, skip", options_.name.c_str());
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+    // 先切换唤醒器再启动线程：此后主循环的 Update 直接返回，邮箱只由本线程消费
+    for (IModule* module : modules_) {
+        module->BindReactor_(&reactor_);
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&ModuleActor::Run_, this);
+    BaseNodeLogInfo("[ModuleActor] %s: started, modules: %zu, cpus: %zu, tick_rate_hz: %d",
+                    options_.name.c_str(), modules_.size(), options_.cpus.size(), options_.tick_rate_hz);
+    return ErrorCode::BN_SUCCESS;
+}
+
+void ModuleActor::Stop()
+{
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    reactor_.Notify();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // 交还主循环：之后到达的事件唤醒主循环
+    for (IModule* module : modules_) {
+        module->BindReactor_(nullptr);
+    }
+    BaseNodeLogInfo("[ModuleActor] %s: stopped", options_.name.c_str());
+}
+
+// 与主循环相同的节奏：按 tick_rate_hz 周期驱动组内模块，两次 tick 之间阻塞在本线程的唤醒器上，
+// 有事件到达时立即进入下一次 tick，长时间没有事件时降低 tick 频率
+void ModuleActor::Run_()
+{
+    ApplyThreadAttributes_();
+
+    const int64_t tick_interval_ns = 1000000000LL / options_.tick_rate_hz;
+    const int64_t idle_tick_interval_ns = static_cast<int64_t>(options_.idle_tick_interval_ms) * 1000000LL;
+    const int64_t idle_after_ns = static_cast<int64_t>(options_.idle_after_ms) * 1000000LL;
+    const int64_t report_interval_ns = static_cast<int64_t>(options_.report_interval_ms) * 1000000LL;
+
+    uint64_t ticks = 0;
+    uint64_t wakeups = 0;
+    int64_t tick_time_sum_us = 0;
+    int64_t tick_time_max_us = 0;
+    bool woken = false;
+    int64_t last_wakeup_ns = ModuleReactor::NowNs();
+    int64_t last_report_ns = last_wakeup_ns;
+
+    while (running_.load(std::memory_order_acquire)) {
+        int64_t tick_begin_ns = ModuleReactor::NowNs();
+        for (IModule* module : modules_) {
+            module->Tick_();
+        }
+        int64_t tick_end_ns = ModuleReactor::NowNs();
+        int64_t tick_time_us = (tick_end_ns - tick_begin_ns) / 1000;
+        if (woken) {
+            last_wakeup_ns = tick_end_ns;
+            ++wakeups;
+        }
+        bool idle = idle_after_ns > 0 && tick_end_ns - last_wakeup_ns >= idle_after_ns;
+
+        ++ticks;
+        tick_time_sum_us += tick_time_us;
+        tick_time_max_us = std::max(tick_time_max_us, tick_time_us);
+        if (report_interval_ns > 0 && tick_end_ns - last_report_ns >= report_interval_ns) {
+            BaseNodeLogInfo("[ModuleActor] %s: ticks: %lu, tick_time avg: %ldus max: %ldus, wakeups: %lu",
+                            options_.name.c_str(), ticks, tick_time_sum_us / static_cast<int64_t>(ticks), tick_time_max_us, wakeups);
+            ticks = 0;
+            wakeups = 0;
+            tick_time_sum_us = 0;
+            tick_time_max_us = 0;
+            last_report_ns = tick_end_ns;
+        }
+
+        int64_t next_tick_ns = tick_begin_ns + (idle ? idle_tick_interval_ns : tick_interval_ns);
+        // 模块定时器请求的唤醒时间早于下一个 tick 时提前醒来
+        int64_t timer_deadline_ns = reactor_.TakeWakeDeadlineNs();
+        if (timer_deadline_ns > 0 && timer_deadline_ns < next_tick_ns) {
+            next_tick_ns = timer_deadline_ns;
+        }
+        woken = false;
+        while (running_.load(std::memory_order_acquire)) {
+            int64_t now_ns = ModuleReactor::NowNs();
+            if (now_ns >= next_tick_ns) {
+                break;
+            }
+            if (reactor_.Wait((next_tick_ns - now_ns) / 1000)) {
+                woken = true;
+                break;
+            }
+        }
+    }
+}
+
+void ModuleActor::ApplyThreadAttributes_()
+{
+#if defined(PLATFORM_WINDOWS)
+    if (!options_.cpus.empty()) {
+        DWORD_PTR mask = 0;
+        for (int cpu : options_.cpus) {
+            if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+                mask |= static_cast<DWORD_PTR>(1) << cpu;
+            }
+        }
+        if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+            BaseNodeLogError("[ModuleActor] %s: set thread affinity failed", options_.name.c_str());
+        }
+    }
+#else
+    // 线程名最长 15 个字符
+    pthread_setname_np(pthread_self(), options_.name.substr(0, 15).c_str());
+    if (!options_.cpus.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : options_.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) {
+            BaseNodeLogError("[ModuleActor] %s: pthread_setaffinity_np failed, error: %d", options_.name.c_str(), ret);
+        }
+    }
+#endif
+}
+
+ErrorCode ModuleActorManager::Start(const nlohmann::json& execution_json)
+{
+    auto actors_it = execution_json.find("actors");
+    if (actors_it == execution_json.end() || !actors_it->is_array() || actors_it->empty()) {
+        BaseNodeLogInfo("[ModuleActorManager] no actor configured, all modules run on main loop");
+        return ErrorCode::BN_SUCCESS;
+    }
+
+    std::unordered_map<std::string, IModule*> modules_by_name;
+    for (IModule* module : ModuleRouterMgr->GetAllModules()) {
+        modules_by_name[module->GetModuleName()] = module;
+    }
+
+    std::unordered_map<std::string, std::string> assigned;   // 模块名 -> 执行组名
+    for (const nlohmann::json& actor_json : *actors_it) {
+        if (!actor_json.is_object()) {
+            continue;
+        }
+        ModuleActorOptions options = ParseActorOptions_(actor_json);
+        if (options.name.empty()) {
+            options.name = "actor-" + std::to_string(actors_.size());
+        }
+        auto actor = std::make_unique<ModuleActor>(options);
+        for (const std::string& module_name : options.modules) {
+            auto module_it = modules_by_name.find(module_name);
+            if (module_it == modules_by_name.end()) {
+                BaseNodeLogWarn("[ModuleActorManager] %s: module %s not loaded, skip", options.name.c_str(), module_name.c_str());
+                continue;
+            }
+            auto [assigned_it, inserted] = assigned.emplace(module_name, options.name);
+            if (!inserted) {
+                BaseNodeLogError("[ModuleActorManager] %s: module %s already runs on %s, skip",
+                                 options.name.c_str(), module_name.c_str(), assigned_it->second.c_str());
+                continue;
+            }
+            actor->Attach(module_it->second);
+        }
+        if (actor->GetModuleCount() == 0 || actor->Start() != ErrorCode::BN_SUCCESS) {
+            continue;
+        }
+        actors_.push_back(std::move(actor));
+    }
+    BaseNodeLogInfo("[ModuleActorManager] started %zu actors, %zu modules moved off main loop", actors_.size(), assigned.size());
+    return ErrorCode::BN_SUCCESS;
+}
+
+void ModuleActorManager::Stop()
+{
+    for (auto& actor : actors_) {
+        actor->Stop();
+    }
+    actors_.clear();
+}
+
+ModuleActorOptions ModuleActorManager::ParseActorOptions_(const nlohmann::json& json)
+{
+    ModuleActorOptions options;
+    options.name = json.value("name", options.name);
+    options.tick_rate_hz = json.value("tick_rate_hz", options.tick_rate_hz);
+    options.idle_after_ms = json.value("idle_after_ms", options.idle_after_ms);
+    options.idle_tick_interval_ms = json.value("idle_tick_interval_ms", options.idle_tick_interval_ms);
+    options.report_interval_ms = json.value("report_interval_ms", options.report_interval_ms);
+    auto modules_it = json.find("modules");
+    if (modules_it != json.end() && modules_it->is_array()) {
+        for (const nlohmann::json& module : *modules_it) {
+            if (module.is_string()) {
+                options.modules.push_back(module.get<std::string>());
+            }
+        }
+    }
+    auto cpus_it = json.find("cpus");
+    if (cpus_it != json.end() && cpus_it->is_array()) {
+        for (const nlohmann::json& cpu : *cpus_it) {
+            if (cpu.is_number_integer()) {
+                options.cpus.push_back(cpu.get<int>());
+            }
+        }
+    }
+    return options;
+}
+
+} // namespace BaseNode
+
+static BaseNode::ModuleActorManager* g_module_actor_manager_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::ModuleActorManager* GetModuleActorManagerInstance() {
+    if (!g_module_actor_manager_instance) {
+        g_module_actor_manager_instance = ToolBox::Singleton<BaseNode::ModuleActorManager>::Instance();
+    }
+    return g_module_actor_manager_instance;
+}
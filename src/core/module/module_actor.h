@@ -0,0 +1,122 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include "module_reactor.h"
+#include "3rdparty/nlohmann_json/json.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BaseNode
+{
+class IModule;
+}
+
+namespace BaseNode
+{
+
+#define DEFAULT_MODULE_ACTOR_TICK_RATE_HZ 100
+
+/**
+ * @brief 模块执行组（actor 线程）配置
+ */
+struct ModuleActorOptions
+{
+    std::string name;                   // 执行组名，同时作为线程名
+    std::vector<std::string> modules;   // 由该线程驱动的模块名（见 IModule::GetModuleName）
+    std::vector<int> cpus;              // 绑定的 CPU 列表，为空表示不绑核
+    int tick_rate_hz = DEFAULT_MODULE_ACTOR_TICK_RATE_HZ;   // 正常负载下的 tick 频率
+    int idle_after_ms = 1000;           // 连续多久没有被事件唤醒后进入空闲模式
+    int idle_tick_interval_ms = 100;    // 空闲模式下的 tick 间隔
+    int report_interval_ms = 10000;     // tick 统计汇总日志的输出间隔
+};
+
+/**
+ * @brief 模块执行线程
+ *
+ * 驱动一组模块的 Update：每个 actor 有自己的 ModuleReactor，组内模块的 PushModuleEvent 只唤醒这个线程，
+ * 两次 tick 之间阻塞等待，行为与主循环一致。模块间调用仍然经过 ModuleRouter 投递到对方邮箱，不共享任何状态。
+ */
+class ModuleActor
+{
+public:
+    explicit ModuleActor(const ModuleActorOptions& options);
+    ~ModuleActor();
+
+    ModuleActor(const ModuleActor&) = delete;
+    ModuleActor& operator=(const ModuleActor&) = delete;
+
+    /**
+     * @brief 把模块交给本线程驱动（需在 Start 之前调用）
+     */
+    void Attach(IModule* module);
+
+    /**
+     * @brief 启动线程
+     */
+    ErrorCode Start();
+
+    /**
+     * @brief 停止线程并把模块交还给主循环
+     */
+    void Stop();
+
+    const std::string& GetName() const { return options_.name; }
+    size_t GetModuleCount() const { return modules_.size(); }
+
+private:
+    void Run_();
+    void ApplyThreadAttributes_();
+
+private:
+    ModuleActorOptions options_;
+    std::vector<IModule*> modules_;
+    ModuleReactor reactor_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+/**
+ * @brief 模块执行组管理器
+ *
+ * 由主程序在所有插件加载完成后按配置文件的 {config_name}.execution 节点创建执行线程，退出时在插件卸载前停止。
+ * 配置格式：
+ * "execution": {
+ *     "actors": [
+ *         { "name": "guild", "modules": ["Guild"], "cpus": [2], "tick_rate_hz": 100 },
+ *         { "name": "logic", "modules": ["Player", "Router"] }
+ *     ]
+ * }
+ * 未出现在任何执行组中的模块仍由主循环驱动；同一个模块只能属于一个执行组。
+ */
+class ModuleActorManager
+{
+public:
+    /**
+     * @brief 按配置创建并启动执行线程
+     * @param execution_json {config_name}.execution 节点
+     * @return 错误码
+     */
+    ErrorCode Start(const nlohmann::json& execution_json);
+
+    /**
+     * @brief 停止所有执行线程（模块交还主循环，之后可以在主线程上安全 UnInit）
+     */
+    void Stop();
+
+private:
+    static ModuleActorOptions ParseActorOptions_(const nlohmann::json& json);
+
+private:
+    std::vector<std::unique_ptr<ModuleActor>> actors_;
+};
+
+} // namespace BaseNode
+
+// 获取执行组管理器实例的全局函数（在 basenode_core 中实现）
+extern "C" BaseNode::ModuleActorManager* GetModuleActorManagerInstance();
+
+#define ModuleActorMgr GetModuleActorManagerInstance()
@@ -0,0 +1,246 @@
+#include "module_buffer.h"
+#include "tools/singleton.h"
+#include <cstring>
+#include <new>
+
+namespace BaseNode
+{
+
+BufferSlice::BufferSlice(const BufferSlice& other)
+    : buffer_(other.buffer_), offset_(other.offset_), length_(other.length_)
+{
+    if (buffer_) {
+        buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+BufferSlice::BufferSlice(BufferSlice&& other) noexcept
+    : buffer_(other.buffer_), offset_(other.offset_), length_(other.length_)
+{
+    other.buffer_ = nullptr;
+    other.offset_ = 0;
+    other.length_ = 0;
+}
+
+BufferSlice& BufferSlice::operator=(const BufferSlice& other)
+{
+    if (this != &other) {
+        if (other.buffer_) {
+            other.buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        Reset();
+        buffer_ = other.buffer_;
+        offset_ = other.offset_;
+        length_ = other.length_;
+    }
+    return *this;
+}
+
+BufferSlice& BufferSlice::operator=(BufferSlice&& other) noexcept
+{
+    if (this != &other) {
+        Reset();
+        buffer_ = other.buffer_;
+        offset_ = other.offset_;
+        length_ = other.length_;
+        other.buffer_ = nullptr;
+        other.offset_ = 0;
+        other.length_ = 0;
+    }
+    return *this;
+}
+
+BufferSlice BufferSlice::Adopt(std::string&& data)
+{
+    return ModuleBufferPoolMgr->Adopt(std::move(data));
+}
+
+BufferSlice BufferSlice::CopyFrom(const char* data, size_t size)
+{
+    BufferSlice slice = ModuleBufferPoolMgr->Allocate(size);
+    if (size > 0) {
+        std::memcpy(slice.MutableData(), data, size);
+    }
+    return slice;
+}
+
+bool BufferSlice::Resize(size_t length)
+{
+    if (!buffer_ || offset_ + length > buffer_->capacity) {
+        return false;
+    }
+    length_ = length;
+    return true;
+}
+
+BufferSlice BufferSlice::Slice(size_t offset, size_t length) const
+{
+    if (!buffer_ || offset + length > length_) {
+        return BufferSlice();
+    }
+    buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+    return BufferSlice(buffer_, offset_ + offset, length);
+}
+
+void BufferSlice::Reset()
+{
+    if (buffer_) {
+        if (buffer_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ModuleBufferPoolMgr->Release(buffer_);
+        }
+        buffer_ = nullptr;
+    }
+    offset_ = 0;
+    length_ = 0;
+}
+
+ModuleBufferPool::~ModuleBufferPool()
+{
+    for (FreeList& list : free_lists_) {
+        for (ModuleBuffer* buffer : list.buffers) {
+            DeleteBuffer_(buffer);
+        }
+        list.buffers.clear();
+    }
+    for (ModuleBuffer* buffer : adopted_free_list_.buffers) {
+        delete buffer;
+    }
+    adopted_free_list_.buffers.clear();
+}
+
+BufferSlice ModuleBufferPool::Allocate(size_t size)
+{
+    slices_.fetch_add(1, std::memory_order_relaxed);
+    int32_t size_class = SizeClassOf_(size);
+    ModuleBuffer* buffer = nullptr;
+    if (size_class == ModuleBuffer::kOversizeClass) {
+        oversize_.fetch_add(1, std::memory_order_relaxed);
+        pool_heap_allocs_.fetch_add(1, std::memory_order_relaxed);
+        buffer = NewBuffer_(size_class, size);
+    } else {
+        buffer = Pop_(free_lists_[size_class]);
+        if (buffer) {
+            pool_hits_.fetch_add(1, std::memory_order_relaxed);
+            cached_bytes_.fetch_sub(buffer->capacity, std::memory_order_relaxed);
+        } else {
+            pool_heap_allocs_.fetch_add(1, std::memory_order_relaxed);
+            buffer = NewBuffer_(size_class, ClassCapacity_(size_class));
+        }
+    }
+    buffer->refs.store(1, std::memory_order_relaxed);
+    return BufferSlice(buffer, 0, size);
+}
+
+BufferSlice ModuleBufferPool::Adopt(std::string&& data)
+{
+    slices_.fetch_add(1, std::memory_order_relaxed);
+    adopted_.fetch_add(1, std::memory_order_relaxed);
+    ModuleBuffer* buffer = Pop_(adopted_free_list_);
+    if (buffer) {
+        pool_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        pool_heap_allocs_.fetch_add(1, std::memory_order_relaxed);
+        buffer = new ModuleBuffer();
+        buffer->size_class = ModuleBuffer::kAdoptedClass;
+    }
+    buffer->adopted = std::move(data);
+    buffer->data = buffer->adopted.data();
+    buffer->capacity = buffer->adopted.size();
+    buffer->refs.store(1, std::memory_order_relaxed);
+    return BufferSlice(buffer, 0, buffer->capacity);
+}
+
+void ModuleBufferPool::Release(ModuleBuffer* buffer)
+{
+    if (buffer->size_class == ModuleBuffer::kAdoptedClass) {
+        // 释放字符串数据，控制块留作下次复用
+        std::string().swap(buffer->adopted);
+        buffer->data = nullptr;
+        buffer->capacity = 0;
+        if (!Push_(adopted_free_list_, buffer, MODULE_BUFFER_POOL_CACHE_BYTES / sizeof(ModuleBuffer))) {
+            delete buffer;
+        }
+        return;
+    }
+    if (buffer->size_class == ModuleBuffer::kOversizeClass) {
+        DeleteBuffer_(buffer);
+        return;
+    }
+    size_t capacity = buffer->capacity;
+    if (Push_(free_lists_[buffer->size_class], buffer, MODULE_BUFFER_POOL_CACHE_BYTES / capacity)) {
+        cached_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+    } else {
+        DeleteBuffer_(buffer);
+    }
+}
+
+ModuleBufferStats ModuleBufferPool::GetStats() const
+{
+    ModuleBufferStats stats;
+    stats.slices = slices_.load(std::memory_order_relaxed);
+    stats.pool_hits = pool_hits_.load(std::memory_order_relaxed);
+    stats.pool_heap_allocs = pool_heap_allocs_.load(std::memory_order_relaxed);
+    stats.adopted = adopted_.load(std::memory_order_relaxed);
+    stats.oversize = oversize_.load(std::memory_order_relaxed);
+    stats.cached_bytes = cached_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int32_t ModuleBufferPool::SizeClassOf_(size_t size)
+{
+    for (int32_t size_class = 0; size_class < MODULE_BUFFER_SIZE_CLASS_NUM; ++size_class) {
+        if (size <= ClassCapacity_(size_class)) {
+            return size_class;
+        }
+    }
+    return ModuleBuffer::kOversizeClass;
+}
+
+// 控制块和数据区一次分配，数据区紧跟在控制块之后
+ModuleBuffer* ModuleBufferPool::NewBuffer_(int32_t size_class, size_t capacity)
+{
+    void* memory = ::operator new(sizeof(ModuleBuffer) + capacity);
+    ModuleBuffer* buffer = new (memory) ModuleBuffer();
+    buffer->size_class = size_class;
+    buffer->capacity = capacity;
+    buffer->data = reinterpret_cast<char*>(buffer + 1);
+    return buffer;
+}
+
+void ModuleBufferPool::DeleteBuffer_(ModuleBuffer* buffer)
+{
+    buffer->~ModuleBuffer();
+    ::operator delete(buffer);
+}
+
+ModuleBuffer* ModuleBufferPool::Pop_(FreeList& list)
+{
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (list.buffers.empty()) {
+        return nullptr;
+    }
+    ModuleBuffer* buffer = list.buffers.back();
+    list.buffers.pop_back();
+    return buffer;
+}
+
+bool ModuleBufferPool::Push_(FreeList& list, ModuleBuffer* buffer, size_t max_cached)
+{
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (list.buffers.size() >= max_cached) {
+        return false;
+    }
+    list.buffers.push_back(buffer);
+    return true;
+}
+
+} // namespace BaseNode
+
+static BaseNode::ModuleBufferPool* g_module_buffer_pool_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::ModuleBufferPool* GetModuleBufferPoolInstance() {
+    if (!g_module_buffer_pool_instance) {
+        g_module_buffer_pool_instance = ToolBox::Singleton<BaseNode::ModuleBufferPool>::Instance();
+    }
+    return g_module_buffer_pool_instance;
+}
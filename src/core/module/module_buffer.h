@@ -0,0 +1,176 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BaseNode
+{
+
+#define MODULE_BUFFER_SIZE_CLASS_NUM 5             // 尺寸档位数：256B、1KB、4KB、16KB、64KB
+#define MODULE_BUFFER_MIN_SIZE_SHIFT 8             // 最小档位 256B
+#define MODULE_BUFFER_POOL_CACHE_BYTES (4 * 1024 * 1024)   // 每个档位最多缓存的字节数
+
+/**
+ * @brief 缓冲区控制块（头部之后紧跟数据区；接管的 std::string 则指向字符串自身的数据）
+ */
+struct ModuleBuffer
+{
+    std::atomic<uint32_t> refs{1};
+    int32_t size_class = 0;     // 尺寸档位下标，kOversizeClass 为超大块，kAdoptedClass 为接管的字符串
+    size_t capacity = 0;
+    char* data = nullptr;
+    std::string adopted;        // 仅 kAdoptedClass 使用
+
+    static constexpr int32_t kOversizeClass = -1;
+    static constexpr int32_t kAdoptedClass = -2;
+};
+
+/**
+ * @brief 引用计数的缓冲区切片
+ *
+ * ModuleEvent 携带的 RPC 数据包。拷贝只增加引用计数，不拷贝数据；最后一个引用释放时缓冲区归还到缓冲池。
+ * 数据可以来自缓冲池（网络层直接填充），也可以接管一个已有的 std::string（RPC 库产出的数据包）。
+ */
+class BufferSlice
+{
+public:
+    BufferSlice() = default;
+    ~BufferSlice() { Reset(); }
+
+    BufferSlice(const BufferSlice& other);
+    BufferSlice(BufferSlice&& other) noexcept;
+    BufferSlice& operator=(const BufferSlice& other);
+    BufferSlice& operator=(BufferSlice&& other) noexcept;
+
+    /**
+     * @brief 接管 std::string 的数据（不拷贝）
+     */
+    static BufferSlice Adopt(std::string&& data);
+
+    /**
+     * @brief 从缓冲池拷贝一份数据（仅用于数据来源只能提供指针的场景）
+     */
+    static BufferSlice CopyFrom(const char* data, size_t size);
+
+    std::string_view View() const { return buffer_ ? std::string_view(buffer_->data + offset_, length_) : std::string_view(); }
+    const char* Data() const { return buffer_ ? buffer_->data + offset_ : nullptr; }
+    size_t Size() const { return length_; }
+    bool Empty() const { return length_ == 0; }
+
+    /**
+     * @brief 可写数据区（填充数据用，切片被共享后不应再写）
+     */
+    char* MutableData() { return buffer_ ? buffer_->data + offset_ : nullptr; }
+
+    /**
+     * @brief 调整切片长度（不能超过缓冲区容量）
+     */
+    bool Resize(size_t length);
+
+    /**
+     * @brief 取子切片，与原切片共享同一个缓冲区
+     */
+    BufferSlice Slice(size_t offset, size_t length) const;
+
+    void Reset();
+
+private:
+    friend class ModuleBufferPool;
+    BufferSlice(ModuleBuffer* buffer, size_t offset, size_t length)
+        : buffer_(buffer), offset_(offset), length_(length) {}
+
+private:
+    ModuleBuffer* buffer_ = nullptr;
+    size_t offset_ = 0;
+    size_t length_ = 0;
+};
+
+/**
+ * @brief 缓冲池统计
+ *
+ * 只统计缓冲池自身的分配。数据包路径上的其他堆分配不在其中，主要是被接管的 std::string：
+ * 它的数据由 RPC 库序列化时分配，缓冲池只接管，每次接管至少对应一次池外分配（见 adopted）。
+ */
+struct ModuleBufferStats
+{
+    uint64_t slices = 0;            // 累计产出的切片数（Allocate + Adopt），约等于数据包数
+    uint64_t pool_hits = 0;         // 从缓存中取到缓冲区的次数
+    uint64_t pool_heap_allocs = 0;  // 缓冲池自身向堆申请内存的次数（缓存未命中、超大块、接管字符串的控制块）
+    uint64_t adopted = 0;           // 接管 std::string 的次数（其数据在池外分配，不计入 pool_heap_allocs）
+    uint64_t oversize = 0;          // 超过最大档位的申请次数
+    uint64_t cached_bytes = 0;      // 当前缓存中的字节数
+};
+
+/**
+ * @brief 按尺寸分档的缓冲池
+ *
+ * 每个档位维护一个空闲链表，缓冲区释放时归还到对应档位，每个档位最多缓存 MODULE_BUFFER_POOL_CACHE_BYTES；
+ * 超过最大档位的申请直接走堆。网络收包线程分配、模块消费线程释放，空闲链表用互斥锁保护，临界区只有一次 push/pop。
+ */
+class ModuleBufferPool
+{
+public:
+    ModuleBufferPool() = default;
+    ~ModuleBufferPool();
+
+    ModuleBufferPool(const ModuleBufferPool&) = delete;
+    ModuleBufferPool& operator=(const ModuleBufferPool&) = delete;
+
+    /**
+     * @brief 申请一个长度为 size 的切片（数据未初始化）
+     */
+    BufferSlice Allocate(size_t size);
+
+    /**
+     * @brief 接管 std::string 的数据
+     */
+    BufferSlice Adopt(std::string&& data);
+
+    /**
+     * @brief 归还缓冲区（引用计数归零时由 BufferSlice 调用）
+     */
+    void Release(ModuleBuffer* buffer);
+
+    ModuleBufferStats GetStats() const;
+
+private:
+    struct FreeList
+    {
+        std::mutex mutex;
+        std::vector<ModuleBuffer*> buffers;
+    };
+
+    static int32_t SizeClassOf_(size_t size);
+    static size_t ClassCapacity_(int32_t size_class) { return static_cast<size_t>(1) << (MODULE_BUFFER_MIN_SIZE_SHIFT + 2 * size_class); }
+    static ModuleBuffer* NewBuffer_(int32_t size_class, size_t capacity);
+    static void DeleteBuffer_(ModuleBuffer* buffer);
+
+    ModuleBuffer* Pop_(FreeList& list);
+    bool Push_(FreeList& list, ModuleBuffer* buffer, size_t max_cached);
+
+private:
+    std::array<FreeList, MODULE_BUFFER_SIZE_CLASS_NUM> free_lists_;
+    FreeList adopted_free_list_;      // 接管字符串用的控制块
+
+    std::atomic<uint64_t> slices_{0};
+    std::atomic<uint64_t> pool_hits_{0};
+    std::atomic<uint64_t> pool_heap_allocs_{0};
+    std::atomic<uint64_t> adopted_{0};
+    std::atomic<uint64_t> oversize_{0};
+    std::atomic<uint64_t> cached_bytes_{0};
+};
+
+} // namespace BaseNode
+
+// 获取缓冲池实例的全局函数（在 basenode_core 中实现）
+// 使用 extern "C" 确保所有模块共享同一个缓冲池
+extern "C" BaseNode::ModuleBufferPool* GetModuleBufferPoolInstance();
+
+#define ModuleBufferPoolMgr GetModuleBufferPoolInstance()
@@ -1,122 +1,77 @@
 #pragma once
-#include "tools/ringbuffer.h"
 #include "coro_rpc/coro_rpc_server.h"
+#include "module_buffer.h"
+#include "module_rpc_envelope.h"
+#include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace BaseNode
 {
+class IModule;
 
-#define DEFAULT_MODULE_RING_BUFF_SIZE 256 * 1024
+/**
+ * @brief 投递到模块线程执行的任务（进程内直接调用用，只能移动）
+ */
+class ModuleTask
+{
+public:
+    virtual ~ModuleTask() = default;
+    /**
+     * @brief 在目标模块的消费线程上执行
+     * @param module 目标模块
+     */
+    virtual void Run(IModule& module) = 0;
+};
+
+template <typename Func>
+class ModuleTaskImpl final : public ModuleTask
+{
+public:
+    explicit ModuleTaskImpl(Func&& func) : func_(std::move(func)) {}
+    void Run(IModule& module) override { func_(module); }
+
+private:
+    Func func_;
+};
 
+template <typename Func>
+std::unique_ptr<ModuleTask> MakeModuleTask(Func&& func)
+{
+    return std::make_unique<ModuleTaskImpl<std::decay_t<Func>>>(std::forward<Func>(func));
+}
+
+/**
+ * @brief 投递到模块邮箱的事件
+ *
+ * 事件按值存放在邮箱的槽位中（见 ModuleMailbox::Cell），大小直接决定邮箱每个槽位的内存和入队/出队拷贝的字节数。
+ * 协议头（RpcEnvelope，64 字节）仍然内嵌：它在入口只解析一次，目标模块分发时需要其中的大部分字段；
+ * 放到缓冲区头部不可行（批量帧的各个子请求共享同一个缓冲区），单独分配又会给每个请求多一次堆分配。
+ * 目前整个事件 112 字节（切片 24 + 协议头 64 + 任务 8 + 入队时间 8 + 类型 1，补齐到 8 字节），新增字段前先看能否放进已有的空隙。
+ */
 struct ModuleEvent
 {
-    enum class EventType
+    enum class EventType : uint8_t
     {
         ET_NONE,
         ET_RPC_REQUEST,
         ET_RPC_RESPONSE,
+        ET_LOCAL_CALL,      // 进程内直接调用：不序列化，task_ 在目标模块线程上执行
+        ET_RPC_BATCH_REQUEST, // 批量请求：payload_ 为 RpcBatchFrame，envelope_ 只有 service_id / client_id / deadline_ms 有效
     };
-    EventType type_;
-    union EventData
-    {
-        struct RpcRequest
-        {
-            std::string rpc_req_data_;
-            RpcRequest() = default;
-            RpcRequest(const RpcRequest&) = default;
-            RpcRequest(RpcRequest&&) noexcept = default;
-            RpcRequest& operator=(const RpcRequest&) = default;
-            RpcRequest& operator=(RpcRequest&&) noexcept = default;
-            ~RpcRequest() = default;
-        } rpc_request_;
-
-        struct RpcResponse
-        {
-            std::string rpc_rsp_data_;
-            RpcResponse() = default;
-            RpcResponse(const RpcResponse&) = default;
-            RpcResponse(RpcResponse&&) noexcept = default;
-            RpcResponse& operator=(const RpcResponse&) = default;
-            RpcResponse& operator=(RpcResponse&&) noexcept = default;
-            ~RpcResponse() = default;
-        } rpc_rsponse_;
-        
-        // 默认构造函数（C++17 允许 union 包含非 POD 类型）
-        EventData() : rpc_request_{} {}
-        ~EventData() {}  // 需要显式析构函数来处理 std::string
-    } data_;
-    
-    // 提供默认构造函数
-    ModuleEvent() : type_(EventType::ET_NONE), data_() {}
-    
-    // 复制构造函数
-    ModuleEvent(const ModuleEvent& other) : type_(other.type_) {
-        switch (type_) {
-            case EventType::ET_RPC_REQUEST:
-                new (&data_.rpc_request_) EventData::RpcRequest(other.data_.rpc_request_);
-                break;
-            case EventType::ET_RPC_RESPONSE:
-                new (&data_.rpc_rsponse_) EventData::RpcResponse(other.data_.rpc_rsponse_);
-                break;
-            case EventType::ET_NONE:
-            default:
-                break;
-        }
-    }
-    
-    // 移动构造函数
-    ModuleEvent(ModuleEvent&& other) noexcept : type_(other.type_) {
-        switch (type_) {
-            case EventType::ET_RPC_REQUEST:
-                new (&data_.rpc_request_) EventData::RpcRequest(std::move(other.data_.rpc_request_));
-                break;
-            case EventType::ET_RPC_RESPONSE:
-                new (&data_.rpc_rsponse_) EventData::RpcResponse(std::move(other.data_.rpc_rsponse_));
-                break;
-            case EventType::ET_NONE:
-            default:
-                break;
-        }
-        other.type_ = EventType::ET_NONE;
-    }
-    
-    // 复制赋值运算符
-    ModuleEvent& operator=(const ModuleEvent& other) {
-        if (this != &other) {
-            // 先销毁当前对象
-            this->~ModuleEvent();
-            // 构造新对象
-            new (this) ModuleEvent(other);
-        }
-        return *this;
-    }
-    
-    // 移动赋值运算符
-    ModuleEvent& operator=(ModuleEvent&& other) noexcept {
-        if (this != &other) {
-            // 先销毁当前对象
-            this->~ModuleEvent();
-            // 构造新对象
-            new (this) ModuleEvent(std::move(other));
-        }
-        return *this;
-    }
-    
-    // 析构函数（需要显式处理 union 中的非 POD 类型）
-    ~ModuleEvent() {
-        switch (type_) {
-            case EventType::ET_RPC_REQUEST:
-                data_.rpc_request_.~RpcRequest();
-                break;
-            case EventType::ET_RPC_RESPONSE:
-                data_.rpc_rsponse_.~RpcResponse();
-                break;
-            case EventType::ET_NONE:
-            default:
-                break;
-        }
-    }
+    // RPC 数据包（请求、回包或批量请求），引用计数的缓冲区切片，在路由和入队过程中只移动不拷贝
+    BufferSlice payload_;
+    // 入口处解析好的协议头，后续环节直接使用
+    RpcEnvelope envelope_;
+    // 进程内直接调用的任务（仅 ET_LOCAL_CALL）
+    std::unique_ptr<ModuleTask> task_;
+    // 入队时间（单调时钟纳秒），用于统计各优先级通道的排队时间
+    int64_t enqueue_ns_ = 0;
+    EventType type_ = EventType::ET_NONE;
 };
 
-} // namespace BaseNode
\ No newline at end of file
+static_assert(sizeof(ModuleEvent) <= 112, "ModuleEvent grew, check the mailbox slot size before adding fields");
+
+} // namespace BaseNode
@@ -0,0 +1,269 @@
+#include "module_executor.h"
+#include "module_event.h"
+#include "module_router.h"
+#include "tools/singleton.h"
+#include <chrono>
+#include <string>
+#if defined(PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace BaseNode
+{
+
+namespace
+{
+// 当前线程所属的线程池和工作线程下标（非工作线程为 nullptr / 0）
+thread_local const WorkStealingExecutor* tls_executor = nullptr;
+thread_local size_t tls_worker_index = 0;
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    Stop();
+}
+
+ErrorCode WorkStealingExecutor::Start(const ModuleExecutorOptions& options)
+{
+    if (options.workers == 0) {
+        BaseNodeLogInfo("[ModuleExecutor] workers is 0, work-stealing executor disabled");
+        return ErrorCode::BN_SUCCESS;
+    }
+    if (IsRunning()) {
+        BaseNodeLogError("[ModuleExecutor] already started");
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+    workers_.clear();
+    for (uint32_t i = 0; i < options.workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    running_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        int cpu = i < options.cpus.size() ? options.cpus[i] : -1;
+        workers_[i]->thread = std::thread(&WorkStealingExecutor::Run_, this, i, cpu);
+    }
+    BaseNodeLogInfo("[ModuleExecutor] started %zu workers, pinned: %zu", workers_.size(), options.cpus.size());
+    return ErrorCode::BN_SUCCESS;
+}
+
+void WorkStealingExecutor::Stop()
+{
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    // 逐个经过各队列的锁：之前在锁内看到 running_ 为 true 的提交都已入队，之后的提交在锁内看到 false 并返回失败
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cond_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    // 工作线程可能在与之竞争的提交入队前就已退出，剩余的任务在当前线程上执行，协程不会被遗漏
+    size_t drained = 0;
+    Item item;
+    for (auto& worker : workers_) {
+        while (PopLocal_(*worker, item)) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            RunItem_(item);
+            ++drained;
+        }
+    }
+    BaseNodeLogInfo("[ModuleExecutor] stopped, submitted: %lu, drained after join: %zu",
+                    submitted_.load(std::memory_order_relaxed), drained);
+}
+
+bool WorkStealingExecutor::Post(std::coroutine_handle<> handle)
+{
+    if (!IsRunning()) {
+        return false;
+    }
+    Item item;
+    item.handle = handle;
+    return Submit_(std::move(item));
+}
+
+ModuleExecutorStats WorkStealingExecutor::GetStats() const
+{
+    ModuleExecutorStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.workers.reserve(workers_.size());
+    for (const auto& worker : workers_) {
+        ExecutorWorkerStats worker_stats;
+        worker_stats.executed = worker->executed.load(std::memory_order_relaxed);
+        worker_stats.steals = worker->steals.load(std::memory_order_relaxed);
+        worker_stats.steal_attempts = worker->steal_attempts.load(std::memory_order_relaxed);
+        worker_stats.sleeps = worker->sleeps.load(std::memory_order_relaxed);
+        worker_stats.depth = worker->depth.load(std::memory_order_relaxed);
+        stats.executed += worker_stats.executed;
+        stats.steals += worker_stats.steals;
+        stats.depth += worker_stats.depth;
+        stats.workers.push_back(worker_stats);
+    }
+    return stats;
+}
+
+bool WorkStealingExecutor::Submit_(Item&& item)
+{
+    // 工作线程提交到自己的队列，其他线程轮询分配
+    size_t index = tls_executor == this ? tls_worker_index
+                                         : static_cast<size_t>(next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size());
+    Worker& worker = *workers_[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        // 在队列锁内再检查一次，与 Stop() 配对：停止后不再入队，由调用方自行处理（Post 返回 false 时协程在当前线程恢复）
+        if (!IsRunning()) {
+            return false;
+        }
+        worker.queue.push_back(std::move(item));
+        worker.depth.store(static_cast<uint32_t>(worker.queue.size()), std::memory_order_relaxed);
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    // 先增加待处理计数再检查睡眠线程数，与工作线程的“先登记睡眠再检查计数”配对，不会丢失唤醒
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cond_.notify_one();
+    }
+    return true;
+}
+
+bool WorkStealingExecutor::PopLocal_(Worker& worker, Item& item)
+{
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) {
+        return false;
+    }
+    item = std::move(worker.queue.back());
+    worker.queue.pop_back();
+    worker.depth.store(static_cast<uint32_t>(worker.queue.size()), std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingExecutor::Steal_(size_t self, Item& item)
+{
+    Worker& thief = *workers_[self];
+    const size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(self + offset) % count];
+        // 先无锁看一眼深度，空队列不加锁
+        if (victim.depth.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        thief.steal_attempts.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.queue.empty()) {
+            continue;
+        }
+        item = std::move(victim.queue.front());
+        victim.queue.pop_front();
+        victim.depth.store(static_cast<uint32_t>(victim.queue.size()), std::memory_order_relaxed);
+        thief.steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingExecutor::RunItem_(Item& item)
+{
+    try {
+        if (item.handle) {
+            item.handle.resume();
+        } else if (item.job) {
+            item.job->Run();
+        }
+    } catch (const std::exception& e) {
+        BaseNodeLogError("[ModuleExecutor] job threw exception: %s", e.what());
+    } catch (...) {
+        BaseNodeLogError("[ModuleExecutor] job threw unknown exception");
+    }
+    item.handle = nullptr;
+    item.job.reset();
+}
+
+void WorkStealingExecutor::Run_(size_t index, int cpu)
+{
+    tls_executor = this;
+    tls_worker_index = index;
+    Worker& worker = *workers_[index];
+#if defined(PLATFORM_WINDOWS)
+    if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+    }
+#else
+    std::string name = "bn-worker-" + std::to_string(index);
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) {
+            BaseNodeLogError("[ModuleExecutor] worker %zu: pthread_setaffinity_np(%d) failed, error: %d", index, cpu, ret);
+        }
+    }
+#endif
+
+    Item item;
+    uint32_t idle_rounds = 0;
+    while (true) {
+        if (PopLocal_(worker, item) || Steal_(index, item)) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            RunItem_(item);
+            worker.executed.fetch_add(1, std::memory_order_relaxed);
+            idle_rounds = 0;
+            continue;
+        }
+        if (!IsRunning() && pending_.load(std::memory_order_acquire) <= 0) {
+            break;  // 停止后把剩余任务执行完再退出
+        }
+        if (++idle_rounds < MODULE_EXECUTOR_SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle_rounds = 0;
+        worker.sleeps.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cond_.wait_for(lock, std::chrono::milliseconds(MODULE_EXECUTOR_SLEEP_TIMEOUT_MS), [this] {
+            return pending_.load(std::memory_order_seq_cst) > 0 || !IsRunning();
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    tls_executor = nullptr;
+}
+
+bool ModuleAffinityAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    ModuleEvent event;
+    event.type_ = ModuleEvent::EventType::ET_LOCAL_CALL;
+    event.task_ = MakeModuleTask([handle](IModule&) { handle.resume(); });
+    ErrorCode err = ModuleRouterMgr->PostLocalEvent(module_id_, std::move(event));
+    if (err != ErrorCode::BN_SUCCESS) {
+        BaseNodeLogError("[ModuleExecutor] resume on module %u failed, error: %d, continue on current thread",
+                         module_id_, static_cast<int>(err));
+        return false;
+    }
+    return true;
+}
+
+} // namespace BaseNode
+
+static BaseNode::WorkStealingExecutor* g_module_executor_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::WorkStealingExecutor* GetModuleExecutorInstance() {
+    if (!g_module_executor_instance) {
+        g_module_executor_instance = ToolBox::Singleton<BaseNode::WorkStealingExecutor>::Instance();
+    }
+    return g_module_executor_instance;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BaseNode
+{
+
+#define MODULE_EXECUTOR_SPIN_ROUNDS 64        // 工作线程找不到任务时，进入睡眠前的自旋轮数
+#define MODULE_EXECUTOR_SLEEP_TIMEOUT_MS 100  // 睡眠的最长时间（兜底，正常由提交方唤醒）
+
+/**
+ * @brief 工作线程池配置，对应配置文件中的 {config_name}.executor
+ */
+struct ModuleExecutorOptions
+{
+    uint32_t workers = 0;        // 工作线程数，0 表示不启用（协程留在模块线程上执行）
+    std::vector<int> cpus;       // 按顺序绑定到各工作线程的 CPU，为空表示不绑核
+};
+
+/**
+ * @brief 单个工作线程的统计
+ */
+struct ExecutorWorkerStats
+{
+    uint64_t executed = 0;        // 执行的任务数
+    uint64_t steals = 0;          // 从其他线程偷到的任务数
+    uint64_t steal_attempts = 0;  // 尝试偷取的次数
+    uint64_t sleeps = 0;          // 进入睡眠的次数
+    uint32_t depth = 0;           // 当前本地队列深度
+};
+
+/**
+ * @brief 工作线程池统计
+ */
+struct ModuleExecutorStats
+{
+    uint64_t submitted = 0;       // 累计提交的任务数
+    uint64_t executed = 0;
+    uint64_t steals = 0;
+    uint32_t depth = 0;           // 所有本地队列的总深度
+    std::vector<ExecutorWorkerStats> workers;
+};
+
+/**
+ * @brief 投递到工作线程执行的任务
+ */
+class ExecutorJob
+{
+public:
+    virtual ~ExecutorJob() = default;
+    virtual void Run() = 0;
+};
+
+template <typename Func>
+class ExecutorJobImpl final : public ExecutorJob
+{
+public:
+    explicit ExecutorJobImpl(Func&& func) : func_(std::move(func)) {}
+    void Run() override { func_(); }
+
+private:
+    Func func_;
+};
+
+/**
+ * @brief 工作窃取线程池（所有模块共享）
+ *
+ * 每个工作线程一个本地双端队列：本线程从尾部取（LIFO，缓存友好），空闲线程从其他线程的头部偷（FIFO，偷走最老的任务）。
+ * 工作线程提交的任务进入自己的队列，其他线程（模块线程、网络线程）提交的任务轮询分配到各工作线程。
+ * 模块按需选择使用：协程中 co_await ModuleExecutorMgr->Schedule() 切到工作线程，
+ * 需要访问模块状态前 co_await ResumeOnModule() 回到模块自己的线程（经由模块邮箱）。
+ */
+class WorkStealingExecutor
+{
+public:
+    WorkStealingExecutor() = default;
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /**
+     * @brief 启动工作线程（workers 为 0 时不启动）
+     */
+    ErrorCode Start(const ModuleExecutorOptions& options);
+
+    /**
+     * @brief 停止工作线程（队列中剩余的任务执行完后才退出，与停止竞争入队的任务在调用线程上执行）
+     */
+    void Stop();
+
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 在工作线程上恢复协程
+     * @return 线程池未启动或正在停止时返回 false，由调用方自行恢复
+     */
+    bool Post(std::coroutine_handle<> handle);
+
+    /**
+     * @brief 在工作线程上执行函数（支持只能移动的函数对象）
+     * @return 线程池未启动或正在停止时返回 false（func 不会被执行）
+     */
+    template <typename Func>
+    bool Execute(Func&& func)
+    {
+        if (!IsRunning()) {
+            return false;
+        }
+        Item item;
+        item.job = std::make_unique<ExecutorJobImpl<std::decay_t<Func>>>(std::forward<Func>(func));
+        return Submit_(std::move(item));
+    }
+
+    /**
+     * @brief 切到工作线程继续执行的 awaiter：co_await ModuleExecutorMgr->Schedule();
+     * 线程池未启动时不挂起，协程在当前线程继续执行
+     */
+    auto Schedule()
+    {
+        struct ScheduleAwaiter
+        {
+            WorkStealingExecutor& executor;
+            bool await_ready() const noexcept { return !executor.IsRunning(); }
+            bool await_suspend(std::coroutine_handle<> handle) { return executor.Post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return ScheduleAwaiter{*this};
+    }
+
+    ModuleExecutorStats GetStats() const;
+
+private:
+    struct Item
+    {
+        std::coroutine_handle<> handle;
+        std::unique_ptr<ExecutorJob> job;
+    };
+
+    struct alignas(64) Worker
+    {
+        std::mutex mutex;
+        std::deque<Item> queue;
+        std::atomic<uint32_t> depth{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> steal_attempts{0};
+        std::atomic<uint64_t> sleeps{0};
+        std::thread thread;
+    };
+
+    bool Submit_(Item&& item);
+    bool PopLocal_(Worker& worker, Item& item);
+    bool Steal_(size_t self, Item& item);
+    void Run_(size_t index, int cpu);
+    static void RunItem_(Item& item);
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> next_worker_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<int64_t> pending_{0};        // 所有队列中的任务数，工作线程据此判断是否睡眠
+    std::atomic<uint32_t> sleepers_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cond_;
+};
+
+/**
+ * @brief 回到模块自己的线程继续执行的 awaiter（经由模块邮箱投递，保证模块状态只在模块线程上访问）
+ */
+class ModuleAffinityAwaiter
+{
+public:
+    explicit ModuleAffinityAwaiter(uint32_t module_id) : module_id_(module_id) {}
+
+    bool await_ready() const noexcept { return false; }
+    /**
+     * @return 投递失败（模块已注销或邮箱已满）时返回 false，协程在当前线程继续执行
+     */
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    uint32_t module_id_;
+};
+
+} // namespace BaseNode
+
+// 获取工作线程池实例的全局函数（在 basenode_core 中实现）
+extern "C" BaseNode::WorkStealingExecutor* GetModuleExecutorInstance();
+
+#define ModuleExecutorMgr GetModuleExecutorInstance()
@@ -1,16 +1,38 @@
 #include "module_interface.h"
 #include "module_event.h"
+#include "module_reactor.h"
 #include "utils/basenode_def_internal.h"
+#include <algorithm>
+#include <cxxabi.h>
+#include <cstdlib>
+#include <exception>
 
 namespace BaseNode
 {
+    IModule::IModule(uint32_t module_id, std::string_view type_name)
+        : module_id_(module_id), module_type_name_(type_name)
+    {
+    }
+
+    std::shared_ptr<std::atomic<bool>> IModule::MakeStoppingFlag_()
+    {
+        return std::make_shared<std::atomic<bool>>(false);
+    }
+
     ErrorCode IModule::Init() {
+        InitModuleIdentity_();
+        // 读取模块级配置（邮箱处理预算等）
+        ModuleOptions options = ModuleOptionsMgr->Get(GetModuleName());
+        SetMailboxOptions(options.mailbox);
+        rpc_batcher_.Configure(options.rpc_batch);
         // 先调用子类的初始化逻辑（注册RPC服务）
         ErrorCode err = DoInit();
         if (err != ErrorCode::BN_SUCCESS) {
             BaseNodeLogError("[module] DoInit failed, error: %d", err);
             return err;
         }
+        // 服务集合已经确定，建立各服务的指标（之后只读，路由线程可以直接查找）
+        metrics_.Build(rpc_server_.GetAllServiceHandlerKeys());
         // 然后注册模块到路由管理器（此时服务已经注册）
         err = RegisterToRouter_();
         if (err != ErrorCode::BN_SUCCESS) {
@@ -29,17 +51,44 @@ namespace BaseNode
     }
 
     ErrorCode IModule::Update() {
+        if (reactor_.load(std::memory_order_acquire)) {
+            return ErrorCode::BN_SUCCESS;  // 由执行线程驱动
+        }
+        Tick_();
+        return ErrorCode::BN_SUCCESS;
+    }
+
+    void IModule::Tick_() {
         ProcessRingBufferData_();  // 先处理环形缓冲区数据
+        timer_wheel_.Advance(ModuleReactor::NowNs());  // 触发到期的定时器
         DoUpdate();                  // 然后调用子类的更新逻辑
-        return ErrorCode::BN_SUCCESS;
+        rpc_batcher_.Flush(ModuleReactor::NowNs());  // 发送等待时间已到的批量调用
+        // 有定时器或待发送的批量调用时让驱动线程按时醒来，不受 tick 频率限制
+        int64_t next_expire_ns = timer_wheel_.NextExpireNs();
+        if (next_expire_ns > 0) {
+            GetReactor_()->WakeAt(next_expire_ns);
+        }
+        int64_t next_flush_ns = rpc_batcher_.NextFlushNs();
+        if (next_flush_ns > 0) {
+            GetReactor_()->WakeAt(next_flush_ns);
+        }
+    }
+
+    ModuleReactor* IModule::GetReactor_() const {
+        ModuleReactor* reactor = reactor_.load(std::memory_order_acquire);
+        return reactor ? reactor : ModuleReactorMgr;
     }
 
     ErrorCode IModule::UnInit() {
+        // 通知进行中的请求尽快结束
+        stopping_->store(true, std::memory_order_relaxed);
         ErrorCode err = DoUninit();
         if (err != ErrorCode::BN_SUCCESS) {
             BaseNodeLogError("[module] UnInit failed, error: %d", err);
             return err;
         }
+        // 注销前发出仍在聚合中的批量调用
+        rpc_batcher_.FlushAll();
         // 从路由管理器注销
         err = ModuleRouterMgr->UnregisterModule(this);
         if (err != ErrorCode::BN_SUCCESS) {
@@ -64,16 +113,73 @@ namespace BaseNode
 
     ErrorCode IModule::PushModuleEvent(ModuleEvent&& module_event)
     {
-        if (recv_ring_buffer_.Full()) {
-            ProcessRingBufferData_();
-            if (recv_ring_buffer_.Full()) {
-                return ErrorCode::BN_RECV_BUFF_OVERFLOW;
+        // 可能在任意线程调用：只负责入队和唤醒，消费逻辑只在驱动模块 Update 的线程执行
+        RpcPriority priority = EventPriority_(module_event);
+        uint32_t service_id = module_event.type_ == ModuleEvent::EventType::ET_RPC_REQUEST ? module_event.envelope_.service_id : 0;
+        ErrorCode err = mailbox_.Push(std::move(module_event), priority);
+        if (err != ErrorCode::BN_SUCCESS) {
+            if (ServiceMetrics* metrics = service_id ? metrics_.Find(service_id) : nullptr) {
+                metrics->RecordError(err);
             }
+            return err;
         }
-        recv_ring_buffer_.Push(std::move(module_event));
+        // 唤醒驱动本模块的线程（主循环或执行线程），尽快处理新事件
+        GetReactor_()->Notify();
         return ErrorCode::BN_SUCCESS;
     }
 
+    RpcPriority IModule::EventPriority_(const ModuleEvent& event) const
+    {
+        switch (event.type_) {
+        case ModuleEvent::EventType::ET_RPC_RESPONSE:
+            // 回包唤醒等待中的调用方，不应排在大批量请求之后
+            return RpcPriority::CONTROL;
+        case ModuleEvent::EventType::ET_RPC_REQUEST:
+        case ModuleEvent::EventType::ET_RPC_BATCH_REQUEST:
+        {
+            if (event.envelope_.priority < MODULE_MAILBOX_LANE_NUM) {
+                return static_cast<RpcPriority>(event.envelope_.priority);
+            }
+            if (service_priorities_.empty()) {
+                return RpcPriority::NORMAL;
+            }
+            auto it = service_priorities_.find(event.envelope_.service_id);
+            return it != service_priorities_.end() ? it->second : RpcPriority::NORMAL;
+        }
+        default:
+            return RpcPriority::NORMAL;
+        }
+    }
+
+    void IModule::SetServicePriority_(const std::vector<uint32_t>& before, RpcPriority priority)
+    {
+        for (uint32_t key : rpc_server_.GetAllServiceHandlerKeys()) {
+            if (std::find(before.begin(), before.end(), key) == before.end()) {
+                service_priorities_[key] = priority;
+            }
+        }
+    }
+
+    bool IModule::CheckServiceKeys_(const uint32_t* keys, size_t count)
+    {
+        std::vector<uint32_t> registered = rpc_server_.GetAllServiceHandlerKeys();
+        bool ok = true;
+        for (size_t i = 0; i < count; ++i) {
+            if (std::find(registered.begin(), registered.end(), keys[i]) != registered.end()) {
+                BaseNodeLogError("[module] RegisterService: service key %u is already registered in module %s",
+                                 keys[i], GetModuleName().c_str());
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void IModule::SetMailboxOptions(const MailboxOptions& options)
+    {
+        mailbox_options_ = options;
+        mailbox_.Configure(options);
+    }
+
     ErrorCode IModule::SetServerSendCallback(std::function<void(uint64_t, std::string&&)>&& callback)
     {
         ToolBox::CoroRpc::Errc errc = rpc_server_.SetSendCallback(std::move(callback));
@@ -86,49 +192,273 @@ namespace BaseNode
 
     ErrorCode IModule::SetClientSendCallback(std::function<void(std::string&&)>&& callback)
     {
-        rpc_client_.SetSendCallback(std::move(callback));
+        client_send_callback_ = std::move(callback);
+        rpc_client_.SetSendCallback([this](std::string&& data) { SendRequest_(std::move(data)); });
         return ErrorCode::BN_SUCCESS;
     }
 
+    void IModule::SendRequest_(std::string&& data)
+    {
+        // 没有刚启动的批量调用或被采样的调用时不解析协议头，普通调用的发送路径不变。
+        // 提示只用一次：批量调用没有发出请求时（如发送失败），最多让下一个请求多解析一次协议头
+        bool batch_hint = batch_send_hint_;
+        batch_send_hint_ = false;
+        if (batch_hint || !traced_calls_pending_.empty()) {
+            RpcEnvelope envelope;
+            if (RpcEnvelope::Parse(data, envelope) == ErrorCode::BN_SUCCESS) {
+                auto traced_it = envelope.trace_id != 0 ? traced_calls_pending_.find(envelope.parent_span_id) : traced_calls_pending_.end();
+                if (traced_it != traced_calls_pending_.end()) {
+                    RpcSpan span;
+                    span.trace_id = envelope.trace_id;
+                    span.span_id = envelope.parent_span_id;
+                    span.parent_span_id = traced_it->second;
+                    traced_calls_pending_.erase(traced_it);
+                    span.begin_us = envelope.trace_send_us;
+                    span.end_us = envelope.trace_send_us;
+                    span.service_id = envelope.service_id;
+                    span.request_id = envelope.request_id;
+                    span.module_id = GetModuleId();
+                    span.kind = RpcSpanKind::CLIENT_SEND;
+                    RpcTracerMgr->Record(span);
+                }
+                if (envelope.flags & RpcMetadata::kFlagBatch) {
+                    rpc_batcher_.Add(envelope, data);
+                    return;
+                }
+            }
+        }
+        if (client_send_callback_) {
+            client_send_callback_(std::move(data));
+        }
+    }
+
+    std::string IModule::BuildReqMetadata_(int64_t timeout_ms, uint8_t flags)
+    {
+        int64_t deadline_ms = RpcDeadlineClock::NowMs() + timeout_ms;
+        if (current_request_deadline_ms_ > 0 && current_request_deadline_ms_ < deadline_ms) {
+            deadline_ms = current_request_deadline_ms_;
+        }
+        if (req_deadline_ms_ > 0 && req_deadline_ms_ < deadline_ms) {
+            deadline_ms = req_deadline_ms_;
+        }
+        RpcMetadataFields fields;
+        fields.deadline_ms = deadline_ms;
+        fields.flags = flags;
+        fields.priority = req_priority_;
+        // 调用链：显式指定的优先，其次沿用正在处理的请求，都没有且不在处理请求时作为根调用按采样率采样
+        RpcTraceContext trace = req_trace_.Valid() ? req_trace_ : current_trace_;
+        if (!trace.Valid() && !dispatching_request_ && RpcTracerMgr->ShouldSample()) {
+            trace.trace_id = RpcTracer::NewId();
+            trace.span_id = 0;
+        }
+        if (trace.Valid()) {
+            if (traced_calls_pending_.size() >= RPC_TRACE_MAX_PENDING_SENDS) {
+                traced_calls_pending_.clear();
+            }
+            fields.trace_id = trace.trace_id;
+            fields.span_id = RpcTracer::NewId();
+            fields.trace_send_us = RpcTracer::NowUs();
+            traced_calls_pending_[fields.span_id] = trace.span_id;
+        }
+        std::string attachment = RpcMetadata::Encode(fields, req_attachment_);
+        req_deadline_ms_ = 0;
+        req_priority_ = RpcMetadata::kNoPriority;
+        req_trace_ = RpcTraceContext{};
+        req_attachment_.clear();
+        return attachment;
+    }
+
+    void IModule::ApplyReqMetadata_(const std::string& attachment)
+    {
+        if (!rpc_client_.SetReqAttachment(attachment)) {
+            BaseNodeLogError("[module] failed to set request attachment with metadata, attachment size: %zu", attachment.size());
+        }
+    }
+
     std::vector<uint32_t> IModule::GetAllServiceHandlerKeys()
     {
         return rpc_server_.GetAllServiceHandlerKeys();
     }
 
-    uint32_t IModule::GetModuleId() const
+    // 构造时 typeid(*this) 还是基类类型，所以类名和模块名在 Init 时才能确定
+    void IModule::InitModuleIdentity_()
     {
-        return MD5Hash32Constexpr(GetModuleClassName());
+        if (!module_class_name_.empty()) {
+            return;
+        }
+        const char* mangled = typeid(*this).name();
+        module_class_name_ = mangled;
+        if (module_type_name_.empty()) {
+            // 未继承 ModuleBase 的模块：按与编译期相同的规则（带命名空间类型名的 FNV-1a）计算一次
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+            module_type_name_ = (status == 0 && demangled) ? demangled : mangled;
+            std::free(demangled);
+            module_id_ = Fnv1a32(module_type_name_);
+        }
+        // 去掉命名空间前缀，如 BaseNode::Guild -> Guild
+        std::string::size_type pos = module_type_name_.rfind("::");
+        module_name_ = pos == std::string::npos ? module_type_name_ : module_type_name_.substr(pos + 2);
     }
 
-    // 获取最终子类的类名
-    std::string IModule::GetModuleClassName() const
+    MailboxStats IModule::GetMailboxStats() const
     {
-        const char* name = typeid(*this).name();
-        return name;
+        MailboxStats stats;
+        stats.queue = mailbox_.GetStats();
+        stats.events_drained = stats.queue.popped;
+        stats.drain_time_us = mailbox_drain_time_us_.load(std::memory_order_relaxed);
+        stats.budget_exhausted = mailbox_budget_exhausted_.load(std::memory_order_relaxed);
+        stats.last_drained = mailbox_last_drained_.load(std::memory_order_relaxed);
+        stats.leftover_depth = static_cast<uint32_t>(mailbox_.Depth());
+        for (uint32_t i = 0; i < MODULE_MAILBOX_LANE_NUM; ++i) {
+            stats.lanes[i] = mailbox_.GetLaneStats(static_cast<RpcPriority>(i));
+        }
+        return stats;
     }
 
+    // 按预算批量处理邮箱事件：最多处理 max_events_per_tick 个或 max_time_us 微秒，
+    // 剩余事件留到下一次 tick，避免单个繁忙模块饿死同一线程上的其他模块
     void IModule::ProcessRingBufferData_()
     {
-        while (!recv_ring_buffer_.Empty())
+        mailbox_.BindConsumerThread();
+        if (mailbox_.Empty()) {
+            mailbox_last_drained_.store(0, std::memory_order_relaxed);
+            // 空闲足够久后归还多余的块，降低常驻内存
+            mailbox_.Trim();
+            return;
+        }
+
+        const int64_t begin_ns = ModuleReactor::NowNs();
+        const int64_t deadline_ns = begin_ns + static_cast<int64_t>(mailbox_options_.max_time_us) * 1000;
+        uint32_t drained = 0;
+        ModuleEvent event;
+        while (drained < mailbox_options_.max_events_per_tick)
         {
-            // char* data = recv_ring_buffer_.GetReadPtr();
-            const ModuleEvent& event = recv_ring_buffer_.Pop();
+            if (drained > 0 && ModuleReactor::NowNs() >= deadline_ns) {
+                break;
+            }
+            if (!mailbox_.TryPop(event)) {
+                break;
+            }
+            BaseNodeLogTrace("[module] dispatch event type:%d, service_id:%u, client_id:%lu, request_id:%u, size:%zu",
+                             static_cast<int>(event.type_), event.envelope_.service_id, event.envelope_.client_id,
+                             event.envelope_.request_id, event.payload_.Size());
             switch (event.type_)
             {
             case ModuleEvent::EventType::ET_RPC_REQUEST:
-                rpc_server_.OnRecvReq(0, std::string_view(event.data_.rpc_request_.rpc_req_data_));
+                DispatchRequest_(event.envelope_, event.payload_.View(), event.enqueue_ns_);
                 break;
             case ModuleEvent::EventType::ET_RPC_RESPONSE:
-                rpc_client_.OnRecvResp(std::string_view(event.data_.rpc_rsponse_.rpc_rsp_data_));
+                rpc_client_.OnRecvResp(event.payload_.View());
+                break;
+            case ModuleEvent::EventType::ET_LOCAL_CALL:
+                RunLocalTask_(event);
+                break;
+            case ModuleEvent::EventType::ET_RPC_BATCH_REQUEST:
+                DispatchRpcBatch_(event);
                 break;
             default:
-                BaseNodeLogError("[module] invalid event type:%d", event.type_);
+                BaseNodeLogError("[module] invalid event type:%d", static_cast<int>(event.type_));
                 break;
             }
+            ++drained;
+        }
+        // 尽早把最后一个事件的缓冲区归还缓冲池
+        event.payload_.Reset();
+        event.task_.reset();
+
+        mailbox_last_drained_.store(drained, std::memory_order_relaxed);
+        mailbox_drain_time_us_.fetch_add(static_cast<uint64_t>((ModuleReactor::NowNs() - begin_ns) / 1000), std::memory_order_relaxed);
+        if (!mailbox_.Empty()) {
+            // 预算耗尽但仍有积压：让驱动线程立即进入下一次 tick 继续处理
+            mailbox_budget_exhausted_.fetch_add(1, std::memory_order_relaxed);
+            GetReactor_()->Notify();
+        }
+    }
+
+    void IModule::DispatchRequest_(const RpcEnvelope& envelope, std::string_view frame, int64_t enqueue_ns)
+    {
+        ServiceMetrics* metrics = metrics_.Find(envelope.service_id);
+        // 排队期间已经过期的请求不再处理
+        if (envelope.Expired()) {
+            RpcDropStatsMgr->Record(RpcDropReason::DEADLINE_AT_DISPATCH);
+            if (metrics) {
+                metrics->RecordError(ErrorCode::BN_RPC_DEADLINE_EXCEEDED);
+            }
+            BaseNodeLogDebug("[module] drop expired request, service_id: %u, request_id: %u, deadline_ms: %ld",
+                             envelope.service_id, envelope.request_id, envelope.deadline_ms);
             return;
         }
+        // 处理函数同步执行期间发起的调用继承该截止时间和调用链，取消令牌也从这里取得
+        int64_t begin_ns = ModuleReactor::NowNs();
+        RpcSpan span;
+        if (envelope.trace_id != 0) {
+            span.trace_id = envelope.trace_id;
+            span.parent_span_id = envelope.parent_span_id;
+            span.service_id = envelope.service_id;
+            span.request_id = envelope.request_id;
+            span.module_id = GetModuleId();
+            // 入队时间是单调时钟，按排队时长折算为 Unix 时间
+            span.end_us = RpcTracer::NowUs();
+            span.begin_us = span.end_us - std::max<int64_t>(begin_ns - enqueue_ns, 0) / 1000;
+            span.span_id = RpcTracer::NewId();
+            span.kind = RpcSpanKind::MAILBOX;
+            RpcTracerMgr->Record(span);
+            span.begin_us = span.end_us;
+            span.span_id = RpcTracer::NewId();
+            span.kind = RpcSpanKind::HANDLER;
+            current_trace_.trace_id = span.trace_id;
+            current_trace_.span_id = span.span_id;
+        }
+        current_request_deadline_ms_ = envelope.deadline_ms;
+        current_service_metrics_ = metrics;
+        dispatching_request_ = true;
+        rpc_server_.OnRecvReq(0, frame);
+        dispatching_request_ = false;
+        current_request_deadline_ms_ = 0;
+        current_service_metrics_ = nullptr;
+        int64_t end_ns = ModuleReactor::NowNs();
+        if (metrics) {
+            metrics->RecordRequest(static_cast<uint64_t>(std::max<int64_t>(begin_ns - enqueue_ns, 0)),
+                                   static_cast<uint64_t>(end_ns - begin_ns));
+        }
+        if (span.trace_id != 0) {
+            current_trace_ = RpcTraceContext{};
+            span.end_us = span.begin_us + (end_ns - begin_ns) / 1000;
+            RpcTracerMgr->Record(span);
+        }
+    }
+
+    // 批量请求整体算作一个邮箱事件，请求帧之间不检查处理预算
+    void IModule::DispatchRpcBatch_(ModuleEvent& event)
+    {
+        std::string_view batch = event.payload_.View();
+        size_t offset = 0;
+        std::string_view frame;
+        RpcEnvelope envelope;
+        while (RpcBatchFrame::Next(batch, offset, frame)) {
+            if (RpcEnvelope::Parse(frame, envelope) != ErrorCode::BN_SUCCESS) {
+                continue;
+            }
+            DispatchRequest_(envelope, frame, event.enqueue_ns_);
+        }
     }
 
+    void IModule::RunLocalTask_(ModuleEvent& event)
+    {
+        if (!event.task_) {
+            BaseNodeLogError("[module] local call event without task, module id: %u", GetModuleId());
+            return;
+        }
+        try {
+            event.task_->Run(*this);
+        } catch (const std::exception& e) {
+            BaseNodeLogError("[module] local call task threw exception, module id: %u, what: %s", GetModuleId(), e.what());
+        } catch (...) {
+            BaseNodeLogError("[module] local call task threw unknown exception, module id: %u", GetModuleId());
+        }
+        event.task_.reset();
+    }
 
     ErrorCode IModule::RegisterToRouter_()
     {
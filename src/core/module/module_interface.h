@@ -1,29 +1,58 @@
 #pragma once
 #include "module_event.h"
 #include "module_zk.h"
+#include "module_options.h"
+#include "module_mailbox.h"
+#include "module_type_id.h"
+#include "module_executor.h"
+#include "module_timer.h"
+#include "module_rpc_batch.h"
+#include "module_metrics.h"
+#include "module_rpc_trace.h"
 #include "utils/basenode_def_internal.h"
-#include "tools/ringbuffer.h"
 #include "tools/function_traits.h"
 #include "coro_rpc/coro_rpc_server.h" // IWYU pragma: keep
 #include "coro_rpc/coro_rpc_client.h" // IWYU pragma: keep
 #include "module_router.h"
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
 
 // 前向声明
 namespace BaseNode {
     class ModuleRouter;
+    class ModuleReactor;
+    class ModuleActor;
 }
 
 namespace BaseNode
 {
 
-#define DEFAULT_MODULE_RING_BUFF_SIZE 256 * 1024
+/**
+ * @brief 模块邮箱处理统计
+ */
+struct MailboxStats
+{
+    uint64_t events_drained = 0;      // 累计处理的事件数
+    uint64_t drain_time_us = 0;       // 累计处理耗时（微秒）
+    uint64_t budget_exhausted = 0;    // 因预算耗尽而留到下一次 tick 的次数
+    uint32_t last_drained = 0;        // 最近一次 Update 处理的事件数
+    uint32_t leftover_depth = 0;      // 当前积压的事件数
+    MailboxQueueStats queue;          // 入队侧统计（溢出、高水位等，所有优先级通道合计）
+    MailboxLaneStats lanes[MODULE_MAILBOX_LANE_NUM];  // 各优先级通道的统计（下标为 RpcPriority）
+};
 
 class IModule
 {
 public:
+    IModule() = default;
     virtual ~IModule() = default;
     
     // 非虚函数，确保基类逻辑总是被执行
@@ -32,6 +61,7 @@ public:
     
     // 非虚函数，确保基类逻辑总是被执行
     // 子类不应该重写此方法，而是重写 DoUpdate()
+    // 模块交给执行线程（ModuleActor）驱动后，插件 updateSo 中的调用直接返回
     ErrorCode Update();
 
     // 非虚函数，确保基类逻辑总是被执行
@@ -51,15 +81,51 @@ public:
     
     /**
      * @brief 获取模块ID
-     * @return 模块ID（基于类名的MD5哈希）
+     * @return 模块ID（类型名的 FNV-1a 哈希，继承 ModuleBase 的模块在编译期确定）
      */
-    uint32_t GetModuleId() const;
+    uint32_t GetModuleId() const { return module_id_; }
 
     /**
      * @brief 获取最终子类的类名
-     * @return 类名
+     * @return 类名（RTTI 名称）
+     */
+    const std::string& GetModuleClassName() const { return module_class_name_; }
+
+    /**
+     * @brief 获取模块名（去掉命名空间的可读类名，如 "Guild"），用于配置和统计
+     * @return 模块名
+     */
+    const std::string& GetModuleName() const { return module_name_; }
+
+    /**
+     * @brief 设置邮箱配置（Init 时会从 ModuleOptionsMgr 读取，一般无需手动调用；队列容量只在第一次设置时生效）
+     */
+    void SetMailboxOptions(const MailboxOptions& options);
+
+    /**
+     * @brief 获取邮箱处理统计
+     */
+    MailboxStats GetMailboxStats() const;
+
+    /**
+     * @brief 获取各服务的运行时指标（请求数、错误数、排队和处理延迟）
      */
-    std::string GetModuleClassName() const;
+    const ModuleMetrics& GetMetrics() const { return metrics_; }
+
+    /**
+     * @brief 记录当前正在处理的请求的业务错误（处理函数的返回值由 RPC 库序列化，框架无法得知，需要统计时在处理函数中调用）
+     * 只能在处理函数第一次挂起之前调用
+     */
+    void RecordRequestError(ErrorCode code) {
+        if (current_service_metrics_) {
+            current_service_metrics_->RecordError(code);
+        }
+    }
+
+    /**
+     * @brief 获取批量调用统计
+     */
+    RpcBatchStats GetRpcBatchStats() const { return rpc_batcher_.GetStats(); }
 
     /**
      * @brief 注册RPC服务函数（非成员函数）
@@ -68,6 +134,11 @@ public:
      */
     template <auto first, auto... func>
     void RegisterService() {
+        using Keys = ServiceKeyTable<first, func...>;
+        static_assert(Keys::Unique(), "duplicate service or service key collision in RegisterService");
+        if (!CheckServiceKeys_(Keys::kKeys.data(), Keys::kSize)) {
+            return;
+        }
         rpc_server_.template RegisterService<first, func...>();
     }
 
@@ -79,11 +150,41 @@ public:
      */
     template <auto first, auto... functions>
     void RegisterService(typename ToolBox::FunctionTraits<decltype(first)>::class_type *self) {
+        using Keys = ServiceKeyTable<first, functions...>;
+        static_assert(Keys::Unique(), "duplicate service or service key collision in RegisterService");
+        if (!CheckServiceKeys_(Keys::kKeys.data(), Keys::kSize)) {
+            return;
+        }
         rpc_server_.template RegisterService<first, functions...>(self);
     }
 
+    /**
+     * @brief 注册RPC服务函数并声明它们的优先级（非成员函数）
+     * 请求进入本模块邮箱的对应优先级通道（调用方用 SetReqPriority 指定的优先级优先）；只能在 DoInit 中调用
+     * @param priority 服务的优先级
+     */
+    template <auto first, auto... func>
+    void RegisterService(RpcPriority priority) {
+        std::vector<uint32_t> before = rpc_server_.GetAllServiceHandlerKeys();
+        RegisterService<first, func...>();
+        SetServicePriority_(before, priority);
+    }
+
+    /**
+     * @brief 注册RPC服务函数并声明它们的优先级（成员函数），如 RegisterService<&Guild::GetGuildMembersStreamPB>(RpcPriority::BULK, this);
+     * @param priority 服务的优先级
+     * @param self 对象指针
+     */
+    template <auto first, auto... functions>
+    void RegisterService(RpcPriority priority, typename ToolBox::FunctionTraits<decltype(first)>::class_type *self) {
+        std::vector<uint32_t> before = rpc_server_.GetAllServiceHandlerKeys();
+        RegisterService<first, functions...>(self);
+        SetServicePriority_(before, priority);
+    }
+
     /**
      * @brief 调用RPC服务（使用默认5秒超时）
+     * 请求附件中带上截止时间：默认为 5 秒后，处理请求期间发起的调用继承当前请求的截止时间，SetReqDeadline 可以进一步缩短
      * @tparam func RPC函数指针（支持非成员函数和成员函数指针）
      * @tparam Args 参数类型
      * @param args RPC函数参数
@@ -91,11 +192,30 @@ public:
      */
     template <auto func, typename... Args>
     auto CallModuleService(Args &&...args) -> ToolBox::coro::Task<ToolBox::CoroRpc::async_rpc_result_value_t<ToolBox::CoroRpc::rpc_async_return_value_t<typename ToolBox::FunctionTraits<decltype(func)>::return_type>>, ToolBox::coro::SharedLooperExecutor> {
+        PrepareReqMetadata_(MODULE_RPC_DEFAULT_TIMEOUT_MS);
         return rpc_client_.template Call<func>(std::forward<Args>(args)...);
     }
     
+    /**
+     * @brief 批量调用RPC服务（使用默认5秒超时），用法和返回值与 CallModuleService 相同
+     *
+     * 请求帧不立即发送，而是和同一服务的其他批量调用合并成一个批量帧，整批只经过一次路由和入队，
+     * 目标模块在一次邮箱事件中依次处理，结果仍然逐个返回给各自的等待者。
+     * 批量帧在达到 rpc_batch.max_calls / max_bytes 时立即发送，否则最多等待 rpc_batch.linger_us（为 0 时在本次 tick 结束时发送），
+     * 适合登录风暴这类一次 tick 内大量发出的小请求；对单个请求的延迟敏感时使用 CallModuleService。
+     * 目标模块不在本进程时批量帧会在路由处拆开，按普通请求转发。
+     * 批量标志随本次请求的元数据发送：元数据在调用时生成，在请求真正发出前一刻才设置到 RPC 客户端，
+     * 先创建、后启动的调用不会用到其他调用的元数据。
+     */
+    template <auto func, typename... Args>
+    auto CallModuleServiceBatch(Args &&...args) -> ToolBox::coro::Task<ToolBox::CoroRpc::async_rpc_result_value_t<ToolBox::CoroRpc::rpc_async_return_value_t<typename ToolBox::FunctionTraits<decltype(func)>::return_type>>, ToolBox::coro::SharedLooperExecutor> {
+        return CallModuleServiceBatch_<func>(BuildReqMetadata_(MODULE_RPC_DEFAULT_TIMEOUT_MS, RpcMetadata::kFlagBatch),
+                                             std::decay_t<Args>(std::forward<Args>(args))...);
+    }
+
     /**
      * @brief 调用流式RPC服务（使用默认30秒超时）
+     * 截止时间规则同 CallModuleService，默认为 30 秒后
      * @tparam func RPC函数指针（必须返回StreamGenerator类型）
      * @tparam Args 参数类型
      * @param args RPC函数参数
@@ -103,19 +223,145 @@ public:
      */
     template <auto func, typename... Args>
     auto CallModuleServiceStream(Args &&...args) -> ToolBox::coro::Task<std::shared_ptr<ToolBox::CoroRpc::StreamReader<std::string>>, ToolBox::coro::SharedLooperExecutor> {
+        PrepareReqMetadata_(MODULE_RPC_STREAM_TIMEOUT_MS);
         return rpc_client_.template CallStream<func>(std::forward<Args>(args)...);
     }
 
     /**
-     * @brief 设置RPC请求的附件数据
+     * @brief 进程内直接调用（目标模块与调用方在同一进程时使用，跳过序列化）
+     *
+     * 参数按值打包成闭包投递到目标模块的邮箱，在目标模块的消费线程上直接调用 func；返回值再以闭包投递回调用方的邮箱，
+     * 在调用方的消费线程上执行 callback。模块之间仍然只通过邮箱交互，不共享调用栈。
+     * 目标模块不在本进程时返回 BN_MODULE_NOT_LOCAL，调用方应改用 CallModuleService 走 RPC：
+     *     if (CallModuleServiceLocal<&Guild::OnPlayerLogin>([](ErrorCode ret) { ... }, player_id) != ErrorCode::BN_SUCCESS) {
+     *         CallModuleService<&Guild::OnPlayerLogin>(player_id).then(...);
+     *     }
+     * 仅支持普通成员函数；协程（Task）和流式（StreamGenerator）服务仍走 RPC。
+     * @tparam func 目标模块的成员函数指针
+     * @param callback 结果回调，签名为 void(R)（func 返回 void 时为 void()）
+     * @param args 调用参数（拷贝或移动进闭包，不能传递指向调用方内部状态的引用）
+     * @return 错误码
+     */
+    template <auto func, typename Callback, typename... Args>
+    ErrorCode CallModuleServiceLocal(Callback &&callback, Args &&...args) {
+        using Traits = ToolBox::FunctionTraits<decltype(func)>;
+        using Target = typename Traits::class_type;
+        using Result = typename Traits::return_type;
+        static_assert(std::is_member_function_pointer_v<decltype(func)>, "CallModuleServiceLocal only supports member functions");
+        static_assert(!requires { typename Result::promise_type; }, "coroutine and stream services must use CallModuleService");
+
+        const uint32_t caller_id = GetModuleId();
+        ModuleEvent event;
+        event.type_ = ModuleEvent::EventType::ET_LOCAL_CALL;
+        event.task_ = MakeModuleTask(
+            [caller_id, callback = std::forward<Callback>(callback),
+             params = std::make_tuple(std::forward<Args>(args)...)](IModule &module) mutable {
+                Target &target = static_cast<Target &>(module);
+                ModuleEvent reply;
+                reply.type_ = ModuleEvent::EventType::ET_LOCAL_CALL;
+                if constexpr (std::is_void_v<Result>) {
+                    std::apply([&target](auto &...values) { (target.*func)(std::move(values)...); }, params);
+                    reply.task_ = MakeModuleTask([callback = std::move(callback)](IModule &) mutable { callback(); });
+                } else {
+                    Result result = std::apply([&target](auto &...values) { return (target.*func)(std::move(values)...); }, params);
+                    reply.task_ = MakeModuleTask([callback = std::move(callback), result = std::move(result)](IModule &) mutable {
+                        callback(std::move(result));
+                    });
+                }
+                ErrorCode err = ModuleRouterMgr->PostLocalEvent(caller_id, std::move(reply));
+                if (err != ErrorCode::BN_SUCCESS) {
+                    BaseNodeLogError("[module] CallModuleServiceLocal: failed to post result to caller module %u, error: %d", caller_id, static_cast<int>(err));
+                }
+            });
+        return ModuleRouterMgr->PostLocalEvent(ModuleTypeId<Target>(), std::move(event));
+    }
+
+    /**
+     * @brief 回到本模块线程继续执行：co_await ResumeOnModule();
+     * 协程通过 co_await ModuleExecutorMgr->Schedule() 切到工作线程后，访问模块状态前需要先回到模块线程
+     */
+    ModuleAffinityAwaiter ResumeOnModule() const { return ModuleAffinityAwaiter(GetModuleId()); }
+
+    /**
+     * @brief 添加一次性定时器（只能在模块线程上调用，回调也在模块线程上执行）
+     * @param delay_ms 延迟（毫秒）
+     * @param callback 到期回调
+     * @return 定时器ID，可用于 CancelTimer（也可用作 RPC 等待的截止定时器，完成时取消）
+     */
+    TimerId AddTimer(uint32_t delay_ms, std::function<void()> callback) { return timer_wheel_.AddTimer(delay_ms, std::move(callback)); }
+
+    /**
+     * @brief 添加周期定时器（只能在模块线程上调用）
+     */
+    TimerId AddPeriodicTimer(uint32_t interval_ms, std::function<void()> callback) { return timer_wheel_.AddPeriodicTimer(interval_ms, std::move(callback)); }
+
+    /**
+     * @brief 取消定时器（只能在模块线程上调用）
+     * @return 定时器存在且被取消时返回 true
+     */
+    bool CancelTimer(TimerId timer_id) { return timer_wheel_.Cancel(timer_id); }
+
+    /**
+     * @brief 协程休眠：co_await SleepFor(std::chrono::milliseconds(100));
+     * 只能在模块线程上 co_await（在工作线程上需先 co_await ResumeOnModule()），到期后在模块线程上恢复
+     */
+    TimerSleepAwaiter SleepFor(std::chrono::milliseconds duration) {
+        return TimerSleepAwaiter(timer_wheel_, static_cast<uint32_t>(std::max<int64_t>(duration.count(), 0)));
+    }
+
+    /**
+     * @brief 当前未到期的定时器数
+     */
+    size_t GetTimerCount() const { return timer_wheel_.Size(); }
+
+    /**
+     * @brief 设置RPC请求的附件数据（对下一次调用生效，发送时前面会加上框架元数据，服务端用 RpcEnvelope::UserAttachment 取回）
      * @param attachment 附件数据（string_view）
      * @return 是否设置成功（如果附件数据过长会返回false）
      */
     bool SetReqAttachment(std::string_view attachment) {
-        return rpc_client_.SetReqAttachment(attachment);
+        if (!rpc_client_.SetReqAttachment(attachment)) {
+            return false;
+        }
+        req_attachment_.assign(attachment.data(), attachment.size());
+        return true;
     }
 
+    /**
+     * @brief 设置下一次调用的截止时间（只能比默认超时和继承的截止时间更早）
+     * @param deadline_ms 绝对时间（Unix 毫秒，见 RpcDeadlineClock::NowMs / RpcCancellationToken::GetDeadlineMs）
+     */
+    void SetReqDeadline(int64_t deadline_ms) { req_deadline_ms_ = deadline_ms; }
+
+    /**
+     * @brief 设置下一次调用的优先级（覆盖目标服务注册时声明的优先级）
+     * 同一服务的调用使用不同优先级时，它们在目标模块的处理顺序不再与发出顺序一致
+     */
+    void SetReqPriority(RpcPriority priority) { req_priority_ = static_cast<uint8_t>(priority); }
+
+    /**
+     * @brief 当前正在处理的请求的取消令牌（只能在处理函数第一次挂起之前获取，之后保存令牌自行检查）
+     * 调用方的截止时间已过或模块正在卸载时 IsCancelled() 返回 true
+     */
+    RpcCancellationToken CurrentRequestToken() const { return RpcCancellationToken(current_request_deadline_ms_, stopping_); }
+
+    /**
+     * @brief 当前正在处理的请求的调用链上下文（没有被采样时 Valid() 为 false）
+     * 处理函数同步执行期间发起的调用自动沿用；挂起之后发起的调用需要先取得上下文，再用 SetReqTrace 指定
+     */
+    const RpcTraceContext& CurrentTraceContext() const { return current_trace_; }
+
+    /**
+     * @brief 指定下一次调用所属的调用链（如协程挂起后继续发起的下游调用）
+     */
+    void SetReqTrace(const RpcTraceContext& trace) { req_trace_ = trace; }
+
 protected:
+    /**
+     * @brief 由 ModuleBase 调用，传入编译期确定的模块ID和类型名
+     */
+    IModule(uint32_t module_id, std::string_view type_name);
+
     // 子类重写此方法来实现自己的初始化逻辑
     virtual ErrorCode DoInit() = 0;
     
@@ -128,7 +374,96 @@ protected:
     virtual ErrorCode DoAfterAllModulesInit() { return ErrorCode::BN_SUCCESS; }
     
 private:
+    friend class ModuleActor;
+
+    /**
+     * @brief 处理邮箱、触发到期定时器并调用 DoUpdate（由主循环或所属的执行线程调用）
+     */
+    void Tick_();
+
+    /**
+     * @brief 设置驱动本模块的执行线程的唤醒器，nullptr 表示由主循环驱动
+     */
+    void BindReactor_(ModuleReactor* reactor) { reactor_.store(reactor, std::memory_order_release); }
+
+    /**
+     * @brief 获取驱动本模块的线程的唤醒器
+     */
+    ModuleReactor* GetReactor_() const;
+
+    /**
+     * @brief 确定模块ID、类名和模块名（Init 时调用一次，之后的查询都是字段读取）
+     */
+    void InitModuleIdentity_();
+
     void ProcessRingBufferData_();
+
+    /**
+     * @brief 把截止时间、标志位、调用链和业务附件写入下一次调用的附件
+     * @param timeout_ms 本次调用的默认超时
+     * @param flags 标志位（RpcMetadata::kFlag*）
+     */
+    void PrepareReqMetadata_(int64_t timeout_ms, uint8_t flags = 0) { ApplyReqMetadata_(BuildReqMetadata_(timeout_ms, flags)); }
+
+    /**
+     * @brief 生成一次调用的附件（截止时间、标志位、调用链和业务附件），并清除 SetReq* 设置的下一次调用参数
+     */
+    std::string BuildReqMetadata_(int64_t timeout_ms, uint8_t flags);
+
+    /**
+     * @brief 把附件设置到 RPC 客户端，对随后发出的一个请求生效
+     */
+    void ApplyReqMetadata_(const std::string& attachment);
+
+    /**
+     * @brief 批量调用的协程：启动时才设置本次调用的附件并发出请求（参数按值保存在协程帧中）
+     */
+    template <auto func, typename... Args>
+    auto CallModuleServiceBatch_(std::string attachment, Args... args) -> ToolBox::coro::Task<ToolBox::CoroRpc::async_rpc_result_value_t<ToolBox::CoroRpc::rpc_async_return_value_t<typename ToolBox::FunctionTraits<decltype(func)>::return_type>>, ToolBox::coro::SharedLooperExecutor> {
+        ApplyReqMetadata_(attachment);
+        batch_send_hint_ = true;
+        co_return co_await rpc_client_.template Call<func>(std::move(args)...);
+    }
+
+    /**
+     * @brief 把 RegisterService 新增的服务键设为指定优先级
+     * @param before 注册前已有的服务键
+     */
+    void SetServicePriority_(const std::vector<uint32_t>& before, RpcPriority priority);
+
+    /**
+     * @brief 检查本次注册的服务ID是否与本模块已注册的服务冲突（同一模块多次 RegisterService 时）
+     * @return false 有冲突，本次注册被跳过
+     */
+    bool CheckServiceKeys_(const uint32_t* keys, size_t count);
+
+    /**
+     * @brief 事件进入的邮箱通道：回包走控制通道，请求按调用方指定的优先级或服务的优先级，其余走普通通道
+     */
+    RpcPriority EventPriority_(const ModuleEvent& event) const;
+
+    /**
+     * @brief RPC 客户端的发送回调：记录被采样请求的发送 span，带批量标志的请求帧交给聚合器，其余直接交给路由
+     */
+    void SendRequest_(std::string&& data);
+
+    /**
+     * @brief 把一个请求帧交给 RPC 服务器处理：丢弃已过期的请求，记录排队和处理延迟，被采样的请求记录邮箱和处理 span
+     * @param envelope 请求帧的协议头
+     * @param frame 请求帧
+     * @param enqueue_ns 请求进入邮箱的时间
+     */
+    void DispatchRequest_(const RpcEnvelope& envelope, std::string_view frame, int64_t enqueue_ns);
+
+    /**
+     * @brief 在一次邮箱事件中依次处理批量请求中的各个请求帧
+     */
+    void DispatchRpcBatch_(ModuleEvent& event);
+
+    /**
+     * @brief 执行进程内直接调用的任务（异常只记录日志，不影响后续事件）
+     */
+    void RunLocalTask_(ModuleEvent& event);
     /**
      * @brief 注册模块到路由管理器
      * 在基类Init()中自动调用，子类无需关心
@@ -138,12 +473,59 @@ private:
 
      ErrorCode RegisterToZk_();
 
+    /**
+     * @brief 创建卸载标志
+     * 定义在核心库中，shared_ptr 控制块（及其虚表）属于核心库，插件卸载后仍持有令牌的协程可以安全释放它
+     */
+    static std::shared_ptr<std::atomic<bool>> MakeStoppingFlag_();
+
 private:
-    ToolBox::RingBufferSPSC<ModuleEvent, DEFAULT_MODULE_RING_BUFF_SIZE> recv_ring_buffer_; // 接收缓冲区
+    uint32_t module_id_ = 0;                            // 模块ID
+    std::string module_type_name_;                      // 带命名空间的类型名，如 BaseNode::Guild
+    std::string module_class_name_;                     // RTTI 类名
+    std::string module_name_;                           // 去掉命名空间的模块名
+    ModulePriorityMailbox mailbox_;                     // 接收邮箱（MPSC，按优先级分通道）
+    std::atomic<ModuleReactor*> reactor_{nullptr};      // 所属执行线程的唤醒器，nullptr 表示主循环
+    ModuleTimerWheel timer_wheel_;                      // 定时器（只在模块线程上访问）
+    // 模块正在卸载，取消令牌据此取消进行中的请求；与令牌共享所有权，在核心库中创建（MakeStoppingFlag_）
+    std::shared_ptr<std::atomic<bool>> stopping_ = MakeStoppingFlag_();
+    int64_t current_request_deadline_ms_ = 0;           // 正在分发的请求的截止时间（分发期间有效）
+    int64_t req_deadline_ms_ = 0;                       // 下一次调用的截止时间（SetReqDeadline）
+    std::string req_attachment_;                        // 下一次调用的业务附件（SetReqAttachment）
+    uint8_t req_priority_ = RpcMetadata::kNoPriority;   // 下一次调用的优先级（SetReqPriority）
+    bool dispatching_request_ = false;                  // 正在同步执行处理函数（此时发起的调用不再作为根调用采样）
+    RpcTraceContext current_trace_;                     // 正在分发的请求的调用链（分发期间有效）
+    RpcTraceContext req_trace_;                         // 下一次调用所属的调用链（SetReqTrace）
+    std::unordered_map<uint64_t, uint64_t> traced_calls_pending_;  // 已被采样但请求帧尚未发出的调用：span ID -> 父 span ID
+    std::unordered_map<uint32_t, RpcPriority> service_priorities_;  // 服务键 -> 优先级（只在 DoInit 中写入，之后只读）
+    ModuleMetrics metrics_;                             // 各服务的运行时指标（服务集合在注册到路由前确定）
+    ServiceMetrics* current_service_metrics_ = nullptr; // 正在分发的请求的服务指标（分发期间有效）
+    ModuleRpcBatcher rpc_batcher_;                      // 批量调用聚合器（只在模块线程上访问）
+    bool batch_send_hint_ = false;                      // 下一个请求帧可能是批量调用（只决定是否解析协议头，是否批量以请求元数据中的标志为准）
+    std::function<void(std::string&&)> client_send_callback_;   // 路由提供的请求发送回调
+    MailboxOptions mailbox_options_;                    // 邮箱处理预算
+    std::atomic<uint64_t> mailbox_drain_time_us_{0};    // 累计处理耗时
+    std::atomic<uint64_t> mailbox_budget_exhausted_{0}; // 预算耗尽次数
+    std::atomic<uint32_t> mailbox_last_drained_{0};     // 最近一次处理的事件数
     ToolBox::CoroRpc::CoroRpcServer<ToolBox::CoroRpc::CoroRpcProtocol> rpc_server_; // RPC 服务器
     ToolBox::CoroRpc::CoroRpcClient<ToolBox::CoroRpc::CoroRpcProtocol> rpc_client_; // RPC 客户端
     
 };
 
 
+/**
+ * @brief 模块基类（CRTP）：模块ID在编译期由类型名计算
+ *
+ * 用法：class Guild : public ModuleBase<Guild> { ... };
+ */
+template <typename Derived>
+class ModuleBase : public IModule
+{
+public:
+    static constexpr uint32_t kModuleId = ModuleTypeId<Derived>();
+
+protected:
+    ModuleBase() : IModule(kModuleId, TypeNameOf<Derived>()) {}
+};
+
 } // namespace BaseNode
\ No newline at end of file
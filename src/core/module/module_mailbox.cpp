@@ -0,0 +1,428 @@
+#include "module_mailbox.h"
+#include "module_reactor.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+namespace BaseNode
+{
+
+ModuleMailbox::~ModuleMailbox()
+{
+    if (!chunks_) {
+        return;
+    }
+    ModuleEvent event;
+    while (TryPopRing_(event)) {
+    }
+    for (uint64_t i = 0; i < chunk_count_; ++i) {
+        delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+    delete[] chunks_;
+    chunks_ = nullptr;
+}
+
+void ModuleMailbox::Configure(const MailboxOptions& options)
+{
+    if (chunks_) {
+        BaseNodeLogWarn("[ModuleMailbox] Configure: mailbox already configured, capacity: %lu", capacity_);
+        return;
+    }
+    options_ = options;
+
+    // 块大小和容量都向上取整为 2 的幂，便于用掩码取下标，容量至少为一个块
+    uint64_t chunk_size = 2;
+    uint64_t chunk_shift = 1;
+    while (chunk_size < options.chunk_size) {
+        chunk_size <<= 1;
+        ++chunk_shift;
+    }
+    uint64_t capacity = chunk_size;
+    while (capacity < options.capacity) {
+        capacity <<= 1;
+    }
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    chunk_size_ = chunk_size;
+    chunk_shift_ = chunk_shift;
+    chunk_mask_ = chunk_size - 1;
+    chunk_count_ = capacity / chunk_size;
+    chunks_ = new std::atomic<Cell*>[chunk_count_];
+    for (uint64_t i = 0; i < chunk_count_; ++i) {
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ErrorCode ModuleMailbox::Push(ModuleEvent&& event)
+{
+    if (!chunks_) {
+        BaseNodeLogError("[ModuleMailbox] Push: mailbox not configured");
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return ErrorCode::BN_RECV_BUFF_OVERFLOW;
+    }
+
+    // 二级队列非空时新事件也进入二级队列，保证消费顺序与入队顺序一致
+    if (spill_size_.load(std::memory_order_acquire) > 0) {
+        return Spill_(std::move(event));
+    }
+
+    if (TryPushRing_(event)) {
+        return ErrorCode::BN_SUCCESS;
+    }
+
+    switch (options_.overflow_policy) {
+    case MailboxOverflowPolicy::SPILL:
+        return Spill_(std::move(event));
+
+    case MailboxOverflowPolicy::BLOCK:
+    {
+        // 消费者线程给自己投递时等待只会死锁，退化为溢出到二级队列
+        if (consumer_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+            return Spill_(std::move(event));
+        }
+        blocked_.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(options_.block_timeout_us);
+        for (uint32_t attempt = 0; ; ++attempt) {
+            if (attempt < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            if (TryPushRing_(event)) {
+                return ErrorCode::BN_SUCCESS;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        block_timeouts_.fetch_add(1, std::memory_order_relaxed);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return ErrorCode::BN_RECV_BUFF_OVERFLOW;
+    }
+
+    case MailboxOverflowPolicy::REJECT:
+    default:
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return ErrorCode::BN_RECV_BUFF_OVERFLOW;
+    }
+}
+
+bool ModuleMailbox::TryPop(ModuleEvent& event)
+{
+    if (TryPopRing_(event)) {
+        popped_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    // 主队列中的事件都早于二级队列中的事件，主队列取空后再消费二级队列；
+    // 若主队列还有已占位但尚未写完的槽位，需等它写完，否则同一生产者的事件可能乱序
+    if (spill_size_.load(std::memory_order_acquire) == 0 ||
+        tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    if (spill_queue_.empty()) {
+        return false;
+    }
+    event = std::move(spill_queue_.front());
+    spill_queue_.pop_front();
+    spill_size_.fetch_sub(1, std::memory_order_release);
+    popped_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+uint64_t ModuleMailbox::Depth() const
+{
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t ring_depth = tail > head ? tail - head : 0;
+    return ring_depth + spill_size_.load(std::memory_order_relaxed);
+}
+
+MailboxQueueStats ModuleMailbox::GetStats() const
+{
+    MailboxQueueStats stats;
+    stats.pushed = pushed_.load(std::memory_order_relaxed);
+    stats.popped = popped_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.spilled = spilled_.load(std::memory_order_relaxed);
+    stats.blocked = blocked_.load(std::memory_order_relaxed);
+    stats.block_timeouts = block_timeouts_.load(std::memory_order_relaxed);
+    stats.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+    stats.spill_high_water_mark = spill_high_water_mark_.load(std::memory_order_relaxed);
+    stats.allocated_chunks = allocated_chunks_.load(std::memory_order_relaxed);
+    stats.chunk_allocs = chunk_allocs_.load(std::memory_order_relaxed);
+    stats.chunk_releases = chunk_releases_.load(std::memory_order_relaxed);
+    stats.memory_bytes = stats.allocated_chunks * chunk_size_ * sizeof(Cell)
+                       + chunk_count_ * sizeof(std::atomic<Cell*>)
+                       + spill_size_.load(std::memory_order_relaxed) * sizeof(ModuleEvent);
+    return stats;
+}
+
+void ModuleMailbox::Trim()
+{
+    if (!chunks_ || options_.release_idle_ms == 0) {
+        return;
+    }
+    if (!Empty()) {
+        idle_since_ns_ = 0;
+        return;
+    }
+    if (allocated_chunks_.load(std::memory_order_relaxed) <= 1) {
+        return;
+    }
+    int64_t now_ns = ModuleReactor::NowNs();
+    if (idle_since_ns_ == 0) {
+        idle_since_ns_ = now_ns;
+        return;
+    }
+    if (now_ns - idle_since_ns_ < static_cast<int64_t>(options_.release_idle_ms) * 1000000LL) {
+        return;
+    }
+
+    // 只有没有生产者正在访问主队列时才能归还块，否则下次再试
+    uint64_t expected = 0;
+    if (!guard_.compare_exchange_strong(expected, kTrimFlag, std::memory_order_acq_rel)) {
+        return;
+    }
+    ReleaseChunks_();
+    guard_.fetch_sub(kTrimFlag, std::memory_order_acq_rel);
+    idle_since_ns_ = now_ns;
+}
+
+ModuleMailbox::Cell* ModuleMailbox::GetCell_(uint64_t pos, bool allocate)
+{
+    uint64_t index = pos & mask_;
+    std::atomic<Cell*>& slot = chunks_[index >> chunk_shift_];
+    Cell* chunk = slot.load(std::memory_order_acquire);
+    if (!chunk) {
+        if (!allocate) {
+            return nullptr;
+        }
+        // 多个生产者可能同时分配同一个块，只有一个能装入目录，其余释放自己分配的块
+        Cell* fresh = AllocateChunk_(pos - (index & chunk_mask_));
+        if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunk = fresh;
+            allocated_chunks_.fetch_add(1, std::memory_order_relaxed);
+            chunk_allocs_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            delete[] fresh;
+        }
+    }
+    return &chunk[index & chunk_mask_];
+}
+
+// 块内槽位的序号从块的起始位置开始编号：块只会在邮箱为空时被归还，且不归还读写位置所在的块，
+// 因此重新分配时该块的所有槽位一定属于同一圈
+ModuleMailbox::Cell* ModuleMailbox::AllocateChunk_(uint64_t base_pos)
+{
+    Cell* chunk = new Cell[chunk_size_];
+    for (uint64_t i = 0; i < chunk_size_; ++i) {
+        chunk[i].sequence.store(base_pos + i, std::memory_order_relaxed);
+    }
+    return chunk;
+}
+
+// 调用方已持有 kTrimFlag，此时没有生产者在访问主队列
+void ModuleMailbox::ReleaseChunks_()
+{
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) != head) {
+        return;
+    }
+    uint64_t keep = (head & mask_) >> chunk_shift_;
+    uint64_t released = 0;
+    for (uint64_t i = 0; i < chunk_count_; ++i) {
+        if (i == keep) {
+            continue;
+        }
+        Cell* chunk = chunks_[i].exchange(nullptr, std::memory_order_acq_rel);
+        if (chunk) {
+            delete[] chunk;
+            ++released;
+        }
+    }
+    if (released > 0) {
+        allocated_chunks_.fetch_sub(released, std::memory_order_relaxed);
+        chunk_releases_.fetch_add(released, std::memory_order_relaxed);
+        BaseNodeLogDebug("[ModuleMailbox] Trim: released %lu chunks, remaining: %lu", released, allocated_chunks_.load(std::memory_order_relaxed));
+    }
+}
+
+// 有界 MPSC 环形队列（基于每个槽位的序号）：
+// 槽位 sequence == pos 表示可写，== pos + 1 表示已写入可读，读出后置为 pos + capacity 供下一圈写入
+bool ModuleMailbox::TryPushRing_(ModuleEvent& event)
+{
+    // 进入主队列前登记，消费者归还块期间等待
+    while (guard_.fetch_add(1, std::memory_order_acq_rel) & kTrimFlag) {
+        guard_.fetch_sub(1, std::memory_order_acq_rel);
+        std::this_thread::yield();
+    }
+
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = GetCell_(pos, true);
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            guard_.fetch_sub(1, std::memory_order_acq_rel);
+            return false;  // 队列已满
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    new (cell->storage) ModuleEvent(std::move(event));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    guard_.fetch_sub(1, std::memory_order_acq_rel);
+
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    UpdateHighWater_(high_water_mark_, pos + 1 > head ? pos + 1 - head : 0);
+    return true;
+}
+
+bool ModuleMailbox::TryPopRing_(ModuleEvent& event)
+{
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    Cell* cell = GetCell_(pos, false);
+    if (!cell || cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;  // 队列为空或生产者尚未写完
+    }
+    ModuleEvent* stored = std::launder(reinterpret_cast<ModuleEvent*>(cell->storage));
+    event = std::move(*stored);
+    stored->~ModuleEvent();
+    cell->sequence.store(pos + capacity_, std::memory_order_release);
+    head_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+ErrorCode ModuleMailbox::Spill_(ModuleEvent&& event)
+{
+    uint64_t spill_depth = 0;
+    {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        spill_queue_.push_back(std::move(event));
+        spill_depth = spill_size_.fetch_add(1, std::memory_order_release) + 1;
+    }
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    spilled_.fetch_add(1, std::memory_order_relaxed);
+    UpdateHighWater_(spill_high_water_mark_, spill_depth);
+    return ErrorCode::BN_SUCCESS;
+}
+
+void ModuleMailbox::UpdateHighWater_(std::atomic<uint64_t>& mark, uint64_t depth)
+{
+    uint64_t current = mark.load(std::memory_order_relaxed);
+    while (depth > current && !mark.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {
+    }
+}
+
+void ModulePriorityMailbox::Configure(const MailboxOptions& options)
+{
+    for (uint32_t i = 0; i < MODULE_MAILBOX_LANE_NUM; ++i) {
+        lanes_[i].mailbox.Configure(options);
+        weights_[i] = std::max<uint32_t>(options.lane_weights[i], 1);
+    }
+    current_lane_ = 0;
+    credit_ = weights_[0];
+}
+
+ErrorCode ModulePriorityMailbox::Push(ModuleEvent&& event, RpcPriority priority)
+{
+    uint32_t lane = static_cast<uint32_t>(priority);
+    if (lane >= MODULE_MAILBOX_LANE_NUM) {
+        lane = static_cast<uint32_t>(RpcPriority::NORMAL);
+    }
+    event.enqueue_ns_ = ModuleReactor::NowNs();
+    return lanes_[lane].mailbox.Push(std::move(event));
+}
+
+bool ModulePriorityMailbox::TryPop(ModuleEvent& event)
+{
+    // 最多检查一整轮（回到起始通道时再检查一次，它可能是唯一非空的通道）
+    for (uint32_t attempt = 0; attempt <= MODULE_MAILBOX_LANE_NUM; ++attempt) {
+        if (credit_ == 0) {
+            current_lane_ = (current_lane_ + 1) % MODULE_MAILBOX_LANE_NUM;
+            credit_ = weights_[current_lane_];
+        }
+        Lane& lane = lanes_[current_lane_];
+        if (lane.mailbox.TryPop(event)) {
+            --credit_;
+            uint64_t queue_time_us = static_cast<uint64_t>(std::max<int64_t>(ModuleReactor::NowNs() - event.enqueue_ns_, 0) / 1000);
+            lane.queue_time_sum_us.fetch_add(queue_time_us, std::memory_order_relaxed);
+            if (queue_time_us > lane.queue_time_max_us.load(std::memory_order_relaxed)) {
+                lane.queue_time_max_us.store(queue_time_us, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        credit_ = 0;    // 当前通道已空，放弃剩余配额
+    }
+    return false;
+}
+
+void ModulePriorityMailbox::Trim()
+{
+    for (Lane& lane : lanes_) {
+        lane.mailbox.Trim();
+    }
+}
+
+void ModulePriorityMailbox::BindConsumerThread()
+{
+    for (Lane& lane : lanes_) {
+        lane.mailbox.BindConsumerThread();
+    }
+}
+
+uint64_t ModulePriorityMailbox::Depth() const
+{
+    uint64_t depth = 0;
+    for (const Lane& lane : lanes_) {
+        depth += lane.mailbox.Depth();
+    }
+    return depth;
+}
+
+MailboxQueueStats ModulePriorityMailbox::GetStats() const
+{
+    MailboxQueueStats total;
+    for (const Lane& lane : lanes_) {
+        MailboxQueueStats stats = lane.mailbox.GetStats();
+        total.pushed += stats.pushed;
+        total.popped += stats.popped;
+        total.rejected += stats.rejected;
+        total.spilled += stats.spilled;
+        total.blocked += stats.blocked;
+        total.block_timeouts += stats.block_timeouts;
+        total.high_water_mark = std::max(total.high_water_mark, stats.high_water_mark);
+        total.spill_high_water_mark = std::max(total.spill_high_water_mark, stats.spill_high_water_mark);
+        total.allocated_chunks += stats.allocated_chunks;
+        total.chunk_allocs += stats.chunk_allocs;
+        total.chunk_releases += stats.chunk_releases;
+        total.memory_bytes += stats.memory_bytes;
+    }
+    return total;
+}
+
+MailboxLaneStats ModulePriorityMailbox::GetLaneStats(RpcPriority priority) const
+{
+    MailboxLaneStats stats;
+    uint32_t index = static_cast<uint32_t>(priority);
+    if (index >= MODULE_MAILBOX_LANE_NUM) {
+        return stats;
+    }
+    const Lane& lane = lanes_[index];
+    MailboxQueueStats queue = lane.mailbox.GetStats();
+    stats.pushed = queue.pushed;
+    stats.popped = queue.popped;
+    stats.depth = lane.mailbox.Depth();
+    stats.queue_time_sum_us = lane.queue_time_sum_us.load(std::memory_order_relaxed);
+    stats.queue_time_max_us = lane.queue_time_max_us.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace BaseNode
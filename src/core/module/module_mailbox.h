@@ -0,0 +1,233 @@
+#pragma once
+
+#include "module_event.h"
+#include "module_options.h"
+#include "utils/basenode_def_internal.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 邮箱入队统计
+ */
+struct MailboxQueueStats
+{
+    uint64_t pushed = 0;              // 累计入队事件数
+    uint64_t popped = 0;              // 累计出队事件数
+    uint64_t rejected = 0;            // 因溢出被拒绝的事件数
+    uint64_t spilled = 0;             // 溢出到二级队列的事件数
+    uint64_t blocked = 0;             // 生产者因溢出而等待的次数
+    uint64_t block_timeouts = 0;      // 生产者等待超时的次数
+    uint64_t high_water_mark = 0;     // 主队列深度最高水位
+    uint64_t spill_high_water_mark = 0; // 二级队列深度最高水位
+    uint64_t allocated_chunks = 0;    // 当前已分配的块数
+    uint64_t chunk_allocs = 0;        // 累计分配块的次数
+    uint64_t chunk_releases = 0;      // 累计归还块的次数
+    uint64_t memory_bytes = 0;        // 队列自身占用的内存（块 + 块目录 + 二级队列，不含事件携带的数据）
+};
+
+/**
+ * @brief 邮箱优先级通道统计
+ */
+struct MailboxLaneStats
+{
+    uint64_t pushed = 0;              // 累计入队事件数
+    uint64_t popped = 0;              // 累计出队事件数
+    uint64_t depth = 0;               // 当前积压的事件数
+    uint64_t queue_time_sum_us = 0;   // 累计排队时间（微秒），平均值为 queue_time_sum_us / popped
+    uint64_t queue_time_max_us = 0;   // 最长排队时间（微秒）
+};
+
+/**
+ * @brief 模块邮箱：有界多生产者单消费者（MPSC）无锁队列
+ *
+ * 生产者可以是任意线程（路由回调、网络 IO 线程、ZK watcher 线程等），消费者只能是驱动模块 Update 的线程。
+ * 主队列按 chunk_size 分块，Configure 时只分配块目录，块在生产者第一次写到时才分配，
+ * 最多分配到 capacity；邮箱空闲超过 release_idle_ms 后由消费者归还除当前块以外的所有块。
+ * 生产者侧永远不会执行消费逻辑；队列满时按 MailboxOverflowPolicy 处理：
+ *  - REJECT：直接返回 BN_RECV_BUFF_OVERFLOW
+ *  - SPILL：转存到无界的二级队列（加锁），消费者在主队列取空后继续消费二级队列，保持先后顺序
+ *  - BLOCK：生产者退避等待空位，超过 block_timeout_us 后返回 BN_RECV_BUFF_OVERFLOW；
+ *           若生产者就是消费者线程（模块给自己发消息），等待会死锁，此时退化为 SPILL
+ */
+class ModuleMailbox
+{
+public:
+    ModuleMailbox() = default;
+    ~ModuleMailbox();
+
+    ModuleMailbox(const ModuleMailbox&) = delete;
+    ModuleMailbox& operator=(const ModuleMailbox&) = delete;
+
+    /**
+     * @brief 按配置初始化队列（必须在第一次 Push 之前调用，只能调用一次），此时只分配块目录
+     */
+    void Configure(const MailboxOptions& options);
+
+    /**
+     * @brief 入队（线程安全，任意线程可调用）
+     * @return BN_SUCCESS 或 BN_RECV_BUFF_OVERFLOW
+     */
+    ErrorCode Push(ModuleEvent&& event);
+
+    /**
+     * @brief 出队（只能由消费者线程调用）
+     * @return 是否取到事件
+     */
+    bool TryPop(ModuleEvent& event);
+
+    /**
+     * @brief 邮箱空闲足够久时归还多余的块（只能由消费者线程调用，每次 Update 调用一次即可）
+     */
+    void Trim();
+
+    /**
+     * @brief 记录当前线程为消费者线程，用于 BLOCK 策略下的自投递检测
+     */
+    void BindConsumerThread() { consumer_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed); }
+
+    bool Empty() const { return Depth() == 0; }
+
+    /**
+     * @brief 当前积压的事件数（主队列 + 二级队列，近似值）
+     */
+    uint64_t Depth() const;
+
+    MailboxQueueStats GetStats() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence;
+        alignas(ModuleEvent) unsigned char storage[sizeof(ModuleEvent)];
+    };
+
+    /**
+     * @brief 获取位置 pos 对应的槽位
+     * @param allocate 所在块未分配时是否分配
+     * @return 槽位指针，块未分配且 allocate 为 false 时返回 nullptr
+     */
+    Cell* GetCell_(uint64_t pos, bool allocate);
+    Cell* AllocateChunk_(uint64_t base_pos);
+    void ReleaseChunks_();
+
+    bool TryPushRing_(ModuleEvent& event);
+    bool TryPopRing_(ModuleEvent& event);
+    ErrorCode Spill_(ModuleEvent&& event);
+    void UpdateHighWater_(std::atomic<uint64_t>& mark, uint64_t depth);
+
+private:
+    // guard_ 的最高位：消费者正在归还块，生产者需等待
+    static constexpr uint64_t kTrimFlag = 1ULL << 63;
+
+    MailboxOptions options_;
+    std::atomic<Cell*>* chunks_ = nullptr;   // 块目录，未分配的块为 nullptr
+    uint64_t capacity_ = 0;
+    uint64_t mask_ = 0;
+    uint64_t chunk_count_ = 0;
+    uint64_t chunk_size_ = 0;
+    uint64_t chunk_shift_ = 0;
+    uint64_t chunk_mask_ = 0;
+
+    // 低位为正在访问主队列的生产者数，最高位为 kTrimFlag
+    alignas(64) std::atomic<uint64_t> guard_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};   // 生产者竞争的写位置
+    alignas(64) std::atomic<uint64_t> head_{0};   // 消费者独占的读位置（原子类型仅用于其他线程读取深度）
+
+    // 二级队列（SPILL 策略）
+    std::mutex spill_mutex_;
+    std::deque<ModuleEvent> spill_queue_;
+    std::atomic<uint64_t> spill_size_{0};
+
+    std::atomic<std::thread::id> consumer_thread_{};
+    int64_t idle_since_ns_ = 0;                    // 邮箱开始空闲的时间（仅消费者线程访问）
+
+    // 统计
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> popped_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<uint64_t> blocked_{0};
+    std::atomic<uint64_t> block_timeouts_{0};
+    std::atomic<uint64_t> high_water_mark_{0};
+    std::atomic<uint64_t> spill_high_water_mark_{0};
+    std::atomic<uint64_t> allocated_chunks_{0};
+    std::atomic<uint64_t> chunk_allocs_{0};
+    std::atomic<uint64_t> chunk_releases_{0};
+};
+
+/**
+ * @brief 带优先级通道的模块邮箱
+ *
+ * 每个优先级（RpcPriority）一个 ModuleMailbox，入队时按事件的优先级选择通道，同一通道内保持先后顺序。
+ * 出队按 lane_weights 加权轮转：当前通道连续处理至多 weight 个事件后切换到下一个通道，空通道直接跳过，
+ * 因此高优先级通道的事件最多等待其他通道各一轮的配额，低优先级通道在繁忙时也能按权重得到处理。
+ */
+class ModulePriorityMailbox
+{
+public:
+    /**
+     * @brief 按配置初始化各通道（必须在第一次 Push 之前调用）
+     */
+    void Configure(const MailboxOptions& options);
+
+    /**
+     * @brief 入队（线程安全，任意线程可调用）
+     * @param priority 事件的优先级
+     * @return BN_SUCCESS 或 BN_RECV_BUFF_OVERFLOW
+     */
+    ErrorCode Push(ModuleEvent&& event, RpcPriority priority);
+
+    /**
+     * @brief 按权重从各通道出队（只能由消费者线程调用）
+     * @return 是否取到事件
+     */
+    bool TryPop(ModuleEvent& event);
+
+    /**
+     * @brief 各通道空闲足够久时归还多余的块（只能由消费者线程调用）
+     */
+    void Trim();
+
+    void BindConsumerThread();
+
+    bool Empty() const { return Depth() == 0; }
+
+    /**
+     * @brief 所有通道积压的事件数（近似值）
+     */
+    uint64_t Depth() const;
+
+    /**
+     * @brief 所有通道合计的入队统计（高水位取各通道的最大值）
+     */
+    MailboxQueueStats GetStats() const;
+
+    /**
+     * @brief 单个通道的统计
+     */
+    MailboxLaneStats GetLaneStats(RpcPriority priority) const;
+
+private:
+    struct Lane
+    {
+        ModuleMailbox mailbox;
+        std::atomic<uint64_t> queue_time_sum_us{0};
+        std::atomic<uint64_t> queue_time_max_us{0};
+    };
+
+private:
+    Lane lanes_[MODULE_MAILBOX_LANE_NUM];
+    std::array<uint32_t, MODULE_MAILBOX_LANE_NUM> weights_ = {1, 1, 1};
+    uint32_t current_lane_ = 0;       // 当前轮转到的通道（仅消费者线程访问）
+    uint32_t credit_ = 1;             // 当前通道剩余的配额（仅消费者线程访问）
+};
+
+} // namespace BaseNode
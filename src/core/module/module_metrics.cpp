@@ -0,0 +1,180 @@
+#include "module_metrics.h"
+#include "module_interface.h"
+#include "module_router.h"
+#include "module_rpc_deadline.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace BaseNode
+{
+
+uint32_t LatencyHistogram::BucketOf(uint64_t value_ns)
+{
+    if (value_ns < kSubBuckets) {
+        return static_cast<uint32_t>(value_ns);
+    }
+    uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(value_ns));
+    if (msb >= LATENCY_HISTOGRAM_MAX_BITS) {
+        return kBucketNum - 1;
+    }
+    uint32_t shift = msb - LATENCY_HISTOGRAM_SUB_BITS;
+    return (msb - LATENCY_HISTOGRAM_SUB_BITS + 1) * kSubBuckets + static_cast<uint32_t>((value_ns >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(uint32_t bucket)
+{
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    uint32_t group = bucket / kSubBuckets;
+    uint32_t sub = bucket % kSubBuckets;
+    return static_cast<uint64_t>(kSubBuckets + sub) << (group - 1);
+}
+
+uint64_t LatencyHistogram::Percentile(double quantile) const
+{
+    uint64_t count = Count();
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count));
+    if (rank >= count) {
+        rank = count - 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < kBucketNum; ++bucket) {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen > rank) {
+            if (bucket == kBucketNum - 1) {
+                return MaxNs();
+            }
+            // 取桶的上界，但不超过实际出现过的最大值
+            uint64_t upper = BucketLowerBound(bucket + 1) - 1;
+            uint64_t max_ns = MaxNs();
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return MaxNs();
+}
+
+void ModuleMetrics::Build(const std::vector<uint32_t>& service_ids)
+{
+    services_.clear();
+    services_.reserve(service_ids.size());
+    for (uint32_t service_id : service_ids) {
+        auto metrics = std::make_unique<ServiceMetrics>();
+        metrics->service_id = service_id;
+        services_.emplace(service_id, std::move(metrics));
+    }
+}
+
+namespace
+{
+
+void AppendSummary(std::string& out, const char* name, const std::string& labels, const LatencyHistogram& histogram)
+{
+    static const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+    char line[512];
+    for (double quantile : kQuantiles) {
+        snprintf(line, sizeof(line), "%s{%s,quantile=\"%g\"} %.9f\n",
+                 name, labels.c_str(), quantile, static_cast<double>(histogram.Percentile(quantile)) / 1e9);
+        out += line;
+    }
+    snprintf(line, sizeof(line), "%s_sum{%s} %.9f\n%s_count{%s} %" PRIu64 "\n",
+             name, labels.c_str(), static_cast<double>(histogram.SumNs()) / 1e9, name, labels.c_str(), histogram.Count());
+    out += line;
+}
+
+} // namespace
+
+std::string MetricsExporter::FormatPrometheus()
+{
+    std::string out;
+    out.reserve(16 * 1024);
+    char line[512];
+    std::vector<IModule*> modules = ModuleRouterMgr->GetAllModules();
+
+    out += "# HELP basenode_mailbox_depth Events waiting in the module mailbox lane.\n"
+           "# TYPE basenode_mailbox_depth gauge\n";
+    for (IModule* module : modules) {
+        MailboxStats stats = module->GetMailboxStats();
+        for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+            snprintf(line, sizeof(line), "basenode_mailbox_depth{module=\"%s\",lane=\"%u\"} %" PRIu64 "\n",
+                     module->GetModuleName().c_str(), lane, stats.lanes[lane].depth);
+            out += line;
+        }
+    }
+    out += "# HELP basenode_mailbox_events_total Events drained from the module mailbox lane.\n"
+           "# TYPE basenode_mailbox_events_total counter\n";
+    for (IModule* module : modules) {
+        MailboxStats stats = module->GetMailboxStats();
+        for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+            snprintf(line, sizeof(line), "basenode_mailbox_events_total{module=\"%s\",lane=\"%u\"} %" PRIu64 "\n",
+                     module->GetModuleName().c_str(), lane, stats.lanes[lane].popped);
+            out += line;
+        }
+    }
+    out += "# HELP basenode_mailbox_queue_time_seconds_total Total time events waited in the module mailbox lane.\n"
+           "# TYPE basenode_mailbox_queue_time_seconds_total counter\n";
+    for (IModule* module : modules) {
+        MailboxStats stats = module->GetMailboxStats();
+        for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+            snprintf(line, sizeof(line), "basenode_mailbox_queue_time_seconds_total{module=\"%s\",lane=\"%u\"} %.6f\n",
+                     module->GetModuleName().c_str(), lane, static_cast<double>(stats.lanes[lane].queue_time_sum_us) / 1e6);
+            out += line;
+        }
+    }
+
+    out += "# HELP basenode_service_requests_total Requests dispatched to the service handler.\n"
+           "# TYPE basenode_service_requests_total counter\n";
+    for (IModule* module : modules) {
+        for (const auto& [service_id, metrics] : module->GetMetrics().Services()) {
+            snprintf(line, sizeof(line), "basenode_service_requests_total{module=\"%s\",service=\"%u\"} %" PRIu64 "\n",
+                     module->GetModuleName().c_str(), service_id, metrics->requests.load(std::memory_order_relaxed));
+            out += line;
+        }
+    }
+    out += "# HELP basenode_service_errors_total Failed requests of the service by error code.\n"
+           "# TYPE basenode_service_errors_total counter\n";
+    for (IModule* module : modules) {
+        for (const auto& [service_id, metrics] : module->GetMetrics().Services()) {
+            for (uint32_t code = 0; code < MODULE_METRICS_ERROR_CODE_NUM; ++code) {
+                uint64_t errors = metrics->errors[code].load(std::memory_order_relaxed);
+                if (errors == 0) {
+                    continue;
+                }
+                snprintf(line, sizeof(line), "basenode_service_errors_total{module=\"%s\",service=\"%u\",code=\"%u\"} %" PRIu64 "\n",
+                         module->GetModuleName().c_str(), service_id, code, errors);
+                out += line;
+            }
+        }
+    }
+    out += "# HELP basenode_service_queue_wait_seconds Time from mailbox push to handler start.\n"
+           "# TYPE basenode_service_queue_wait_seconds summary\n";
+    for (IModule* module : modules) {
+        for (const auto& [service_id, metrics] : module->GetMetrics().Services()) {
+            snprintf(line, sizeof(line), "module=\"%s\",service=\"%u\"", module->GetModuleName().c_str(), service_id);
+            AppendSummary(out, "basenode_service_queue_wait_seconds", line, metrics->queue_wait);
+        }
+    }
+    out += "# HELP basenode_service_handler_seconds Synchronous handler execution time.\n"
+           "# TYPE basenode_service_handler_seconds summary\n";
+    for (IModule* module : modules) {
+        for (const auto& [service_id, metrics] : module->GetMetrics().Services()) {
+            snprintf(line, sizeof(line), "module=\"%s\",service=\"%u\"", module->GetModuleName().c_str(), service_id);
+            AppendSummary(out, "basenode_service_handler_seconds", line, metrics->handler_time);
+        }
+    }
+
+    out += "# HELP basenode_rpc_drops_total Requests dropped by the framework.\n"
+           "# TYPE basenode_rpc_drops_total counter\n";
+    for (size_t i = 0; i < static_cast<size_t>(RpcDropReason::COUNT); ++i) {
+        RpcDropReason reason = static_cast<RpcDropReason>(i);
+        snprintf(line, sizeof(line), "basenode_rpc_drops_total{reason=\"%s\"} %" PRIu64 "\n",
+                 RpcDropStats::ReasonName(reason), RpcDropStatsMgr->Get(reason));
+        out += line;
+    }
+    return out;
+}
+
+} // namespace BaseNode
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BaseNode
+{
+
+#define LATENCY_HISTOGRAM_SUB_BITS 3            // 每个 2 的幂区间分 8 个子桶，相对误差约 12.5%
+#define LATENCY_HISTOGRAM_MAX_BITS 40           // 最大可区分约 2^40 纳秒（约 18 分钟），更大的值计入最后一个桶
+#define MODULE_METRICS_ERROR_CODE_NUM 32        // 按错误码计数的错误码个数，更大的错误码计入最后一个
+
+/**
+ * @brief 延迟直方图（HDR 风格的对数-线性分桶，单位纳秒）
+ *
+ * 小于 8 的值每个值一个桶，之后每个 2 的幂区间分 8 个子桶，桶下标只需一次 clz 计算。
+ * 只允许一个线程写入（模块线程），写入不使用原子读改写指令；任意线程可以读取近似一致的快照。
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t kSubBuckets = 1u << LATENCY_HISTOGRAM_SUB_BITS;
+    static constexpr uint32_t kBucketNum = (LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BITS + 1) * kSubBuckets;
+
+    /**
+     * @brief 记录一个值（只能由写线程调用）
+     */
+    void Record(uint64_t value_ns)
+    {
+        Bump_(buckets_[BucketOf(value_ns)], 1);
+        Bump_(count_, 1);
+        Bump_(sum_ns_, value_ns);
+        if (value_ns > max_ns_.load(std::memory_order_relaxed)) {
+            max_ns_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t SumNs() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t MaxNs() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 分位数（纳秒，返回所在桶的上界，没有数据时返回 0）
+     * @param quantile 0~1
+     */
+    uint64_t Percentile(double quantile) const;
+
+    static uint32_t BucketOf(uint64_t value_ns);
+
+    /**
+     * @brief 桶的下界（包含）
+     */
+    static uint64_t BucketLowerBound(uint32_t bucket);
+
+private:
+    static void Bump_(std::atomic<uint64_t>& counter, uint64_t delta)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketNum] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+/**
+ * @brief 单个服务（RPC 函数 key）的运行时指标
+ */
+struct ServiceMetrics
+{
+    uint32_t service_id = 0;
+    std::atomic<uint64_t> requests{0};               // 交给处理函数的请求数（模块线程写）
+    std::atomic<uint64_t> errors[MODULE_METRICS_ERROR_CODE_NUM] = {};   // 按错误码的错误数（任意线程写）
+    LatencyHistogram queue_wait;                     // 入邮箱到开始处理的时间
+    LatencyHistogram handler_time;                   // 处理函数同步执行的时间（协程挂起后的部分不计入）
+
+    /**
+     * @brief 记录一次处理完成的请求（只能由模块线程调用）
+     */
+    void RecordRequest(uint64_t queue_wait_ns, uint64_t handler_ns)
+    {
+        requests.store(requests.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        queue_wait.Record(queue_wait_ns);
+        handler_time.Record(handler_ns);
+    }
+
+    void RecordError(ErrorCode code)
+    {
+        uint32_t index = static_cast<uint32_t>(code);
+        if (index >= MODULE_METRICS_ERROR_CODE_NUM) {
+            index = MODULE_METRICS_ERROR_CODE_NUM - 1;
+        }
+        errors[index].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 模块的运行时指标：服务集合在模块注册到路由前确定，之后只读，查找无需加锁
+ */
+class ModuleMetrics
+{
+public:
+    /**
+     * @brief 按服务键建立指标（只能在模块注册到路由前调用一次）
+     */
+    void Build(const std::vector<uint32_t>& service_ids);
+
+    /**
+     * @brief 查找服务的指标，未知服务返回 nullptr
+     */
+    ServiceMetrics* Find(uint32_t service_id) const
+    {
+        auto it = services_.find(service_id);
+        return it != services_.end() ? it->second.get() : nullptr;
+    }
+
+    const std::unordered_map<uint32_t, std::unique_ptr<ServiceMetrics>>& Services() const { return services_; }
+
+private:
+    std::unordered_map<uint32_t, std::unique_ptr<ServiceMetrics>> services_;
+};
+
+/**
+ * @brief 以 Prometheus 文本格式导出本进程所有模块的指标
+ *
+ * 包括各模块邮箱各优先级通道的深度和排队时间、各服务的请求数、错误数和延迟分位数、RPC 丢弃计数。
+ * 延迟以 summary 导出（分位数 + _sum + _count），请求速率由 Prometheus 按 _total 计数器计算。
+ */
+class MetricsExporter
+{
+public:
+    static std::string FormatPrometheus();
+};
+
+} // namespace BaseNode
@@ -0,0 +1,95 @@
+#include "module_options.h"
+#include "tools/singleton.h"
+#include <algorithm>
+
+namespace BaseNode
+{
+
+void ModuleOptionsRegistry::Load(const nlohmann::json& modules_json)
+{
+    default_options_ = ModuleOptions{};
+    module_options_.clear();
+    if (!modules_json.is_object()) {
+        return;
+    }
+
+    auto default_it = modules_json.find("default");
+    if (default_it != modules_json.end()) {
+        ParseModuleOptions_(*default_it, default_options_);
+    }
+
+    for (auto it = modules_json.begin(); it != modules_json.end(); ++it) {
+        if (it.key() == "default" || !it.value().is_object()) {
+            continue;
+        }
+        ModuleOptions options = default_options_;
+        ParseModuleOptions_(it.value(), options);
+        module_options_[it.key()] = options;
+        BaseNodeLogInfo("[ModuleOptions] module %s: mailbox.max_events_per_tick: %u, mailbox.max_time_us: %u, mailbox.capacity: %u, mailbox.chunk_size: %u, mailbox.overflow_policy: %d",
+                        it.key().c_str(), options.mailbox.max_events_per_tick, options.mailbox.max_time_us,
+                        options.mailbox.capacity, options.mailbox.chunk_size, static_cast<int>(options.mailbox.overflow_policy));
+    }
+}
+
+ModuleOptions ModuleOptionsRegistry::Get(std::string_view module_name) const
+{
+    auto it = module_options_.find(std::string(module_name));
+    if (it != module_options_.end()) {
+        return it->second;
+    }
+    return default_options_;
+}
+
+void ModuleOptionsRegistry::ParseModuleOptions_(const nlohmann::json& json, ModuleOptions& options)
+{
+    auto batch_it = json.find("rpc_batch");
+    if (batch_it != json.end() && batch_it->is_object()) {
+        options.rpc_batch.max_calls = batch_it->value("max_calls", options.rpc_batch.max_calls);
+        options.rpc_batch.max_bytes = batch_it->value("max_bytes", options.rpc_batch.max_bytes);
+        options.rpc_batch.linger_us = batch_it->value("linger_us", options.rpc_batch.linger_us);
+    }
+
+    auto mailbox_it = json.find("mailbox");
+    if (mailbox_it == json.end() || !mailbox_it->is_object()) {
+        return;
+    }
+    const nlohmann::json& mailbox = *mailbox_it;
+    options.mailbox.max_events_per_tick = mailbox.value("max_events_per_tick", options.mailbox.max_events_per_tick);
+    options.mailbox.max_time_us = mailbox.value("max_time_us", options.mailbox.max_time_us);
+    options.mailbox.capacity = mailbox.value("capacity", options.mailbox.capacity);
+    options.mailbox.chunk_size = mailbox.value("chunk_size", options.mailbox.chunk_size);
+    options.mailbox.release_idle_ms = mailbox.value("release_idle_ms", options.mailbox.release_idle_ms);
+    options.mailbox.block_timeout_us = mailbox.value("block_timeout_us", options.mailbox.block_timeout_us);
+    auto weights_it = mailbox.find("lane_weights");
+    if (weights_it != mailbox.end() && weights_it->is_array()) {
+        for (size_t i = 0; i < MODULE_MAILBOX_LANE_NUM && i < weights_it->size(); ++i) {
+            if ((*weights_it)[i].is_number_unsigned()) {
+                // 权重至少为 1，否则该通道永远得不到处理
+                options.mailbox.lane_weights[i] = std::max<uint32_t>((*weights_it)[i].get<uint32_t>(), 1);
+            }
+        }
+    }
+    if (mailbox.contains("overflow_policy")) {
+        std::string policy = mailbox.value("overflow_policy", std::string("reject"));
+        if (policy == "reject") {
+            options.mailbox.overflow_policy = MailboxOverflowPolicy::REJECT;
+        } else if (policy == "spill") {
+            options.mailbox.overflow_policy = MailboxOverflowPolicy::SPILL;
+        } else if (policy == "block") {
+            options.mailbox.overflow_policy = MailboxOverflowPolicy::BLOCK;
+        } else {
+            BaseNodeLogWarn("[ModuleOptions] unknown mailbox.overflow_policy: %s, keep previous value", policy.c_str());
+        }
+    }
+}
+
+} // namespace BaseNode
+
+static BaseNode::ModuleOptionsRegistry* g_module_options_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::ModuleOptionsRegistry* GetModuleOptionsRegistryInstance() {
+    if (!g_module_options_instance) {
+        g_module_options_instance = ToolBox::Singleton<BaseNode::ModuleOptionsRegistry>::Instance();
+    }
+    return g_module_options_instance;
+}
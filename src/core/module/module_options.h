@@ -0,0 +1,116 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include "3rdparty/nlohmann_json/json.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace BaseNode
+{
+
+#define DEFAULT_MODULE_MAILBOX_CAPACITY (256 * 1024)
+#define DEFAULT_MODULE_MAILBOX_CHUNK_SIZE 256
+
+#define MODULE_MAILBOX_LANE_NUM 3       // 邮箱优先级通道数（见 RpcPriority）
+
+/**
+ * @brief 请求优先级，对应邮箱的优先级通道
+ */
+enum class RpcPriority : uint8_t
+{
+    CONTROL = 0,  // 控制类：RPC 回包、小而急的调用
+    NORMAL = 1,   // 普通调用（默认）
+    BULK = 2,     // 大批量：流式传输、批量拉取等
+};
+
+/**
+ * @brief 邮箱满时的处理策略
+ */
+enum class MailboxOverflowPolicy : uint8_t
+{
+    REJECT = 0,   // 拒绝，返回 BN_RECV_BUFF_OVERFLOW
+    SPILL = 1,    // 转存到无界二级队列
+    BLOCK = 2,    // 生产者等待，超时后拒绝
+};
+
+/**
+ * @brief 模块邮箱（接收缓冲区）配置
+ */
+struct MailboxOptions
+{
+    uint32_t max_events_per_tick = 1024;   // 每次 Update 最多处理的事件数
+    uint32_t max_time_us = 2000;           // 每次 Update 处理事件的最长时间（微秒）
+    uint32_t capacity = DEFAULT_MODULE_MAILBOX_CAPACITY;          // 主队列容量上限（向上取整为 2 的幂）
+    uint32_t chunk_size = DEFAULT_MODULE_MAILBOX_CHUNK_SIZE;      // 主队列按块分配，每块的事件槽数（向上取整为 2 的幂）
+    uint32_t release_idle_ms = 5000;       // 邮箱空闲超过该时长后归还多余的块，0 表示不归还
+    MailboxOverflowPolicy overflow_policy = MailboxOverflowPolicy::REJECT;
+    uint32_t block_timeout_us = 1000;      // BLOCK 策略下生产者最长等待时间（微秒）
+    std::array<uint32_t, MODULE_MAILBOX_LANE_NUM> lane_weights = {8, 4, 1};   // 各优先级通道每轮最多连续处理的事件数（加权轮转，低优先级不会饿死）
+};
+
+/**
+ * @brief 批量 RPC 调用（CallModuleServiceBatch）配置
+ */
+struct RpcBatchOptions
+{
+    uint32_t max_calls = 64;               // 单个批量帧最多合并的调用数，达到后立即发送
+    uint32_t max_bytes = 64 * 1024;        // 单个批量帧的最大字节数，达到后立即发送
+    uint32_t linger_us = 0;                // 批量帧最长等待时间（微秒），0 表示在本次 tick 结束时发送
+};
+
+/**
+ * @brief 单个模块的运行时配置
+ */
+struct ModuleOptions
+{
+    MailboxOptions mailbox;
+    RpcBatchOptions rpc_batch;
+};
+
+/**
+ * @brief 模块配置表
+ *
+ * 由主程序在加载插件前从配置文件的 {config_name}.modules 节点载入，模块在 Init 时按模块名读取。
+ * 配置格式：
+ * "modules": {
+ *     "default": { "mailbox": { "max_events_per_tick": 1024, "max_time_us": 2000, "capacity": 262144, "chunk_size": 256, "release_idle_ms": 5000, "overflow_policy": "reject", "lane_weights": [8, 4, 1] } },
+ *     "Guild":   { "mailbox": { "max_events_per_tick": 4096, "overflow_policy": "block", "block_timeout_us": 500 } },
+ *     "Player":  { "rpc_batch": { "max_calls": 256, "max_bytes": 65536, "linger_us": 500 } }
+ * }
+ * 模块级配置只需写出需要覆盖的字段，其余字段继承 default。
+ * overflow_policy 可选值：reject / spill / block。
+ * lane_weights 依次为 control / normal / bulk 通道的权重，每个通道的容量都是 capacity。
+ */
+class ModuleOptionsRegistry
+{
+public:
+    /**
+     * @brief 载入 modules 配置节点
+     * @param modules_json {config_name}.modules 节点
+     */
+    void Load(const nlohmann::json& modules_json);
+
+    /**
+     * @brief 获取模块配置
+     * @param module_name 模块名（见 IModule::GetModuleName）
+     * @return 模块配置（未单独配置的模块返回 default）
+     */
+    ModuleOptions Get(std::string_view module_name) const;
+
+private:
+    static void ParseModuleOptions_(const nlohmann::json& json, ModuleOptions& options);
+
+private:
+    ModuleOptions default_options_;
+    std::unordered_map<std::string, ModuleOptions> module_options_;
+};
+
+} // namespace BaseNode
+
+// 获取模块配置表实例的全局函数（在 basenode_core 中实现）
+extern "C" BaseNode::ModuleOptionsRegistry* GetModuleOptionsRegistryInstance();
+
+#define ModuleOptionsMgr GetModuleOptionsRegistryInstance()
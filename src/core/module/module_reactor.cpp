@@ -0,0 +1,143 @@
+#include "module_reactor.h"
+#include "tools/singleton.h"
+#include <chrono>
+#if !defined(PLATFORM_WINDOWS)
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace BaseNode
+{
+
+ModuleReactor::ModuleReactor()
+{
+#if !defined(PLATFORM_WINDOWS)
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (event_fd_ < 0 || epoll_fd_ < 0) {
+        BaseNodeLogError("[ModuleReactor] create eventfd/epoll failed, errno: %d", errno);
+        return;
+    }
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = event_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev) != 0) {
+        BaseNodeLogError("[ModuleReactor] epoll_ctl add eventfd failed, errno: %d", errno);
+    }
+#endif
+}
+
+ModuleReactor::~ModuleReactor()
+{
+#if !defined(PLATFORM_WINDOWS)
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+        event_fd_ = -1;
+    }
+#endif
+}
+
+void ModuleReactor::Notify()
+{
+    // 已经有未处理的唤醒时直接返回，避免每个事件都产生一次系统调用
+    // 时间戳本身兼作唤醒标记（0 表示没有待处理的唤醒）
+    int64_t expected = 0;
+    if (notify_since_ns_.load(std::memory_order_relaxed) != 0 ||
+        !notify_since_ns_.compare_exchange_strong(expected, NowNs(), std::memory_order_acq_rel)) {
+        return;
+    }
+#if defined(PLATFORM_WINDOWS)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cond_.notify_one();
+#else
+    uint64_t one = 1;
+    ssize_t ret = write(event_fd_, &one, sizeof(one));
+    (void)ret;  // EAGAIN 说明计数器已非零，循环必然会被唤醒
+#endif
+}
+
+bool ModuleReactor::Wait(int64_t timeout_us)
+{
+    if (notify_since_ns_.load(std::memory_order_acquire) == 0 && timeout_us > 0) {
+#if defined(PLATFORM_WINDOWS)
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait_for(lock, std::chrono::microseconds(timeout_us), [this] {
+            return notify_since_ns_.load(std::memory_order_acquire) != 0;
+        });
+#else
+        // epoll 超时精度为毫秒，向上取整保证不会提前返回造成空转
+        int timeout_ms = static_cast<int>((timeout_us + 999) / 1000);
+        struct epoll_event ev {};
+        int n = epoll_wait(epoll_fd_, &ev, 1, timeout_ms);
+        if (n > 0) {
+            // 无论标记是否已被消费都要读空计数器，否则 eventfd 会一直可读导致空转
+            uint64_t value = 0;
+            ssize_t ret = read(event_fd_, &value, sizeof(value));
+            (void)ret;
+        } else if (n < 0 && errno != EINTR) {
+            BaseNodeLogError("[ModuleReactor] epoll_wait failed, errno: %d", errno);
+        }
+#endif
+    }
+    if (notify_since_ns_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    Drain_();
+    return true;
+}
+
+void ModuleReactor::WakeAt(int64_t deadline_ns)
+{
+    if (wake_deadline_ns_ == 0 || deadline_ns < wake_deadline_ns_) {
+        wake_deadline_ns_ = deadline_ns;
+    }
+}
+
+int64_t ModuleReactor::TakeWakeDeadlineNs()
+{
+    int64_t deadline_ns = wake_deadline_ns_;
+    wake_deadline_ns_ = 0;
+    return deadline_ns;
+}
+
+int64_t ModuleReactor::TakeWakeupLatencyUs()
+{
+    if (wakeup_since_ns_ == 0) {
+        return -1;
+    }
+    int64_t latency_us = (NowNs() - wakeup_since_ns_) / 1000;
+    wakeup_since_ns_ = 0;
+    return latency_us;
+}
+
+int64_t ModuleReactor::NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ModuleReactor::Drain_()
+{
+    // 先清除标记再分发：分发期间到达的新事件会重新触发一次唤醒
+    wakeup_since_ns_ = notify_since_ns_.exchange(0, std::memory_order_acq_rel);
+}
+
+} // namespace BaseNode
+
+// 全局单例实例（在 basenode_core 中定义，与 ModuleRouter 相同的导出方式）
+static BaseNode::ModuleReactor* g_module_reactor_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::ModuleReactor* GetModuleReactorInstance() {
+    if (!g_module_reactor_instance) {
+        g_module_reactor_instance = ToolBox::Singleton<BaseNode::ModuleReactor>::Instance();
+    }
+    return g_module_reactor_instance;
+}
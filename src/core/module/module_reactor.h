@@ -0,0 +1,87 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <atomic>
+#include <cstdint>
+#if defined(PLATFORM_WINDOWS)
+    #include <condition_variable>
+    #include <mutex>
+#endif
+
+namespace BaseNode
+{
+
+/**
+ * @brief 模块事件循环唤醒器
+ *
+ * 主循环在两次 tick 之间阻塞在 Wait() 上，PushModuleEvent 等生产者通过 Notify() 立即唤醒，
+ * 避免固定 sleep 带来的延迟；没有事件时线程完全阻塞，不占用 CPU。
+ * Linux 下基于 eventfd + epoll 实现，多次 Notify 会被合并为一次唤醒。
+ */
+class ModuleReactor
+{
+public:
+    ModuleReactor();
+    ~ModuleReactor();
+
+    ModuleReactor(const ModuleReactor&) = delete;
+    ModuleReactor& operator=(const ModuleReactor&) = delete;
+
+    /**
+     * @brief 唤醒等待中的循环（线程安全，可在任意线程调用）
+     */
+    void Notify();
+
+    /**
+     * @brief 阻塞等待唤醒或超时
+     * @param timeout_us 超时时间（微秒），0 表示只检查不阻塞
+     * @return 是否因 Notify 被唤醒
+     */
+    bool Wait(int64_t timeout_us);
+
+    /**
+     * @brief 请求循环最晚在指定时间醒来（模块定时器使用，多次调用取最早的时间；只应由循环线程自己调用）
+     * @param deadline_ns 单调时钟时间（纳秒）
+     */
+    void WakeAt(int64_t deadline_ns);
+
+    /**
+     * @brief 取出并清除请求的最早唤醒时间
+     * @return 唤醒时间（纳秒），没有请求时返回 0
+     */
+    int64_t TakeWakeDeadlineNs();
+
+    /**
+     * @brief 取出最近一次唤醒从 Notify 到被处理的延迟
+     * @return 延迟（微秒），若本轮没有 Notify 返回 -1
+     */
+    int64_t TakeWakeupLatencyUs();
+
+    /**
+     * @brief 获取单调时钟当前时间（纳秒）
+     */
+    static int64_t NowNs();
+
+private:
+    void Drain_();
+
+private:
+    std::atomic<int64_t> notify_since_ns_{0};   // 首次 Notify 的时间戳，非 0 表示有未处理的唤醒
+    int64_t wakeup_since_ns_ = 0;               // 最近一次被唤醒时对应的 Notify 时间戳（仅循环线程访问）
+    int64_t wake_deadline_ns_ = 0;              // 定时器请求的最早唤醒时间，0 表示没有（仅循环线程访问）
+#if defined(PLATFORM_WINDOWS)
+    std::mutex mutex_;
+    std::condition_variable cond_;
+#else
+    int event_fd_ = -1;
+    int epoll_fd_ = -1;
+#endif
+};
+
+} // namespace BaseNode
+
+// 获取主循环 ModuleReactor 实例的全局函数（在 basenode_core 中实现）
+// 使用 extern "C" 确保符号在所有模块间共享
+extern "C" BaseNode::ModuleReactor* GetModuleReactorInstance();
+
+#define ModuleReactorMgr GetModuleReactorInstance()
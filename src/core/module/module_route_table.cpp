@@ -0,0 +1,181 @@
+#include "module_route_table.h"
+#include <limits>
+#include <thread>
+
+namespace BaseNode
+{
+
+void FlatRouteTable::Build(const std::unordered_map<uint32_t, IModule*>& source)
+{
+    entries_.clear();
+    size_ = 0;
+    mask_ = 0;
+    if (source.empty()) {
+        return;
+    }
+
+    uint32_t capacity = 8;
+    while (capacity < source.size() * 2) {
+        capacity <<= 1;
+    }
+    entries_.assign(capacity, Entry{});
+    mask_ = capacity - 1;
+    for (const auto& pair : source) {
+        if (pair.first == 0) {
+            continue;
+        }
+        uint32_t index = Hash_(pair.first) & mask_;
+        while (entries_[index].key != 0) {
+            index = (index + 1) & mask_;
+        }
+        entries_[index].key = pair.first;
+        entries_[index].module = pair.second;
+        ++size_;
+    }
+}
+
+// 每个线程的读者状态，线程退出时归还槽位
+struct RouteReaderThreadState
+{
+    RouteSnapshotDomain* domain = nullptr;
+    int slot = -1;
+    uint32_t depth = 0;
+
+    ~RouteReaderThreadState()
+    {
+        if (domain && slot >= 0) {
+            domain->slots_[slot].epoch.store(0, std::memory_order_release);
+            domain->slots_[slot].in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local RouteReaderThreadState t_route_reader_state;
+
+RouteSnapshotDomain::RouteSnapshotDomain()
+{
+    snapshot_.store(new RouteSnapshot(), std::memory_order_release);
+}
+
+RouteSnapshotDomain::~RouteSnapshotDomain()
+{
+    delete snapshot_.exchange(nullptr, std::memory_order_acq_rel);
+    for (auto& retired : retired_) {
+        delete retired.first;
+    }
+    retired_.clear();
+}
+
+RouteSnapshotDomain::ReadGuard::ReadGuard(RouteSnapshotDomain& domain)
+    : domain_(domain), mode_(domain.Enter_())
+{
+    snapshot_ = domain_.snapshot_.load(std::memory_order_seq_cst);
+}
+
+RouteSnapshotDomain::ReadGuard::~ReadGuard()
+{
+    domain_.Exit_(mode_);
+}
+
+RouteSnapshotDomain::EnterMode RouteSnapshotDomain::Enter_()
+{
+    RouteReaderThreadState& state = t_route_reader_state;
+    if (state.depth > 0) {
+        ++state.depth;
+        return EnterMode::NESTED;
+    }
+    if (!state.domain) {
+        state.domain = this;
+        state.slot = AcquireSlot_();
+    }
+    if (state.domain == this && state.slot >= 0) {
+        // 先登记 epoch 再读快照（均为 seq_cst），与写者的“替换快照 -> 推进 epoch -> 扫描槽位”配对
+        state.depth = 1;
+        slots_[state.slot].epoch.store(global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return EnterMode::SLOT;
+    }
+    overflow_readers_.fetch_add(1, std::memory_order_seq_cst);
+    return EnterMode::SHARED;
+}
+
+void RouteSnapshotDomain::Exit_(EnterMode mode)
+{
+    RouteReaderThreadState& state = t_route_reader_state;
+    switch (mode) {
+    case EnterMode::NESTED:
+        --state.depth;
+        break;
+    case EnterMode::SLOT:
+        state.depth = 0;
+        slots_[state.slot].epoch.store(0, std::memory_order_release);
+        break;
+    case EnterMode::SHARED:
+        overflow_readers_.fetch_sub(1, std::memory_order_release);
+        break;
+    }
+}
+
+int RouteSnapshotDomain::AcquireSlot_()
+{
+    for (int i = 0; i < ROUTE_EPOCH_MAX_READER_SLOTS; ++i) {
+        bool expected = false;
+        if (!slots_[i].in_use.load(std::memory_order_relaxed) &&
+            slots_[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return i;
+        }
+    }
+    BaseNodeLogWarn("[RouteSnapshotDomain] reader slots exhausted (%d), thread falls back to shared counter", ROUTE_EPOCH_MAX_READER_SLOTS);
+    return -1;
+}
+
+uint64_t RouteSnapshotDomain::MinActiveEpoch_() const
+{
+    uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+    for (const ReaderSlot& slot : slots_) {
+        uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < min_epoch) {
+            min_epoch = epoch;
+        }
+    }
+    return min_epoch;
+}
+
+void RouteSnapshotDomain::Publish(RouteSnapshot* snapshot, bool wait_readers)
+{
+    const RouteSnapshot* old = snapshot_.exchange(snapshot, std::memory_order_seq_cst);
+    uint64_t retire_epoch = global_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (old) {
+        retired_.emplace_back(old, retire_epoch);
+    }
+
+    if (wait_readers) {
+        if (t_route_reader_state.depth > 0) {
+            // 在读区内等待自己会死锁，只能放弃等待
+            BaseNodeLogWarn("[RouteSnapshotDomain] Publish: called inside a read section, skip waiting for readers");
+        } else {
+            while (MinActiveEpoch_() <= retire_epoch || overflow_readers_.load(std::memory_order_seq_cst) > 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    Reclaim_();
+}
+
+void RouteSnapshotDomain::Reclaim_()
+{
+    if (retired_.empty() || overflow_readers_.load(std::memory_order_seq_cst) > 0) {
+        return;
+    }
+    uint64_t min_epoch = MinActiveEpoch_();
+    size_t kept = 0;
+    for (auto& retired : retired_) {
+        if (retired.second < min_epoch) {
+            delete retired.first;
+        } else {
+            retired_[kept++] = retired;
+        }
+    }
+    retired_.resize(kept);
+}
+
+} // namespace BaseNode
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BaseNode
+{
+class IModule;
+struct RouteReaderThreadState;
+}
+
+namespace BaseNode
+{
+
+#define ROUTE_EPOCH_MAX_READER_SLOTS 256   // 同时持有读槽位的线程数上限，超出的线程走共享计数
+
+/**
+ * @brief 只读的开放寻址（线性探测）路由表：key -> IModule*
+ *
+ * 构建后不再修改，可被任意线程无锁并发读取。key 为 0 表示空槽（服务ID/模块ID 不会为 0），
+ * 容量为 2 的幂且装载率不超过 50%，查找通常只访问一个缓存行。
+ */
+class FlatRouteTable
+{
+public:
+    void Build(const std::unordered_map<uint32_t, IModule*>& source);
+
+    IModule* Find(uint32_t key) const
+    {
+        if (entries_.empty() || key == 0) {
+            return nullptr;
+        }
+        for (uint32_t index = Hash_(key) & mask_; ; index = (index + 1) & mask_) {
+            const Entry& entry = entries_[index];
+            if (entry.key == key) {
+                return entry.module;
+            }
+            if (entry.key == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    size_t Size() const { return size_; }
+
+private:
+    struct Entry
+    {
+        uint32_t key = 0;
+        IModule* module = nullptr;
+    };
+
+    // 服务ID/模块ID 本身是哈希值，再做一次乘法散列打散低位
+    static uint32_t Hash_(uint32_t key) { return key * 2654435761u; }
+
+private:
+    std::vector<Entry> entries_;
+    uint32_t mask_ = 0;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief 路由快照：一次注册/注销后生成的完整只读路由状态
+ */
+struct RouteSnapshot
+{
+    uint64_t version = 0;
+    FlatRouteTable services;            // 服务ID -> 模块
+    FlatRouteTable modules;             // 模块ID -> 模块
+    IModule* network_module = nullptr;
+    std::vector<IModule*> all_modules;  // 所有模块（包括 Network 模块）
+};
+
+/**
+ * @brief 路由快照的 RCU 发布与回收（基于 epoch）
+ *
+ * 读者进入读区时在自己线程的槽位上登记当前 epoch，离开时清零；写者原子替换快照后把旧快照连同当时的 epoch 放入待回收列表，
+ * 只有所有仍在读区内的读者登记的 epoch 都大于该 epoch 时才释放旧快照。
+ * 读路径只有两次原子写和一次原子读，不加锁；写路径（模块注册/注销）由调用方串行化。
+ * 每个线程第一次读时分配一个读槽位，线程退出时归还；进程内只有 ModuleRouter 一个实例。
+ */
+class RouteSnapshotDomain
+{
+public:
+    RouteSnapshotDomain();
+    ~RouteSnapshotDomain();
+
+    RouteSnapshotDomain(const RouteSnapshotDomain&) = delete;
+    RouteSnapshotDomain& operator=(const RouteSnapshotDomain&) = delete;
+
+    // 进入读区的方式：嵌套进入（不做任何事）/ 使用本线程的槽位 / 使用共享计数
+    enum class EnterMode : uint8_t { NESTED, SLOT, SHARED };
+
+    /**
+     * @brief 读区守卫：生命周期内读到的快照（及快照中的模块指针）保证不会被回收
+     */
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(RouteSnapshotDomain& domain);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const RouteSnapshot* operator->() const { return snapshot_; }
+        const RouteSnapshot& operator*() const { return *snapshot_; }
+
+    private:
+        RouteSnapshotDomain& domain_;
+        EnterMode mode_;
+        const RouteSnapshot* snapshot_ = nullptr;
+    };
+
+    /**
+     * @brief 发布新快照并回收可以回收的旧快照（调用方需保证写者串行）
+     * @param wait_readers 是否等待所有旧读者离开读区（注销模块时需要，确保返回后不再有线程使用被注销的模块）
+     */
+    void Publish(RouteSnapshot* snapshot, bool wait_readers);
+
+    /**
+     * @brief 已替换但还有读者可能在用、尚未释放的旧快照数（仅写者调用）
+     */
+    size_t RetiredCount() const { return retired_.size(); }
+
+private:
+    friend struct RouteReaderThreadState;
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> epoch{0};    // 0 表示不在读区
+        std::atomic<bool> in_use{false};
+    };
+
+    EnterMode Enter_();
+    void Exit_(EnterMode mode);
+    int AcquireSlot_();
+    uint64_t MinActiveEpoch_() const;
+    void Reclaim_();
+
+private:
+    std::atomic<const RouteSnapshot*> snapshot_{nullptr};
+    std::atomic<uint64_t> global_epoch_{1};
+    ReaderSlot slots_[ROUTE_EPOCH_MAX_READER_SLOTS];
+    std::atomic<uint64_t> overflow_readers_{0};   // 没有分到槽位的读者数，非 0 时推迟回收
+    std::vector<std::pair<const RouteSnapshot*, uint64_t>> retired_;   // 待回收的旧快照及其退休 epoch（仅写者访问）
+};
+
+} // namespace BaseNode
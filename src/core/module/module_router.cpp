@@ -1,12 +1,13 @@
 #include "module_router.h"
 #include "module_event.h"
 #include "module_interface.h"
+#include "module_rpc_batch.h"
 #include "utils/basenode_def_internal.h"
 #include "tools/string_util.h"
+#include "plugin_system/plugin_descriptor.h"
 #include <cstdint>
 #include <string>
 #include <string_view>
-#include <tuple>
 
 namespace BaseNode
 {
@@ -18,6 +19,8 @@ ErrorCode ModuleRouter::RegisterModule(IModule* module,  bool is_network_module
         return ErrorCode::BN_INVALID_ARGUMENTS;
     }
 
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
     // 获取模块ID
     uint32_t module_id = module->GetModuleId();
     
@@ -83,6 +86,7 @@ ErrorCode ModuleRouter::RegisterModule(IModule* module,  bool is_network_module
             module_id, module->GetModuleClassName().c_str(), service_ids.size(), ToolBox::VectorToStr(service_ids).c_str());
     }
 
+    PublishSnapshot_(false);
     return ErrorCode::BN_SUCCESS;
 }
 
@@ -92,6 +96,8 @@ ErrorCode ModuleRouter::UnregisterModule(IModule* module)
         return ErrorCode::BN_INVALID_ARGUMENTS;
     }
 
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
     uint32_t module_id = module->GetModuleId();
     
     // 移除服务ID映射
@@ -106,6 +112,12 @@ ErrorCode ModuleRouter::UnregisterModule(IModule* module)
 
     // 移除模块ID映射
     module_id_to_module_.erase(module_id);
+    if (network_module_ == module) {
+        network_module_ = nullptr;
+    }
+
+    // 等待仍在使用旧快照的路由线程结束，返回后模块不会再收到事件
+    PublishSnapshot_(true);
     
     BaseNodeLogInfo("[ModuleRouter] UnregisterModule: module (id: %u) unregistered", module_id);
 
@@ -114,10 +126,16 @@ ErrorCode ModuleRouter::UnregisterModule(IModule* module)
 
 ErrorCode ModuleRouter::CallAllModulesAfterInit()
 {
-    BaseNodeLogInfo("[ModuleRouter] CallAllModulesAfterInit: calling AfterAllModulesInit for %zu modules", module_id_to_module_.size());
+    // 复制一份再回调，回调中可能注册/注销模块
+    std::unordered_map<uint32_t, IModule*> modules;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        modules = module_id_to_module_;
+    }
+    BaseNodeLogInfo("[ModuleRouter] CallAllModulesAfterInit: calling AfterAllModulesInit for %zu modules", modules.size());
     
     ErrorCode first_error = ErrorCode::BN_SUCCESS;
-    for (const auto &pair : module_id_to_module_)
+    for (const auto &pair : modules)
     {
         IModule *module = pair.second;
         if (!module)
@@ -136,39 +154,68 @@ ErrorCode ModuleRouter::CallAllModulesAfterInit()
         }
     }
     
-    BaseNodeLogInfo("[ModuleRouter] CallAllModulesAfterInit: completed, %zu modules processed", module_id_to_module_.size());
+    BaseNodeLogInfo("[ModuleRouter] CallAllModulesAfterInit: completed, %zu modules processed", modules.size());
     return first_error;
 }
 
-IModule* ModuleRouter::FindModuleByServiceId(uint32_t service_id) const
+IModule* ModuleRouter::GetNetworkModule()
+{
+    RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+    return snapshot->network_module;
+}
+
+std::vector<IModule*> ModuleRouter::GetAllModules()
 {
-    BaseNodeLogTrace("[ModuleRouter] FindModuleByServiceId: this=%p, service_id=%u, service_id_to_module_ size=%zu", 
-        this, service_id, service_id_to_module_.size());
-    auto it = service_id_to_module_.find(service_id);
-    if (it != service_id_to_module_.end()) {
-        return it->second;
+    RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+    return snapshot->all_modules;
+}
+
+IModule* ModuleRouter::FindModuleByServiceId(const RouteSnapshot& snapshot, uint32_t service_id) const
+{
+    BaseNodeLogTrace("[ModuleRouter] FindModuleByServiceId: this=%p, service_id=%u, snapshot version=%lu, services size=%zu", 
+        this, service_id, snapshot.version, snapshot.services.Size());
+    IModule* module = snapshot.services.Find(service_id);
+    if (module) {
+        return module;
     }
-    BaseNodeLogError("[ModuleRouter] FindModuleByServiceId: service_id %u not found in any module, service_id_to_module_ size: %zu", service_id, service_id_to_module_.size());
+    BaseNodeLogError("[ModuleRouter] FindModuleByServiceId: service_id %u not found in any module, services size: %zu", service_id, snapshot.services.Size());
     return nullptr;
 }
 
-IModule* ModuleRouter::FindModuleByModuleId(uint32_t module_id) const
+IModule* ModuleRouter::FindModuleByModuleId(const RouteSnapshot& snapshot, uint32_t module_id) const
+{
+    return snapshot.modules.Find(module_id);
+}
+
+void ModuleRouter::PublishSnapshot_(bool wait_readers)
 {
-    auto it = module_id_to_module_.find(module_id);
-    if (it != module_id_to_module_.end()) {
-        return it->second;
+    RouteSnapshot* snapshot = new RouteSnapshot();
+    snapshot->version = ++snapshot_version_;
+    snapshot->services.Build(service_id_to_module_);
+    snapshot->modules.Build(module_id_to_module_);
+    snapshot->network_module = network_module_;
+    snapshot->all_modules.reserve(module_id_to_module_.size() + 1);
+    if (network_module_) {
+        snapshot->all_modules.push_back(network_module_);
     }
-    return nullptr;
+    for (const auto &pair : module_id_to_module_) {
+        if (pair.second && pair.second != network_module_) {
+            snapshot->all_modules.push_back(pair.second);
+        }
+    }
+    route_snapshot_.Publish(snapshot, wait_readers);
+    BaseNodeLogDebug("[ModuleRouter] PublishSnapshot_: version %lu, services: %zu, modules: %zu",
+                     snapshot_version_, service_id_to_module_.size(), module_id_to_module_.size());
 }
 
 ErrorCode ModuleRouter::RouteRpcRequest(std::string &&rpc_data)
 {
-    return RouteRpcData_(std::move(rpc_data), ModuleEvent::EventType::ET_RPC_REQUEST);
+    return RouteRpcData_(BufferSlice::Adopt(std::move(rpc_data)), ModuleEvent::EventType::ET_RPC_REQUEST);
 }
 
 ErrorCode ModuleRouter::RouteRpcResponse(std::string &&rpc_data)
 {
-    return RouteRpcData_(std::move(rpc_data), ModuleEvent::EventType::ET_RPC_RESPONSE);
+    return RouteRpcData_(BufferSlice::Adopt(std::move(rpc_data)), ModuleEvent::EventType::ET_RPC_RESPONSE);
 }
 
 ErrorCode ModuleRouter::RouteProtocolPacket(std::string &&protocol_data)
@@ -177,58 +224,137 @@ ErrorCode ModuleRouter::RouteProtocolPacket(std::string &&protocol_data)
     return RouteRpcRequest(std::move(protocol_data));
 }
 
-std::tuple<uint32_t, uint64_t> ModuleRouter::ExtractServiceIdClientIDFromRpc_(std::string_view rpc_data)
+ErrorCode ModuleRouter::RouteProtocolPacket(BufferSlice &&protocol_data)
 {
-    using namespace ToolBox::CoroRpc;
-    
-    // 读取RPC协议头
-    CoroRpcProtocol::ReqHeader header;
-    Errc err = CoroRpcProtocol::ReadHeader(rpc_data, header);
-    if (err != Errc::SUCCESS) {
-        BaseNodeLogError("[ModuleRouter] ExtractServiceIdClientIDFromRpc_: failed to read header, err: %d", static_cast<int>(err));
-        return std::tuple<uint32_t, uint64_t>(0, 0);;
+    return RouteRpcData_(std::move(protocol_data), ModuleEvent::EventType::ET_RPC_REQUEST);
+}
+
+size_t ModuleRouter::RouteProtocolPackets(std::vector<BufferSlice> &protocol_packets)
+{
+    size_t failed = 0;
+    {
+        // 整批只进入一次读区
+        RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+        for (BufferSlice &packet : protocol_packets) {
+            if (RouteRpcData_(*snapshot, std::move(packet), ModuleEvent::EventType::ET_RPC_REQUEST) != ErrorCode::BN_SUCCESS) {
+                ++failed;
+            }
+        }
+    }
+    protocol_packets.clear();
+    return failed;
+}
+
+ErrorCode ModuleRouter::RouteRpcBatch(uint32_t service_id, uint64_t client_id, int64_t deadline_ms, uint32_t calls, std::string &&batch)
+{
+    ModuleEvent event;
+    event.type_ = ModuleEvent::EventType::ET_RPC_BATCH_REQUEST;
+    event.envelope_.service_id = service_id;
+    event.envelope_.client_id = client_id;
+    event.envelope_.deadline_ms = deadline_ms;
+    event.envelope_.valid = true;
+    // 整批都已过期时不再投递，部分过期的请求由目标模块分发时逐个丢弃
+    if (event.envelope_.Expired()) {
+        RpcDropStatsMgr->Record(RpcDropReason::DEADLINE_AT_ROUTER, calls);
+        BaseNodeLogDebug("[ModuleRouter] RouteRpcBatch: drop expired batch, service_id: %u, calls: %u, deadline_ms: %ld",
+                         service_id, calls, deadline_ms);
+        return ErrorCode::BN_RPC_DEADLINE_EXCEEDED;
+    }
+    event.payload_ = BufferSlice::Adopt(std::move(batch));
+
+    {
+        // 读区覆盖查找和投递，期间模块不会被注销
+        RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+        IModule* module = snapshot->services.Find(service_id);
+        if (module) {
+            ErrorCode err = module->PushModuleEvent(std::move(event));
+            if (err != ErrorCode::BN_SUCCESS) {
+                BaseNodeLogError("[ModuleRouter] RouteRpcBatch: failed to push batch to module, service_id: %u, calls: %u, error: %d",
+                                 service_id, calls, static_cast<int>(err));
+            }
+            return err;
+        }
+    }
+
+    // 目标不在本进程：远端不识别批量帧，拆成单个请求帧走普通路由（共享同一块缓冲区，不拷贝）
+    std::string_view data = event.payload_.View();
+    size_t offset = 0;
+    std::string_view frame;
+    ErrorCode result = ErrorCode::BN_SUCCESS;
+    while (RpcBatchFrame::Next(data, offset, frame)) {
+        ErrorCode err = RouteRpcData_(event.payload_.Slice(static_cast<size_t>(frame.data() - data.data()), frame.size()),
+                                      ModuleEvent::EventType::ET_RPC_REQUEST);
+        if (err != ErrorCode::BN_SUCCESS && result == ErrorCode::BN_SUCCESS) {
+            result = err;
+        }
+    }
+    return result;
+}
+
+ErrorCode ModuleRouter::PostLocalEvent(uint32_t module_id, ModuleEvent &&module_event)
+{
+    // 读区覆盖查找和投递，期间模块不会被注销
+    RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+    IModule* module = FindModuleByModuleId(*snapshot, module_id);
+    if (!module) {
+        return ErrorCode::BN_MODULE_NOT_LOCAL;
+    }
+    ErrorCode err = module->PushModuleEvent(std::move(module_event));
+    if (err != ErrorCode::BN_SUCCESS) {
+        BaseNodeLogError("[ModuleRouter] PostLocalEvent: failed to push event to module %u, error: %d", module_id, static_cast<int>(err));
     }
+    return err;
+}
 
-    // 从协议头中提取服务ID
-    uint32_t service_id = CoroRpcProtocol::GetRpcFuncKey(header);
-    uint64_t client_id = CoroRpcProtocol::GetClientID(header);
-    return std::tuple<uint32_t, uint64_t>(service_id, client_id);
+ErrorCode ModuleRouter::RouteRpcData_(BufferSlice &&rpc_data, ModuleEvent::EventType event_type)
+{
+    // 读区覆盖查找和投递，期间模块不会被注销
+    RouteSnapshotDomain::ReadGuard snapshot(route_snapshot_);
+    return RouteRpcData_(*snapshot, std::move(rpc_data), event_type);
 }
 
-ErrorCode ModuleRouter::RouteRpcData_(std::string &&rpc_data, ModuleEvent::EventType event_type)
+ErrorCode ModuleRouter::RouteRpcData_(const RouteSnapshot &snapshot, BufferSlice &&rpc_data, ModuleEvent::EventType event_type)
 {
-    auto [service_id, client_id] = ExtractServiceIdClientIDFromRpc_(std::string_view(rpc_data));
-    if (service_id == 0 || client_id == 0) {
+    // 协议头只在这里解析一次，结果随事件一起投递
+    ModuleEvent event;
+    if (RpcEnvelope::Parse(rpc_data.View(), event.envelope_) != ErrorCode::BN_SUCCESS ||
+        event.envelope_.service_id == 0 || event.envelope_.client_id == 0) {
         BaseNodeLogError("[ModuleRouter] RouteRpcRequest: failed to extract service_id from RPC data");
         return ErrorCode::BN_INVALID_ARGUMENTS;
     }
 
+    // 调用方已经放弃的请求不再投递
+    if (event_type == ModuleEvent::EventType::ET_RPC_REQUEST && event.envelope_.Expired()) {
+        RpcDropStatsMgr->Record(RpcDropReason::DEADLINE_AT_ROUTER);
+        BaseNodeLogDebug("[ModuleRouter] RouteRpcData: drop expired request, service_id: %u, request_id: %u, deadline_ms: %ld",
+                         event.envelope_.service_id, event.envelope_.request_id, event.envelope_.deadline_ms);
+        return ErrorCode::BN_RPC_DEADLINE_EXCEEDED;
+    }
+
     uint32_t module_service_id = 0;
     IModule* module = nullptr;
-    ModuleEvent event;
     event.type_ = event_type;
+    event.payload_ = std::move(rpc_data);
     if (event_type == ModuleEvent::EventType::ET_RPC_REQUEST) {
-        event.data_.rpc_request_.rpc_req_data_ = std::move(rpc_data);
-        module_service_id = service_id;
-        module = FindModuleByServiceId(module_service_id);
+        module_service_id = event.envelope_.service_id;
+        module = FindModuleByServiceId(snapshot, module_service_id);
     } else if (event_type == ModuleEvent::EventType::ET_RPC_RESPONSE) {
-        event.data_.rpc_rsponse_.rpc_rsp_data_ = std::move(rpc_data);
-        module_service_id = client_id;
-        module = FindModuleByModuleId(module_service_id);
+        module_service_id = static_cast<uint32_t>(event.envelope_.client_id);
+        module = FindModuleByModuleId(snapshot, module_service_id);
     }
 
     // 查找对应的模块
 
     if (!module) {
-        if (network_module_) 
+        if (snapshot.network_module) 
         {
-            ErrorCode err = network_module_->PushModuleEvent(std::move(event));
+            ErrorCode err = snapshot.network_module->PushModuleEvent(std::move(event));
             if (err != ErrorCode::BN_SUCCESS) {
-                BaseNodeLogError("[ModuleRouter] RouteRpcData(type:%d): failed to push event to network module, error: %d", event_type, static_cast<int>(err));
+                BaseNodeLogError("[ModuleRouter] RouteRpcData(type:%d): failed to push event to network module, error: %d", static_cast<int>(event_type), static_cast<int>(err));
                 return err;
             }
         }
-        BaseNodeLogError("[ModuleRouter] RouteRpcData(type:%d): module_service_id %u not found in any module", event_type, module_service_id);
+        BaseNodeLogError("[ModuleRouter] RouteRpcData(type:%d): module_service_id %u not found in any module", static_cast<int>(event_type), module_service_id);
         return ErrorCode::BN_SERVICE_ID_NOT_FOUND;
     }
 
@@ -239,7 +365,7 @@ ErrorCode ModuleRouter::RouteRpcData_(std::string &&rpc_data, ModuleEvent::Event
     }
 
     BaseNodeLogTrace("[ModuleRouter] RouteRpcData(type:%d): routed module_service_id %u to module_id %u", 
-                    event_type, module_service_id, module->GetModuleId());
+                    static_cast<int>(event_type), module_service_id, module->GetModuleId());
 
     return ErrorCode::BN_SUCCESS;
 }
@@ -261,14 +387,5 @@ extern "C" SO_EXPORT_SYMBOL BaseNode::ModuleRouter* GetModuleRouterInstance() {
     return g_module_router_instance;
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT() {
-    // ModuleRouterMgr->Init();
-}
-
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
-    // ModuleRouterMgr->Update();
-}
-
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT() {
-    // ModuleRouterMgr->UnInit();  // 调用基类的UnInit方法
-}
\ No newline at end of file
+// 插件描述符：核心库没有需要每次 tick 调用的逻辑，入口都为空
+BASENODE_PLUGIN_DESCRIPTOR("basenode_core", "1.0.0", nullptr, nullptr, nullptr, nullptr)
@@ -3,8 +3,9 @@
 #include "tools/singleton.h"
 #include "utils/basenode_def_internal.h"
 #include "module_event.h"
+#include "module_route_table.h"
 #include <cstdint>
-#include <tuple>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <string_view>
@@ -19,6 +20,10 @@ namespace BaseNode
 /**
  * @brief 模块路由管理器
  * 负责维护服务ID到模块的映射，并提供路由功能
+ *
+ * 路由可能发生在网络线程、ZK 回调线程和主循环线程上，而模块注册/注销发生在插件加载/卸载时。
+ * 注册表（unordered_map）只在写锁内修改，每次修改后生成一份只读的开放寻址路由快照并原子发布（RCU），
+ * 路由查找只读快照，无锁；注销模块时等待所有旧读者离开后才返回，之后模块可以安全析构。
  */
 class ModuleRouter
 {
@@ -43,6 +48,40 @@ public:
      */
     ErrorCode RouteProtocolPacket(std::string &&protocol_data);
 
+    /**
+     * @brief 路由网络协议包到对应的模块（网络层直接填充的缓冲池切片，全程不拷贝）
+     * @param protocol_data 协议数据包
+     * @return 是否成功路由
+     */
+    ErrorCode RouteProtocolPacket(BufferSlice &&protocol_data);
+
+    /**
+     * @brief 批量路由网络协议包（网络层一轮收到的全部帧），整批只进入一次路由快照读区
+     * @param protocol_packets 协议数据包，路由后清空
+     * @return 路由失败的包数
+     */
+    size_t RouteProtocolPackets(std::vector<BufferSlice> &protocol_packets);
+
+    /**
+     * @brief 路由批量请求（CallModuleServiceBatch 聚合的同一服务的多个请求帧）
+     * 目标模块在本进程时整批作为一个事件投递；不在本进程时拆成单个请求帧，按普通请求交给网络模块转发
+     * @param service_id 服务ID
+     * @param client_id 发起调用的模块ID
+     * @param deadline_ms 各请求截止时间的最大值，0 表示没有
+     * @param calls 请求帧个数
+     * @param batch 批量帧（见 RpcBatchFrame）
+     * @return 错误码
+     */
+    ErrorCode RouteRpcBatch(uint32_t service_id, uint64_t client_id, int64_t deadline_ms, uint32_t calls, std::string &&batch);
+
+    /**
+     * @brief 把事件直接投递给本进程内的模块（进程内直接调用用，不解析协议头）
+     * @param module_id 目标模块ID
+     * @param module_event 事件
+     * @return BN_MODULE_NOT_LOCAL 表示目标模块不在本进程，调用方应改走 RPC
+     */
+    ErrorCode PostLocalEvent(uint32_t module_id, ModuleEvent &&module_event);
+
     /**
      * @brief 调用所有已注册模块的 AfterAllModulesInit
      * 在所有模块 Init 完成后调用，用于模块间的后置初始化
@@ -54,23 +93,31 @@ public:
      * @brief 获取 Network 模块
      * @return Network 模块指针，如果未找到返回 nullptr
      */
-    IModule* GetNetworkModule() const { return network_module_; }
+    IModule* GetNetworkModule();
+
+    /**
+     * @brief 获取所有已注册的模块（包括 Network 模块），用于统计
+     * @return 模块指针列表
+     */
+    std::vector<IModule*> GetAllModules();
 
 private:
 
     /**
      * @brief 根据服务ID查找对应的模块
+     * @param snapshot 当前路由快照
      * @param service_id 服务ID
      * @return 模块指针，如果未找到返回nullptr
      */
-    IModule* FindModuleByServiceId(uint32_t service_id) const;
+    IModule* FindModuleByServiceId(const RouteSnapshot& snapshot, uint32_t service_id) const;
 
     /**
      * @brief 根据模块ID查找模块
+     * @param snapshot 当前路由快照
      * @param module_id 模块ID
      * @return 模块指针，如果未找到返回nullptr
      */
-    IModule* FindModuleByModuleId(uint32_t module_id) const;
+    IModule* FindModuleByModuleId(const RouteSnapshot& snapshot, uint32_t module_id) const;
 
     /**
      * @brief 路由RPC请求到对应的模块
@@ -87,18 +134,21 @@ private:
 
 
 private:
+     ErrorCode RouteRpcData_(BufferSlice &&rpc_data, ModuleEvent::EventType event_type);
+     ErrorCode RouteRpcData_(const RouteSnapshot &snapshot, BufferSlice &&rpc_data, ModuleEvent::EventType event_type);
+
     /**
-     * @brief 从RPC数据包中提取服务ID
-     * @param rpc_data RPC数据包
-     * @return 服务ID，如果提取失败返回0
+     * @brief 根据注册表生成新的路由快照并发布（调用方需持有 write_mutex_）
+     * @param wait_readers 是否等待旧读者离开读区
      */
-     std::tuple<uint32_t, uint64_t> ExtractServiceIdClientIDFromRpc_(std::string_view rpc_data);
-
-     ErrorCode RouteRpcData_(std::string &&rpc_data, ModuleEvent::EventType event_type);
+     void PublishSnapshot_(bool wait_readers);
 
 
 
 private:
+    // 写锁：保护以下注册表，串行化快照发布
+    std::mutex write_mutex_;
+
     // 服务ID到模块的映射表
     std::unordered_map<uint32_t, IModule*> service_id_to_module_;
     
@@ -106,6 +156,10 @@ private:
     std::unordered_map<uint32_t, IModule*> module_id_to_module_;
 
     IModule* network_module_ = nullptr;
+
+    // 路由快照（读路径只访问这里）
+    RouteSnapshotDomain route_snapshot_;
+    uint64_t snapshot_version_ = 0;
 };
 
 } // namespace BaseNode
@@ -0,0 +1,129 @@
+#include "module_rpc_batch.h"
+#include "module_reactor.h"
+#include "module_router.h"
+#include <algorithm>
+
+namespace BaseNode
+{
+
+void RpcBatchFrame::Append(std::string& batch, std::string_view frame)
+{
+    uint32_t length = static_cast<uint32_t>(frame.size());
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        batch.push_back(static_cast<char>((length >> (8 * i)) & 0xFF));
+    }
+    batch.append(frame);
+}
+
+bool RpcBatchFrame::Next(std::string_view batch, size_t& offset, std::string_view& frame)
+{
+    if (offset + sizeof(uint32_t) > batch.size()) {
+        return false;
+    }
+    uint32_t length = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        length |= static_cast<uint32_t>(static_cast<uint8_t>(batch[offset + i])) << (8 * i);
+    }
+    if (offset + sizeof(uint32_t) + length > batch.size()) {
+        BaseNodeLogError("[RpcBatchFrame] truncated batch, offset: %zu, length: %u, size: %zu", offset, length, batch.size());
+        return false;
+    }
+    frame = batch.substr(offset + sizeof(uint32_t), length);
+    offset += sizeof(uint32_t) + length;
+    return true;
+}
+
+void ModuleRpcBatcher::Add(const RpcEnvelope& envelope, std::string_view frame)
+{
+    PendingBatch& batch = pending_[envelope.service_id];
+    if (batch.calls == 0) {
+        // 按本次请求的大小估算整批的容量，避免逐次扩容
+        batch.data.reserve(std::min<size_t>(options_.max_bytes, (frame.size() + sizeof(uint32_t)) * std::max<uint32_t>(options_.max_calls, 1)));
+        batch.client_id = envelope.client_id;
+        batch.first_ns = ModuleReactor::NowNs();
+        ++pending_batches_;
+    }
+    RpcBatchFrame::Append(batch.data, frame);
+    ++batch.calls;
+    if (envelope.deadline_ms <= 0) {
+        batch.no_deadline = true;
+    } else {
+        batch.deadline_ms = std::max(batch.deadline_ms, envelope.deadline_ms);
+    }
+    calls_.fetch_add(1, std::memory_order_relaxed);
+
+    if (batch.calls >= options_.max_calls || batch.data.size() >= options_.max_bytes) {
+        flush_full_.fetch_add(1, std::memory_order_relaxed);
+        Send_(envelope.service_id, batch);
+    }
+}
+
+void ModuleRpcBatcher::Flush(int64_t now_ns)
+{
+    if (pending_batches_ == 0) {
+        return;
+    }
+    const int64_t linger_ns = static_cast<int64_t>(options_.linger_us) * 1000;
+    for (auto& [service_id, batch] : pending_) {
+        if (batch.calls > 0 && now_ns - batch.first_ns >= linger_ns) {
+            flush_linger_.fetch_add(1, std::memory_order_relaxed);
+            Send_(service_id, batch);
+        }
+    }
+}
+
+void ModuleRpcBatcher::FlushAll()
+{
+    if (pending_batches_ == 0) {
+        return;
+    }
+    for (auto& [service_id, batch] : pending_) {
+        if (batch.calls > 0) {
+            flush_linger_.fetch_add(1, std::memory_order_relaxed);
+            Send_(service_id, batch);
+        }
+    }
+}
+
+int64_t ModuleRpcBatcher::NextFlushNs() const
+{
+    if (pending_batches_ == 0) {
+        return -1;
+    }
+    const int64_t linger_ns = static_cast<int64_t>(options_.linger_us) * 1000;
+    int64_t next_ns = -1;
+    for (const auto& [service_id, batch] : pending_) {
+        if (batch.calls > 0 && (next_ns < 0 || batch.first_ns + linger_ns < next_ns)) {
+            next_ns = batch.first_ns + linger_ns;
+        }
+    }
+    return next_ns;
+}
+
+RpcBatchStats ModuleRpcBatcher::GetStats() const
+{
+    RpcBatchStats stats;
+    stats.calls = calls_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.flush_full = flush_full_.load(std::memory_order_relaxed);
+    stats.flush_linger = flush_linger_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ModuleRpcBatcher::Send_(uint32_t service_id, PendingBatch& batch)
+{
+    int64_t deadline_ms = batch.no_deadline ? 0 : batch.deadline_ms;
+    uint32_t calls = batch.calls;
+    ErrorCode err = ModuleRouterMgr->RouteRpcBatch(service_id, batch.client_id, deadline_ms, calls, std::move(batch.data));
+    if (err != ErrorCode::BN_SUCCESS) {
+        BaseNodeLogError("[ModuleRpcBatcher] failed to route batch, service_id: %u, calls: %u, error: %d", service_id, calls, static_cast<int>(err));
+    }
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    batch.data = std::string();
+    batch.calls = 0;
+    batch.deadline_ms = 0;
+    batch.no_deadline = false;
+    --pending_batches_;
+}
+
+} // namespace BaseNode
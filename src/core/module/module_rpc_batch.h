@@ -0,0 +1,110 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include "module_options.h"
+#include "module_rpc_envelope.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 批量请求帧
+ *
+ * 同一服务的多个 RPC 请求帧依次排列，每个请求帧前面是 4 字节小端长度：长度 | 请求帧 | 长度 | 请求帧 ...
+ * 请求帧本身不变（协议头、消息体、附件），服务端逐个交给 RPC 服务器处理，回包仍然逐个返回。
+ */
+class RpcBatchFrame
+{
+public:
+    /**
+     * @brief 追加一个请求帧
+     */
+    static void Append(std::string& batch, std::string_view frame);
+
+    /**
+     * @brief 取出下一个请求帧
+     * @param batch 批量帧
+     * @param offset 读取位置，成功后移到下一个请求帧
+     * @param frame 请求帧（指向 batch 内部）
+     * @return 没有更多请求帧或格式错误时返回 false
+     */
+    static bool Next(std::string_view batch, size_t& offset, std::string_view& frame);
+};
+
+/**
+ * @brief 批量调用统计
+ */
+struct RpcBatchStats
+{
+    uint64_t calls = 0;           // 合并的调用数
+    uint64_t batches = 0;         // 发送的批量帧数
+    uint64_t flush_full = 0;      // 因达到 max_calls / max_bytes 发送的次数
+    uint64_t flush_linger = 0;    // 因等待时间到达（或 tick 结束）发送的次数
+};
+
+/**
+ * @brief 批量调用的发送端聚合器（只在模块线程上访问，统计可以在任意线程读取）
+ *
+ * CallModuleServiceBatch 发出的请求帧按服务ID聚合，同一服务的请求合并成一个批量帧，
+ * 经 ModuleRouter 只做一次查找、一次入队、一次唤醒。批量帧在达到 max_calls / max_bytes 时立即发送，
+ * 否则在 linger_us 到期时发送（linger_us 为 0 时在本次 tick 结束时发送）。
+ */
+class ModuleRpcBatcher
+{
+public:
+    void Configure(const RpcBatchOptions& options) { options_ = options; }
+
+    /**
+     * @brief 加入一个请求帧
+     * @param envelope 请求帧的协议头
+     * @param frame 请求帧
+     */
+    void Add(const RpcEnvelope& envelope, std::string_view frame);
+
+    /**
+     * @brief 发送等待时间已到的批量帧（linger_us 为 0 时发送全部）
+     * @param now_ns 单调时钟当前时间（见 ModuleReactor::NowNs）
+     */
+    void Flush(int64_t now_ns);
+
+    /**
+     * @brief 发送全部批量帧
+     */
+    void FlushAll();
+
+    /**
+     * @brief 下一个批量帧需要发送的时间（纳秒），没有待发送的批量帧时返回 -1
+     */
+    int64_t NextFlushNs() const;
+
+    RpcBatchStats GetStats() const;
+
+private:
+    struct PendingBatch
+    {
+        std::string data;
+        uint64_t client_id = 0;
+        int64_t deadline_ms = 0;      // 各请求截止时间的最大值，有请求没有截止时间时为 0
+        bool no_deadline = false;
+        uint32_t calls = 0;
+        int64_t first_ns = 0;         // 第一个请求加入的时间
+    };
+
+    void Send_(uint32_t service_id, PendingBatch& batch);
+
+private:
+    RpcBatchOptions options_;
+    std::unordered_map<uint32_t, PendingBatch> pending_;    // 服务ID -> 待发送的批量帧
+    size_t pending_batches_ = 0;
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> flush_full_{0};
+    std::atomic<uint64_t> flush_linger_{0};
+};
+
+} // namespace BaseNode
@@ -0,0 +1,214 @@
+#include "module_rpc_deadline.h"
+#include "tools/singleton.h"
+#include <array>
+#include <chrono>
+
+namespace BaseNode
+{
+
+namespace
+{
+
+void AppendU64(std::string& out, uint64_t value)
+{
+    for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint64_t ReadU64(std::string_view data)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+// CRC-16/CCITT（多项式 0x1021）的查找表
+constexpr std::array<uint16_t, 256> MakeCrc16Table()
+{
+    std::array<uint16_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, 256> kCrc16Table = MakeCrc16Table();
+
+uint16_t Crc16(std::string_view data, uint16_t crc = 0xFFFF)
+{
+    for (char c : data) {
+        crc = static_cast<uint16_t>((crc << 8) ^ kCrc16Table[((crc >> 8) ^ static_cast<uint8_t>(c)) & 0xFF]);
+    }
+    return crc;
+}
+
+// 写入元数据头（校验先占位），返回校验字段的位置
+size_t AppendHeader(std::string& out, uint16_t metadata_length)
+{
+    out.push_back(static_cast<char>(RpcMetadata::kMagic0));
+    out.push_back(static_cast<char>(RpcMetadata::kMagic1));
+    out.push_back(static_cast<char>(RpcMetadata::kVersion));
+    out.push_back(static_cast<char>(metadata_length & 0xFF));
+    out.push_back(static_cast<char>(metadata_length >> 8));
+    out.push_back(0);
+    out.push_back(0);
+    return out.size() - 2;
+}
+
+// 校验覆盖版本、长度（头部第 2~4 字节）和 TLV 记录
+uint16_t HeaderChecksum(std::string_view attachment, uint32_t metadata_length)
+{
+    return Crc16(attachment.substr(RpcMetadata::kHeaderSize, metadata_length), Crc16(attachment.substr(2, 3)));
+}
+
+void WriteChecksum(std::string& out, size_t checksum_pos, uint16_t metadata_length)
+{
+    uint16_t checksum = HeaderChecksum(out, metadata_length);
+    out[checksum_pos] = static_cast<char>(checksum & 0xFF);
+    out[checksum_pos + 1] = static_cast<char>(checksum >> 8);
+}
+
+} // namespace
+
+int64_t RpcDeadlineClock::NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string RpcMetadata::Encode(const RpcMetadataFields& fields, std::string_view user_attachment)
+{
+    std::string attachment;
+    const bool has_deadline = fields.deadline_ms > 0;
+    const bool has_flags = fields.flags != 0;
+    const bool has_priority = fields.priority != kNoPriority;
+    const bool has_trace = fields.trace_id != 0;
+    if (!has_deadline && !has_flags && !has_priority && !has_trace) {
+        // 没有元数据时，业务附件本身也可能恰好是一个有效的元数据头，仍然写一个空的元数据头避免误解析
+        if (user_attachment.size() < 2 ||
+            static_cast<uint8_t>(user_attachment[0]) != kMagic0 || static_cast<uint8_t>(user_attachment[1]) != kMagic1) {
+            return std::string(user_attachment);
+        }
+        attachment.reserve(kHeaderSize + user_attachment.size());
+        size_t checksum_pos = AppendHeader(attachment, 0);
+        WriteChecksum(attachment, checksum_pos, 0);
+        attachment.append(user_attachment);
+        return attachment;
+    }
+
+    uint16_t metadata_length = 0;
+    if (has_deadline) {
+        metadata_length += 2 + sizeof(int64_t);
+    }
+    if (has_flags) {
+        metadata_length += 2 + 1;
+    }
+    if (has_priority) {
+        metadata_length += 2 + 1;
+    }
+    if (has_trace) {
+        metadata_length += 2 + 3 * sizeof(uint64_t);
+    }
+    attachment.reserve(kHeaderSize + metadata_length + user_attachment.size());
+    size_t checksum_pos = AppendHeader(attachment, metadata_length);
+    if (has_deadline) {
+        attachment.push_back(static_cast<char>(kTagDeadline));
+        attachment.push_back(static_cast<char>(sizeof(int64_t)));
+        AppendU64(attachment, static_cast<uint64_t>(fields.deadline_ms));
+    }
+    if (has_flags) {
+        attachment.push_back(static_cast<char>(kTagFlags));
+        attachment.push_back(1);
+        attachment.push_back(static_cast<char>(fields.flags));
+    }
+    if (has_priority) {
+        attachment.push_back(static_cast<char>(kTagPriority));
+        attachment.push_back(1);
+        attachment.push_back(static_cast<char>(fields.priority));
+    }
+    if (has_trace) {
+        attachment.push_back(static_cast<char>(kTagTrace));
+        attachment.push_back(static_cast<char>(3 * sizeof(uint64_t)));
+        AppendU64(attachment, fields.trace_id);
+        AppendU64(attachment, fields.span_id);
+        AppendU64(attachment, static_cast<uint64_t>(fields.trace_send_us));
+    }
+    WriteChecksum(attachment, checksum_pos, metadata_length);
+    attachment.append(user_attachment);
+    return attachment;
+}
+
+bool RpcMetadata::Decode(std::string_view attachment, RpcMetadataFields& fields, uint32_t& metadata_length)
+{
+    fields = RpcMetadataFields{};
+    metadata_length = 0;
+    if (attachment.size() < kHeaderSize ||
+        static_cast<uint8_t>(attachment[0]) != kMagic0 || static_cast<uint8_t>(attachment[1]) != kMagic1 ||
+        static_cast<uint8_t>(attachment[2]) != kVersion) {
+        return true;   // 纯业务附件
+    }
+    uint32_t records_length = static_cast<uint8_t>(attachment[3]) | (static_cast<uint32_t>(static_cast<uint8_t>(attachment[4])) << 8);
+    if (records_length > kMaxRecordsLength || kHeaderSize + records_length > attachment.size()) {
+        return true;   // 长度对不上：恰好以魔数开头的业务附件
+    }
+    uint16_t checksum = static_cast<uint8_t>(attachment[5]) | static_cast<uint16_t>(static_cast<uint8_t>(attachment[6]) << 8);
+    if (checksum != HeaderChecksum(attachment, records_length)) {
+        return true;   // 校验对不上：恰好以魔数开头的业务附件
+    }
+    std::string_view records = attachment.substr(kHeaderSize, records_length);
+    while (records.size() >= 2) {
+        uint8_t tag = static_cast<uint8_t>(records[0]);
+        uint8_t length = static_cast<uint8_t>(records[1]);
+        if (2u + length > records.size()) {
+            return false;
+        }
+        if (tag == kTagDeadline && length == sizeof(int64_t)) {
+            fields.deadline_ms = static_cast<int64_t>(ReadU64(records.substr(2)));
+        } else if (tag == kTagFlags && length == 1) {
+            fields.flags = static_cast<uint8_t>(records[2]);
+        } else if (tag == kTagPriority && length == 1) {
+            fields.priority = static_cast<uint8_t>(records[2]);
+        } else if (tag == kTagTrace && length == 3 * sizeof(uint64_t)) {
+            fields.trace_id = ReadU64(records.substr(2));
+            fields.span_id = ReadU64(records.substr(2 + sizeof(uint64_t)));
+            fields.trace_send_us = static_cast<int64_t>(ReadU64(records.substr(2 + 2 * sizeof(uint64_t))));
+        }
+        records.remove_prefix(2u + length);
+    }
+    metadata_length = kHeaderSize + records_length;
+    return true;
+}
+
+const char* RpcDropStats::ReasonName(RpcDropReason reason)
+{
+    switch (reason) {
+    case RpcDropReason::DEADLINE_AT_ROUTER:
+        return "deadline_at_router";
+    case RpcDropReason::DEADLINE_AT_FORWARD:
+        return "deadline_at_forward";
+    case RpcDropReason::DEADLINE_AT_DISPATCH:
+        return "deadline_at_dispatch";
+    case RpcDropReason::HANDLER_CANCELLED:
+        return "handler_cancelled";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace BaseNode
+
+static BaseNode::RpcDropStats* g_rpc_drop_stats_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::RpcDropStats* GetRpcDropStatsInstance() {
+    if (!g_rpc_drop_stats_instance) {
+        g_rpc_drop_stats_instance = ToolBox::Singleton<BaseNode::RpcDropStats>::Instance();
+    }
+    return g_rpc_drop_stats_instance;
+}
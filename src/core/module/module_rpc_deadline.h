@@ -0,0 +1,164 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace BaseNode
+{
+
+#define MODULE_RPC_DEFAULT_TIMEOUT_MS 5000      // CallModuleService 的超时（与 RPC 库默认值一致）
+#define MODULE_RPC_STREAM_TIMEOUT_MS 30000      // CallModuleServiceStream 的超时（与 RPC 库默认值一致）
+
+/**
+ * @brief RPC 截止时间相关的时钟
+ *
+ * 截止时间是绝对时间（Unix 毫秒，system_clock），原样跨进程传递，ModuleRouter、RouterModule 和目标模块各自用本地时钟比较。
+ * 因此要求部署中所有节点的时钟同步（NTP / chrony）：时钟偏差会直接加到剩余时间上，时钟快的节点会提前丢弃请求，
+ * 时钟慢的节点会处理已经超时的请求。偏差在毫秒级时可以忽略，远小于默认超时（MODULE_RPC_DEFAULT_TIMEOUT_MS）。
+ */
+struct RpcDeadlineClock
+{
+    static int64_t NowMs();
+};
+
+/**
+ * @brief 附件中的框架元数据字段
+ */
+struct RpcMetadataFields
+{
+    int64_t deadline_ms = 0;      // 截止时间（Unix 毫秒），0 表示没有
+    uint8_t flags = 0;            // 标志位（RpcMetadata::kFlag*）
+    uint8_t priority = 0xFF;      // 请求优先级（RpcPriority），RpcMetadata::kNoPriority 表示按服务的默认优先级
+    uint64_t trace_id = 0;        // 调用链 ID，0 表示没有被采样（见 RpcTracer）
+    uint64_t span_id = 0;         // 调用方为这次调用生成的 span ID（下游 span 的父 span）
+    int64_t trace_send_us = 0;    // 调用方发出请求的时间（Unix 微秒）
+};
+
+/**
+ * @brief RPC 附件中的框架元数据
+ *
+ * 附件布局：魔数(2B) | 版本(1B) | 元数据长度(2B, 小端) | 校验(2B, 小端) | TLV 记录... | 业务附件
+ * TLV 记录：tag(1B) | 长度(1B) | 值；未识别的 tag 直接跳过，便于以后扩展。
+ * 校验为版本、长度和 TLV 记录的 CRC-16/CCITT。魔数、版本、长度或校验任何一项对不上的附件都视为纯业务附件
+ * （兼容旧版本发送方，以及恰好以魔数开头的业务附件），不会因此拒绝请求。
+ */
+class RpcMetadata
+{
+public:
+    static constexpr uint8_t kMagic0 = 0xB5;
+    static constexpr uint8_t kMagic1 = 0x4E;
+    static constexpr uint8_t kVersion = 1;
+    static constexpr uint32_t kHeaderSize = 7;
+    static constexpr uint32_t kMaxRecordsLength = UINT16_MAX - kHeaderSize;   // 元数据总长度不超过 16 位（RpcEnvelope::metadata_length）
+    static constexpr uint8_t kTagDeadline = 0x01;   // 值为 int64 小端，Unix 毫秒（绝对时间，要求节点间时钟同步，见 RpcDeadlineClock）
+    static constexpr uint8_t kTagFlags = 0x02;      // 值为 1 字节标志位，见 kFlag*
+    static constexpr uint8_t kTagPriority = 0x03;   // 值为 1 字节请求优先级（RpcPriority）
+    static constexpr uint8_t kTagTrace = 0x04;      // 值为 trace ID(8B) | span ID(8B) | 发送时间(8B, Unix 微秒)，均为小端，只有被采样的请求带
+
+    static constexpr uint8_t kFlagBatch = 0x01;     // 发送方把该请求合并到批量帧中发送（CallModuleServiceBatch）
+
+    static constexpr uint8_t kNoPriority = 0xFF;
+
+    /**
+     * @brief 生成带元数据的附件
+     * @param fields 元数据字段（全部为默认值时不写元数据）
+     * @param user_attachment 业务附件
+     */
+    static std::string Encode(const RpcMetadataFields& fields, std::string_view user_attachment);
+
+    /**
+     * @brief 解析附件中的元数据
+     * @param attachment 完整附件
+     * @param fields 元数据字段（没有的字段为默认值）
+     * @param metadata_length 元数据部分的长度（业务附件从这里开始），没有元数据时为 0，不超过 UINT16_MAX
+     * @return 校验通过但 TLV 记录越界时返回 false（此时按没有元数据处理）；不是元数据的附件返回 true
+     */
+    static bool Decode(std::string_view attachment, RpcMetadataFields& fields, uint32_t& metadata_length);
+};
+
+/**
+ * @brief 丢弃 RPC 请求的原因
+ */
+enum class RpcDropReason : uint8_t
+{
+    DEADLINE_AT_ROUTER = 0,     // ModuleRouter 路由时已过期
+    DEADLINE_AT_FORWARD = 1,    // RouterModule 转发时已过期
+    DEADLINE_AT_DISPATCH = 2,   // 模块分发到处理函数前已过期
+    HANDLER_CANCELLED = 3,      // 处理函数通过取消令牌提前结束
+    COUNT
+};
+
+/**
+ * @brief 按原因统计的 RPC 丢弃计数
+ */
+class RpcDropStats
+{
+public:
+    void Record(RpcDropReason reason, uint64_t count = 1) { counters_[static_cast<size_t>(reason)].fetch_add(count, std::memory_order_relaxed); }
+
+    uint64_t Get(RpcDropReason reason) const { return counters_[static_cast<size_t>(reason)].load(std::memory_order_relaxed); }
+
+    static const char* ReasonName(RpcDropReason reason);
+
+private:
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(RpcDropReason::COUNT)> counters_{};
+};
+
+/**
+ * @brief RPC 取消令牌
+ *
+ * 处理函数在开始时（第一次挂起之前）通过 IModule::CurrentRequestToken() 取得，之后在长循环、流式返回或发起下游调用前检查，
+ * 调用方已经放弃的请求（截止时间已过）或模块正在卸载时提前结束。
+ * 令牌共享模块的卸载标志（shared_ptr），处理函数的协程比模块或插件活得更久时令牌仍然有效；拷贝时增加一次引用计数。
+ */
+class RpcCancellationToken
+{
+public:
+    RpcCancellationToken() = default;
+    RpcCancellationToken(int64_t deadline_ms, std::shared_ptr<const std::atomic<bool>> stopping)
+        : deadline_ms_(deadline_ms), stopping_(std::move(stopping)) {}
+
+    /**
+     * @brief 是否应该停止（截止时间已过或模块正在卸载）
+     */
+    bool IsCancelled() const
+    {
+        if (stopping_ && stopping_->load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return deadline_ms_ > 0 && RpcDeadlineClock::NowMs() >= deadline_ms_;
+    }
+
+    /**
+     * @brief 截止时间（Unix 毫秒），0 表示没有
+     */
+    int64_t GetDeadlineMs() const { return deadline_ms_; }
+
+    /**
+     * @brief 剩余时间（毫秒），没有截止时间时返回 -1
+     */
+    int64_t RemainingMs() const
+    {
+        if (deadline_ms_ <= 0) {
+            return -1;
+        }
+        int64_t remaining = deadline_ms_ - RpcDeadlineClock::NowMs();
+        return remaining > 0 ? remaining : 0;
+    }
+
+private:
+    int64_t deadline_ms_ = 0;
+    std::shared_ptr<const std::atomic<bool>> stopping_;
+};
+
+} // namespace BaseNode
+
+// 获取 RPC 丢弃统计实例的全局函数（在 basenode_core 中实现）
+extern "C" BaseNode::RpcDropStats* GetRpcDropStatsInstance();
+
+#define RpcDropStatsMgr GetRpcDropStatsInstance()
@@ -0,0 +1,61 @@
+#include "module_rpc_envelope.h"
+#include "coro_rpc/coro_rpc_server.h" // IWYU pragma: keep
+
+namespace BaseNode
+{
+
+// 协议头字段只在这里读取，协议变化时只需修改此处
+ErrorCode RpcEnvelope::Parse(std::string_view rpc_data, RpcEnvelope& envelope)
+{
+    using namespace ToolBox::CoroRpc;
+
+    envelope = RpcEnvelope{};
+    CoroRpcProtocol::ReqHeader header;
+    Errc err = CoroRpcProtocol::ReadHeader(rpc_data, header);
+    if (err != Errc::SUCCESS) {
+        BaseNodeLogError("[RpcEnvelope] Parse: failed to read header, err: %d, size: %zu", static_cast<int>(err), rpc_data.size());
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+
+    uint64_t payload_length = static_cast<uint64_t>(header.length) + header.attach_length;
+    if (payload_length > rpc_data.size()) {
+        BaseNodeLogError("[RpcEnvelope] Parse: truncated packet, size: %zu, body: %u, attachment: %u",
+                         rpc_data.size(), header.length, header.attach_length);
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+
+    uint64_t body_offset = rpc_data.size() - payload_length;
+    if (body_offset > UINT16_MAX) {
+        BaseNodeLogError("[RpcEnvelope] Parse: header too long, size: %zu, body: %u, attachment: %u",
+                         rpc_data.size(), header.length, header.attach_length);
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+
+    envelope.service_id = CoroRpcProtocol::GetRpcFuncKey(header);
+    envelope.client_id = CoroRpcProtocol::GetClientID(header);
+    envelope.request_id = header.seq_num;
+    envelope.msg_type = header.msg_type;
+    envelope.body_length = header.length;
+    envelope.attach_length = header.attach_length;
+    envelope.body_offset = static_cast<uint16_t>(body_offset);
+    RpcMetadataFields fields;
+    uint32_t metadata_length = 0;
+    if (RpcMetadata::Decode(envelope.Attachment(rpc_data), fields, metadata_length)) {
+        envelope.metadata_length = static_cast<uint16_t>(metadata_length);
+        envelope.deadline_ms = fields.deadline_ms;
+        envelope.flags = fields.flags;
+        envelope.priority = fields.priority;
+        envelope.trace_id = fields.trace_id;
+        envelope.parent_span_id = fields.span_id;
+        envelope.trace_send_us = fields.trace_send_us;
+    } else {
+        // 元数据损坏不影响请求本身，按没有元数据处理
+        BaseNodeLogWarn("[RpcEnvelope] Parse: malformed attachment metadata, service_id: %u, request_id: %u",
+                        envelope.service_id, envelope.request_id);
+        envelope.metadata_length = 0;
+    }
+    envelope.valid = true;
+    return ErrorCode::BN_SUCCESS;
+}
+
+} // namespace BaseNode
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include "module_rpc_deadline.h"
+#include <cstdint>
+#include <string_view>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 解析后的 RPC 协议头
+ *
+ * 数据包在入口（ModuleRouter / RouterModule）只解析一次 CoroRpcProtocol::ReqHeader，
+ * 结果随 ModuleEvent 一起传递，路由、统计、日志等后续环节直接使用，不再重复解码。
+ * 数据包布局为：协议头 | 消息体(body_length) | 附件(attach_length)，附件开头可能带有框架元数据（截止时间等，见 RpcMetadata）。
+ * 字段按宽度从大到小排列，协议头长度和元数据长度用 16 位保存，整个结构正好一个缓存行（64 字节）。
+ */
+struct RpcEnvelope
+{
+    uint64_t client_id = 0;       // 客户端ID（发起调用的模块ID）
+    int64_t deadline_ms = 0;      // 调用方的截止时间（Unix 毫秒），0 表示没有
+    uint64_t trace_id = 0;        // 调用链 ID，0 表示没有被采样
+    uint64_t parent_span_id = 0;  // 调用方为这次调用生成的 span ID
+    int64_t trace_send_us = 0;    // 调用方发出请求的时间（Unix 微秒）
+    uint32_t service_id = 0;      // 服务ID（RPC 函数 key）
+    uint32_t request_id = 0;      // 请求序号
+    uint32_t body_length = 0;     // 消息体长度
+    uint32_t attach_length = 0;   // 附件长度
+    uint16_t body_offset = 0;     // 消息体在数据包中的偏移（即协议头长度）
+    uint16_t metadata_length = 0; // 附件中框架元数据的长度（RpcMetadata 保证不超过 16 位）
+    uint8_t msg_type = 0;         // 消息类型（CoroRpc 的保留字段，目前请求和响应都不设置）
+    uint8_t flags = 0;            // 框架元数据中的标志位（RpcMetadata::kFlag*）
+    uint8_t priority = RpcMetadata::kNoPriority;  // 调用方指定的优先级（RpcPriority），kNoPriority 表示按服务的默认优先级
+    bool valid = false;           // 是否已成功解析
+
+    /**
+     * @brief 解析数据包的协议头
+     * @param rpc_data 完整的 RPC 数据包
+     * @param envelope 解析结果
+     * @return BN_SUCCESS 或 BN_INVALID_ARGUMENTS
+     */
+    static ErrorCode Parse(std::string_view rpc_data, RpcEnvelope& envelope);
+
+    /**
+     * @brief 消息体
+     */
+    std::string_view Body(std::string_view rpc_data) const { return rpc_data.substr(body_offset, body_length); }
+
+    /**
+     * @brief 附件
+     */
+    std::string_view Attachment(std::string_view rpc_data) const { return rpc_data.substr(body_offset + body_length, attach_length); }
+
+    /**
+     * @brief 去掉框架元数据后的业务附件
+     */
+    std::string_view UserAttachment(std::string_view rpc_data) const { return Attachment(rpc_data).substr(metadata_length); }
+
+    /**
+     * @brief 截止时间是否已过
+     * @param now_ms 当前时间（见 RpcDeadlineClock::NowMs）
+     */
+    bool Expired(int64_t now_ms) const { return deadline_ms > 0 && now_ms >= deadline_ms; }
+
+    /**
+     * @brief 截止时间是否已过（没有截止时间时不读时钟）
+     */
+    bool Expired() const { return deadline_ms > 0 && RpcDeadlineClock::NowMs() >= deadline_ms; }
+};
+
+static_assert(sizeof(RpcEnvelope) == 64, "RpcEnvelope should fit in one cache line, see ModuleEvent");
+
+} // namespace BaseNode
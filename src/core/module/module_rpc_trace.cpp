@@ -0,0 +1,205 @@
+#include "module_rpc_trace.h"
+#include "module_interface.h"
+#include "module_router.h"
+#include "tools/singleton.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace BaseNode
+{
+
+namespace
+{
+
+// 每个线程独立的 splitmix64，生成 ID 和采样都不需要同步
+uint64_t NextRandom()
+{
+    thread_local uint64_t state = [] {
+        std::random_device device;
+        uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+        return seed ^ static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    }();
+    uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// JSON 字符串中只会出现模块名和进程名，转义引号和反斜杠即可
+void AppendJsonString(std::string& out, const std::string& value)
+{
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+    }
+    out += '"';
+}
+
+} // namespace
+
+int64_t RpcTracer::NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t RpcTracer::NewId()
+{
+    uint64_t id = NextRandom();
+    return id != 0 ? id : 1;
+}
+
+void RpcTracer::Configure(const RpcTraceOptions& options)
+{
+    double rate = options.sample_rate;
+    uint64_t threshold = 0;
+    if (rate >= 1.0) {
+        threshold = UINT64_MAX;
+    } else if (rate > 0.0) {
+        threshold = static_cast<uint64_t>(rate * 18446744073709551616.0);
+    }
+    sample_threshold_.store(threshold, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring_capacity_ = options.ring_capacity;
+    ring_.clear();
+    ring_.shrink_to_fit();
+    ring_.reserve(ring_capacity_);
+    ring_next_ = 0;
+    BaseNodeLogInfo("[RpcTracer] Configure: sample_rate: %.6f, ring_capacity: %zu", rate, ring_capacity_);
+}
+
+void RpcTracer::SetProcessName(const std::string& process_name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    process_name_ = process_name;
+}
+
+bool RpcTracer::ShouldSample() const
+{
+    uint64_t threshold = sample_threshold_.load(std::memory_order_relaxed);
+    return threshold != 0 && NextRandom() <= threshold;
+}
+
+void RpcTracer::Record(const RpcSpan& span)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_capacity_ == 0) {
+        return;
+    }
+    if (ring_.size() < ring_capacity_) {
+        ring_.push_back(span);
+    } else {
+        ring_[ring_next_] = span;
+    }
+    ring_next_ = (ring_next_ + 1) % ring_capacity_;
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<RpcSpan> RpcTracer::Snapshot(uint64_t trace_id) const
+{
+    std::vector<RpcSpan> spans;
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans.reserve(trace_id == 0 ? ring_.size() : 0);
+    // 缓冲区写满后 ring_next_ 指向最旧的 span
+    size_t begin = ring_.size() < ring_capacity_ ? 0 : ring_next_;
+    for (size_t i = 0; i < ring_.size(); ++i) {
+        const RpcSpan& span = ring_[(begin + i) % ring_.size()];
+        if (trace_id == 0 || span.trace_id == trace_id) {
+            spans.push_back(span);
+        }
+    }
+    return spans;
+}
+
+std::string RpcTracer::ExportChromeJson(uint64_t trace_id) const
+{
+    std::vector<RpcSpan> spans = Snapshot(trace_id);
+    std::string process_name;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        process_name = process_name_;
+    }
+    const int pid = static_cast<int>(getpid());
+
+    std::string out;
+    out.reserve(256 + spans.size() * 256);
+    char line[512];
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    snprintf(line, sizeof(line), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":", pid);
+    out += line;
+    AppendJsonString(out, process_name.empty() ? std::to_string(pid) : process_name);
+    out += "}}";
+
+    // 每个模块作为一个线程显示
+    std::unordered_set<uint32_t> module_ids;
+    for (const RpcSpan& span : spans) {
+        module_ids.insert(span.module_id);
+    }
+    for (IModule* module : ModuleRouterMgr->GetAllModules()) {
+        if (module_ids.count(module->GetModuleId()) == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                 pid, module->GetModuleId());
+        out += line;
+        AppendJsonString(out, module->GetModuleName());
+        out += "}}";
+    }
+
+    for (const RpcSpan& span : spans) {
+        if (span.kind == RpcSpanKind::CLIENT_SEND) {
+            snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"rpc\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRId64 ",\"pid\":%d,\"tid\":%u,",
+                     KindName(span.kind), span.begin_us, pid, span.module_id);
+        } else {
+            snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"rpc\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%" PRId64 ",\"pid\":%d,\"tid\":%u,",
+                     KindName(span.kind), span.begin_us, std::max<int64_t>(span.end_us - span.begin_us, 0), pid, span.module_id);
+        }
+        out += line;
+        // 64 位 ID 以十六进制字符串导出，避免 JSON 数字丢失精度
+        snprintf(line, sizeof(line),
+                 "\"args\":{\"trace_id\":\"%016" PRIx64 "\",\"span_id\":\"%016" PRIx64 "\",\"parent_span_id\":\"%016" PRIx64 "\",\"service_id\":%u,\"request_id\":%u}}",
+                 span.trace_id, span.span_id, span.parent_span_id, span.service_id, span.request_id);
+        out += line;
+    }
+    out += "]}\n";
+    return out;
+}
+
+const char* RpcTracer::KindName(RpcSpanKind kind)
+{
+    switch (kind) {
+    case RpcSpanKind::CLIENT_SEND:
+        return "rpc.send";
+    case RpcSpanKind::NETWORK:
+        return "rpc.network";
+    case RpcSpanKind::ROUTER_FORWARD:
+        return "rpc.router_forward";
+    case RpcSpanKind::MAILBOX:
+        return "rpc.mailbox";
+    case RpcSpanKind::HANDLER:
+        return "rpc.handler";
+    default:
+        return "rpc.unknown";
+    }
+}
+
+} // namespace BaseNode
+
+static BaseNode::RpcTracer* g_rpc_tracer_instance = nullptr;
+
+extern "C" SO_EXPORT_SYMBOL BaseNode::RpcTracer* GetRpcTracerInstance() {
+    if (!g_rpc_tracer_instance) {
+        g_rpc_tracer_instance = ToolBox::Singleton<BaseNode::RpcTracer>::Instance();
+    }
+    return g_rpc_tracer_instance;
+}
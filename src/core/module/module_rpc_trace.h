@@ -0,0 +1,143 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace BaseNode
+{
+
+#define RPC_TRACE_DEFAULT_RING_CAPACITY 16384   // 默认每个进程保留的最近 span 数
+#define RPC_TRACE_MAX_PENDING_SENDS 1024        // 每个模块最多等待发出的被采样调用数（调用没有发出时防止无限增长）
+
+/**
+ * @brief 调用链上下文：请求所属的 trace 和它的父 span
+ */
+struct RpcTraceContext
+{
+    uint64_t trace_id = 0;        // 0 表示没有被采样
+    uint64_t span_id = 0;         // 当前 span（作为下游调用的父 span）
+
+    bool Valid() const { return trace_id != 0; }
+};
+
+/**
+ * @brief span 的类型，对应请求经过的各个环节
+ */
+enum class RpcSpanKind : uint8_t
+{
+    CLIENT_SEND = 0,      // 调用方发出请求（瞬时事件）
+    NETWORK = 1,          // 调用方发出到 RouterModule 收到
+    ROUTER_FORWARD = 2,   // RouterModule 收到到转发完成
+    MAILBOX = 3,          // 进入目标模块邮箱到被取出
+    HANDLER = 4,          // 处理函数同步执行（协程挂起后的部分不计入）
+    COUNT
+};
+
+/**
+ * @brief 一个已完成的 span
+ */
+struct RpcSpan
+{
+    uint64_t trace_id = 0;
+    uint64_t span_id = 0;
+    uint64_t parent_span_id = 0;  // 0 表示根
+    int64_t begin_us = 0;         // Unix 微秒，跨进程对齐
+    int64_t end_us = 0;
+    uint32_t service_id = 0;
+    uint32_t request_id = 0;
+    uint32_t module_id = 0;       // 记录 span 的模块
+    RpcSpanKind kind = RpcSpanKind::CLIENT_SEND;
+};
+
+/**
+ * @brief 调用链追踪配置，对应配置文件中的 {config_name}.tracing
+ */
+struct RpcTraceOptions
+{
+    double sample_rate = 0.0;                               // 根调用的采样率（0~1），0 表示不发起新的 trace
+    uint32_t ring_capacity = RPC_TRACE_DEFAULT_RING_CAPACITY;   // 环形缓冲区容量，0 表示不记录 span
+};
+
+/**
+ * @brief 进程级调用链追踪器
+ *
+ * 采样在调用链的起点决定（head-based）：不在处理请求期间发起的调用按 sample_rate 采样，
+ * 被采样的请求在附件元数据中带上 trace ID、父 span ID 和发送时间，下游处理期间发起的调用沿用同一个 trace，
+ * 未被采样的请求不带任何追踪数据，下游也不会重新采样。
+ * 各环节的 span 写入进程内的环形缓冲区（只有被采样的请求会写入，满了覆盖最旧的），
+ * 导出为 Chrome trace JSON（chrome://tracing、Perfetto），时间戳为 Unix 微秒，
+ * 多个进程的导出结果合并 traceEvents 后可以按 trace_id 查看一个请求的完整链路。
+ */
+class RpcTracer
+{
+public:
+    /**
+     * @brief span 使用的时钟（Unix 微秒）
+     */
+    static int64_t NowUs();
+
+    /**
+     * @brief 生成非 0 的随机 trace / span ID
+     */
+    static uint64_t NewId();
+
+    /**
+     * @brief 应用配置（在插件加载前调用）
+     */
+    void Configure(const RpcTraceOptions& options);
+
+    /**
+     * @brief 进程名（导出时作为 Chrome trace 的 process_name）
+     */
+    void SetProcessName(const std::string& process_name);
+
+    /**
+     * @brief 是否采样一个新的根调用（采样率为 0 时只读一次原子变量）
+     */
+    bool ShouldSample() const;
+
+    /**
+     * @brief 记录一个 span（环形缓冲区容量为 0 时忽略）
+     */
+    void Record(const RpcSpan& span);
+
+    /**
+     * @brief 环形缓冲区中的 span，按记录顺序
+     * @param trace_id 只返回该 trace 的 span，0 表示全部
+     */
+    std::vector<RpcSpan> Snapshot(uint64_t trace_id = 0) const;
+
+    /**
+     * @brief 导出为 Chrome trace JSON
+     * @param trace_id 只导出该 trace，0 表示全部
+     */
+    std::string ExportChromeJson(uint64_t trace_id = 0) const;
+
+    /**
+     * @brief 累计记录的 span 数
+     */
+    uint64_t GetRecorded() const { return recorded_.load(std::memory_order_relaxed); }
+
+    static const char* KindName(RpcSpanKind kind);
+
+private:
+    std::atomic<uint64_t> sample_threshold_{0};     // 随机数小于等于该值时采样，0 表示不采样
+    std::atomic<uint64_t> recorded_{0};
+
+    mutable std::mutex mutex_;                      // 保护以下成员，只有被采样的请求会获取
+    std::vector<RpcSpan> ring_;
+    size_t ring_capacity_ = 0;
+    size_t ring_next_ = 0;                          // 下一个写入位置
+    std::string process_name_;
+};
+
+} // namespace BaseNode
+
+// 获取调用链追踪器实例的全局函数（在 basenode_core 中实现）
+extern "C" BaseNode::RpcTracer* GetRpcTracerInstance();
+
+#define RpcTracerMgr GetRpcTracerInstance()
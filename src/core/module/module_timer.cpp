@@ -0,0 +1,266 @@
+#include "module_timer.h"
+#include "module_reactor.h"
+#include <algorithm>
+#include <exception>
+
+namespace BaseNode
+{
+
+ModuleTimerWheel::ModuleTimerWheel()
+    : ModuleTimerWheel(ModuleReactor::NowNs())
+{
+}
+
+ModuleTimerWheel::ModuleTimerWheel(int64_t base_ns)
+    : base_ns_(base_ns)
+{
+    std::fill(std::begin(slots_), std::end(slots_), kNil);
+}
+
+TimerId ModuleTimerWheel::AddTimer(uint32_t delay_ms, std::function<void()>&& callback)
+{
+    return Add_(delay_ms, 0, std::move(callback), nullptr);
+}
+
+TimerId ModuleTimerWheel::AddPeriodicTimer(uint32_t interval_ms, std::function<void()>&& callback)
+{
+    return Add_(interval_ms, std::max<uint32_t>(interval_ms, 1), std::move(callback), nullptr);
+}
+
+TimerId ModuleTimerWheel::AddCoroutineTimer(uint32_t delay_ms, std::coroutine_handle<> handle)
+{
+    return Add_(delay_ms, 0, nullptr, handle);
+}
+
+bool ModuleTimerWheel::Cancel(TimerId timer_id)
+{
+    Node* node = Lookup_(timer_id);
+    if (!node) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>(timer_id & 0xFFFFFFFFu) - 1;
+    Unlink_(index);
+    FreeNode_(index);
+    return true;
+}
+
+size_t ModuleTimerWheel::Advance(int64_t now_ns)
+{
+    int64_t target = NowTick_(now_ns);
+    if (size_ == 0) {
+        // 没有定时器时直接跳到当前时间，所有槽都是空的，无需逐 tick 降级
+        current_ = std::max(current_, target);
+        return 0;
+    }
+    size_t fired = 0;
+    while (current_ < target && size_ > 0) {
+        fired += Step_();
+    }
+    current_ = std::max(current_, target);
+    return fired;
+}
+
+int64_t ModuleTimerWheel::NextExpireNs() const
+{
+    if (size_ == 0) {
+        return -1;
+    }
+    const uint32_t mask = kLevel0Slots - 1;
+    int64_t ticks = kLevel0Slots - static_cast<int64_t>(current_ & mask);
+    for (uint32_t delta = 1; delta < kLevel0Slots; ++delta) {
+        if (slots_[(current_ + delta) & mask] != kNil) {
+            ticks = delta;
+            break;
+        }
+    }
+    return base_ns_ + (current_ + ticks) * 1000000;
+}
+
+TimerId ModuleTimerWheel::Add_(uint32_t delay_ms, uint32_t interval, std::function<void()>&& callback, std::coroutine_handle<> handle)
+{
+    uint32_t index = AllocNode_();
+    Node& node = nodes_[index];
+    // 从当前时间起算（时间轮可能还没推进到当前时间），至少一个 tick，保证不会落在正在处理的槽上
+    node.expire = std::max(current_, NowTick_(ModuleReactor::NowNs())) + std::max<uint32_t>(delay_ms, 1);
+    node.interval = interval;
+    node.callback = std::move(callback);
+    node.handle = handle;
+    Insert_(index);
+    return (static_cast<TimerId>(node.generation) << 32) | (index + 1);
+}
+
+uint32_t ModuleTimerWheel::AllocNode_()
+{
+    ++size_;
+    if (free_head_ != kNil) {
+        uint32_t index = free_head_;
+        free_head_ = nodes_[index].next;
+        nodes_[index].next = kNil;
+        return index;
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void ModuleTimerWheel::FreeNode_(uint32_t index)
+{
+    Node& node = nodes_[index];
+    // 代数递增使旧 ID 失效，跳过 0 保证 ID 不为 0
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    node.callback = nullptr;
+    node.handle = nullptr;
+    node.slot = kNil;
+    node.prev = kNil;
+    node.next = free_head_;
+    free_head_ = index;
+    --size_;
+}
+
+ModuleTimerWheel::Node* ModuleTimerWheel::Lookup_(TimerId timer_id)
+{
+    uint32_t index = static_cast<uint32_t>(timer_id & 0xFFFFFFFFu);
+    if (index == 0 || index > nodes_.size()) {
+        return nullptr;
+    }
+    Node& node = nodes_[index - 1];
+    if (node.generation != static_cast<uint32_t>(timer_id >> 32) || node.slot == kNil) {
+        return nullptr;
+    }
+    return &node;
+}
+
+// 按剩余时间选择层：第 0 层按到期 tick 取槽，第 l 层按到期 tick 右移 (8 + 6 * (l - 1)) 位取槽
+void ModuleTimerWheel::Insert_(uint32_t index)
+{
+    Node& node = nodes_[index];
+    int64_t expire = std::max(node.expire, current_);
+    int64_t delta = expire - current_;
+    uint32_t slot = kNil;
+    if (delta < static_cast<int64_t>(kLevel0Slots)) {
+        slot = static_cast<uint32_t>(expire & (kLevel0Slots - 1));
+    } else {
+        for (uint32_t level = 1; level < MODULE_TIMER_LEVEL_NUM; ++level) {
+            uint32_t shift = MODULE_TIMER_LEVEL0_BITS + MODULE_TIMER_LEVEL_BITS * (level - 1);
+            if (delta < (static_cast<int64_t>(1) << (shift + MODULE_TIMER_LEVEL_BITS)) || level == MODULE_TIMER_LEVEL_NUM - 1) {
+                // 超出最高层跨度的定时器放在最高层最远的槽，降级时按真实到期时间重新放置
+                int64_t position = std::min(expire, current_ + (static_cast<int64_t>(1) << (shift + MODULE_TIMER_LEVEL_BITS)) - 1);
+                slot = kLevel0Slots + kLevelSlots * (level - 1) + static_cast<uint32_t>((position >> shift) & (kLevelSlots - 1));
+                break;
+            }
+        }
+    }
+    node.slot = slot;
+    node.prev = kNil;
+    node.next = slots_[slot];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    slots_[slot] = index;
+}
+
+void ModuleTimerWheel::Unlink_(uint32_t index)
+{
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.slot] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+    node.slot = kNil;
+}
+
+// 把第 level 层当前槽中的定时器降级到下层，返回槽下标（为 0 说明这一层也转完了一圈，需要继续降级上一层）
+uint32_t ModuleTimerWheel::Cascade_(uint32_t level)
+{
+    uint32_t shift = MODULE_TIMER_LEVEL0_BITS + MODULE_TIMER_LEVEL_BITS * (level - 1);
+    uint32_t index = static_cast<uint32_t>((current_ >> shift) & (kLevelSlots - 1));
+    uint32_t slot = kLevel0Slots + kLevelSlots * (level - 1) + index;
+    uint32_t node_index = slots_[slot];
+    slots_[slot] = kNil;
+    while (node_index != kNil) {
+        uint32_t next = nodes_[node_index].next;
+        Insert_(node_index);
+        node_index = next;
+    }
+    return index;
+}
+
+size_t ModuleTimerWheel::Step_()
+{
+    ++current_;
+    uint32_t index = static_cast<uint32_t>(current_ & (kLevel0Slots - 1));
+    if (index == 0) {
+        for (uint32_t level = 1; level < MODULE_TIMER_LEVEL_NUM; ++level) {
+            if (Cascade_(level) != 0) {
+                break;
+            }
+        }
+    }
+    // 回调中新加的定时器至少晚一个 tick，不会落回当前槽
+    size_t fired = 0;
+    while (slots_[index] != kNil) {
+        uint32_t node_index = slots_[index];
+        Unlink_(node_index);
+        Fire_(node_index);
+        ++fired;
+    }
+    return fired;
+}
+
+void ModuleTimerWheel::Fire_(uint32_t index)
+{
+    Node& node = nodes_[index];
+    try {
+        if (node.handle) {
+            std::coroutine_handle<> handle = node.handle;
+            FreeNode_(index);
+            handle.resume();
+            return;
+        }
+        if (node.interval == 0) {
+            std::function<void()> callback = std::move(node.callback);
+            FreeNode_(index);
+            if (callback) {
+                callback();
+            }
+            return;
+        }
+        // 周期定时器先重新挂回时间轮，回调中可以取消自身；回调执行期间节点数组可能扩容，之后按下标重新访问
+        uint32_t generation = node.generation;
+        node.expire += node.interval;
+        Insert_(index);
+        std::function<void()> callback = std::move(node.callback);
+        try {
+            if (callback) {
+                callback();
+            }
+        } catch (...) {
+            // 回调抛出异常时定时器继续保留，同样要把回调放回节点，否则之后每次触发的都是空回调
+            RestoreCallback_(index, generation, std::move(callback));
+            throw;
+        }
+        RestoreCallback_(index, generation, std::move(callback));
+    } catch (const std::exception& e) {
+        BaseNodeLogError("[ModuleTimer] timer callback threw exception: %s", e.what());
+    } catch (...) {
+        BaseNodeLogError("[ModuleTimer] timer callback threw unknown exception");
+    }
+}
+
+// 周期定时器的回调执行完后放回节点；回调中取消了自身（节点已释放或被复用）时直接丢弃
+void ModuleTimerWheel::RestoreCallback_(uint32_t index, uint32_t generation, std::function<void()>&& callback)
+{
+    Node& node = nodes_[index];
+    if (node.generation == generation && node.slot != kNil) {
+        node.callback = std::move(callback);
+    }
+}
+
+} // namespace BaseNode
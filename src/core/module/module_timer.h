@@ -0,0 +1,134 @@
+#pragma once
+
+#include "utils/basenode_def_internal.h"
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace BaseNode
+{
+
+using TimerId = uint64_t;                      // 0 表示无效定时器
+
+#define MODULE_TIMER_LEVEL0_BITS 8             // 第 0 层 256 个槽，每槽 1 个 tick
+#define MODULE_TIMER_LEVEL_BITS 6              // 第 1~3 层各 64 个槽
+#define MODULE_TIMER_LEVEL_NUM 4               // 层数，1ms tick 时最大跨度约 18.6 小时，更远的定时器分多次降级
+
+/**
+ * @brief 分层时间轮（单线程，由模块所在的线程驱动）
+ *
+ * 时间精度为 1ms（一个 tick）。第 0 层 256 个槽覆盖 256ms，之后每层 64 个槽，逐层放大 64 倍；
+ * 高层槽在低层转完一圈时降级到下层（cascade）。定时器节点放在连续数组中，用下标组成的双向链表挂在槽上，
+ * 添加和取消都是 O(1)，节点复用不产生额外分配（回调本身的 std::function 除外）。
+ * 定时器 ID 由节点下标和代数组成，节点复用后旧 ID 自动失效。
+ */
+class ModuleTimerWheel
+{
+public:
+    ModuleTimerWheel();
+
+    /**
+     * @brief 指定 tick 0 对应的时间（纳秒），测试用
+     * 添加定时器时以真实时间和已推进到的时间中较晚者为起点，测试先推进到远超真实时间的虚拟时间，到期 tick 就可以精确控制
+     */
+    explicit ModuleTimerWheel(int64_t base_ns);
+
+    ModuleTimerWheel(const ModuleTimerWheel&) = delete;
+    ModuleTimerWheel& operator=(const ModuleTimerWheel&) = delete;
+
+    /**
+     * @brief 添加一次性定时器
+     * @param delay_ms 延迟（毫秒），0 视为 1
+     * @return 定时器ID
+     */
+    TimerId AddTimer(uint32_t delay_ms, std::function<void()>&& callback);
+
+    /**
+     * @brief 添加周期定时器（首次在 interval_ms 后触发）
+     */
+    TimerId AddPeriodicTimer(uint32_t interval_ms, std::function<void()>&& callback);
+
+    /**
+     * @brief 添加到期后恢复协程的定时器（SleepFor 使用）
+     */
+    TimerId AddCoroutineTimer(uint32_t delay_ms, std::coroutine_handle<> handle);
+
+    /**
+     * @brief 取消定时器（可以在定时器回调中调用，包括取消自身）
+     * @return 定时器存在且被取消时返回 true
+     */
+    bool Cancel(TimerId timer_id);
+
+    /**
+     * @brief 推进到当前时间并触发所有到期的定时器
+     * @param now_ns 单调时钟当前时间（纳秒，见 ModuleReactor::NowNs）
+     * @return 触发的定时器个数
+     */
+    size_t Advance(int64_t now_ns);
+
+    /**
+     * @brief 下一次需要推进时间轮的时间（纳秒，用于设置循环的唤醒时间），没有定时器时返回 -1
+     * 只精确到第 0 层，第 0 层为空时返回下一次降级的时间
+     */
+    int64_t NextExpireNs() const;
+
+    size_t Size() const { return size_; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint32_t kLevel0Slots = 1u << MODULE_TIMER_LEVEL0_BITS;
+    static constexpr uint32_t kLevelSlots = 1u << MODULE_TIMER_LEVEL_BITS;
+    static constexpr uint32_t kSlotNum = kLevel0Slots + kLevelSlots * (MODULE_TIMER_LEVEL_NUM - 1);
+
+    struct Node
+    {
+        int64_t expire = 0;               // 到期 tick
+        uint32_t interval = 0;            // 周期（tick），0 表示一次性
+        uint32_t generation = 1;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t slot = kNil;             // 所在槽，kNil 表示不在时间轮上
+        std::coroutine_handle<> handle;
+        std::function<void()> callback;
+    };
+
+    TimerId Add_(uint32_t delay_ms, uint32_t interval, std::function<void()>&& callback, std::coroutine_handle<> handle);
+    uint32_t AllocNode_();
+    void FreeNode_(uint32_t index);
+    Node* Lookup_(TimerId timer_id);
+    void Insert_(uint32_t index);
+    void Unlink_(uint32_t index);
+    uint32_t Cascade_(uint32_t level);
+    size_t Step_();
+    void Fire_(uint32_t index);
+    void RestoreCallback_(uint32_t index, uint32_t generation, std::function<void()>&& callback);
+    int64_t NowTick_(int64_t now_ns) const { return (now_ns - base_ns_) / 1000000; }
+
+private:
+    int64_t base_ns_ = 0;                 // tick 0 对应的时间
+    int64_t current_ = 0;                 // 已处理到的 tick
+    size_t size_ = 0;
+    uint32_t free_head_ = kNil;
+    std::vector<Node> nodes_;
+    uint32_t slots_[kSlotNum];
+};
+
+/**
+ * @brief co_await SleepFor(...) 使用的 awaiter：挂起协程，到期后由时间轮在模块线程上恢复
+ */
+class TimerSleepAwaiter
+{
+public:
+    TimerSleepAwaiter(ModuleTimerWheel& wheel, uint32_t delay_ms) : wheel_(wheel), delay_ms_(delay_ms) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { wheel_.AddCoroutineTimer(delay_ms_, handle); }
+    void await_resume() const noexcept {}
+
+private:
+    ModuleTimerWheel& wheel_;
+    uint32_t delay_ms_;
+};
+
+} // namespace BaseNode
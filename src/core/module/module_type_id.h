@@ -0,0 +1,130 @@
+#pragma once
+
+#include "coro_rpc/coro_rpc_server.h" // IWYU pragma: keep
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 编译期 FNV-1a 32 位哈希
+ */
+constexpr uint32_t Fnv1a32(std::string_view data)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+namespace Detail
+{
+// 从 __PRETTY_FUNCTION__ / __FUNCSIG__ 中截取模板实参部分
+constexpr std::string_view ExtractTemplateArg(std::string_view signature, std::string_view marker)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    // 形如 "... BaseNode::Detail::NameOf<class BaseNode::Guild>(void)"
+    std::size_t begin = signature.find(marker);
+    begin = begin == std::string_view::npos ? 0 : begin + marker.size();
+    std::size_t end = signature.rfind(">(void)");
+    std::string_view name = signature.substr(begin, end - begin);
+    for (std::string_view prefix : {std::string_view("class "), std::string_view("struct ")}) {
+        if (name.substr(0, prefix.size()) == prefix) {
+            name.remove_prefix(prefix.size());
+        }
+    }
+    return name;
+#else
+    // GCC: "... [with T = BaseNode::Guild; ...]"，Clang: "... [T = BaseNode::Guild]"
+    std::size_t begin = signature.find(marker);
+    begin = begin == std::string_view::npos ? 0 : begin + marker.size();
+    std::size_t end = signature.find_first_of(";]", begin);
+    return signature.substr(begin, end - begin);
+#endif
+}
+
+template <typename T>
+constexpr std::string_view TypeSignature()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return ExtractTemplateArg(__FUNCSIG__, "TypeSignature<");
+#else
+    return ExtractTemplateArg(__PRETTY_FUNCTION__, "T = ");
+#endif
+}
+
+template <auto func>
+constexpr std::string_view FuncSignature()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return ExtractTemplateArg(__FUNCSIG__, "FuncSignature<");
+#else
+    return ExtractTemplateArg(__PRETTY_FUNCTION__, "func = ");
+#endif
+}
+} // namespace Detail
+
+/**
+ * @brief 编译期类型名（带命名空间，如 "BaseNode::Guild"）
+ */
+template <typename T>
+constexpr std::string_view TypeNameOf()
+{
+    return Detail::TypeSignature<T>();
+}
+
+/**
+ * @brief 编译期模块ID：类型名的 FNV-1a 哈希
+ * 运行期由 IModule 按同样规则从 RTTI 计算的ID与之一致，见 IModule::InitModuleIdentity_
+ *
+ * 模块ID会出现在请求头的 client_id 和服务发现中。旧版本按 RTTI 名的 MD5 计算，新旧版本的进程不能混合部署。
+ */
+template <typename T>
+constexpr uint32_t ModuleTypeId()
+{
+    return Fnv1a32(TypeNameOf<T>());
+}
+
+/**
+ * @brief 服务函数的服务ID：RPC 库在请求头 function_id 中填写、服务端注册处理函数时使用的同一个编译期函数
+ */
+template <auto func>
+constexpr uint32_t RpcServiceKey()
+{
+    return static_cast<uint32_t>(ToolBox::CoroRpc::func_id<func>());
+}
+
+/**
+ * @brief 编译期服务键表：RegisterService<...> 的一组服务函数在线上使用的服务ID
+ *
+ * 用于在编译期发现同一次注册中的重复函数或服务ID冲突。同一模块多次 RegisterService 之间的冲突由
+ * IModule::CheckServiceKeys_ 在注册时检查，跨模块的冲突由 ModuleRouter::RegisterModule 在运行期检查。
+ */
+template <auto... funcs>
+struct ServiceKeyTable
+{
+    static constexpr std::size_t kSize = sizeof...(funcs);
+    static constexpr std::array<uint32_t, sizeof...(funcs)> kKeys = {RpcServiceKey<funcs>()...};
+
+    static constexpr bool Unique()
+    {
+        for (std::size_t i = 0; i < kSize; ++i) {
+            if (kKeys[i] == 0) {
+                return false;
+            }
+            for (std::size_t j = i + 1; j < kSize; ++j) {
+                if (kKeys[i] == kKeys[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace BaseNode
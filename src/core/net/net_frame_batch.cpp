@@ -0,0 +1,113 @@
+#include "net_frame_batch.h"
+#include "utils/basenode_def_internal.h"
+
+namespace BaseNode
+{
+
+bool NetMultiFrame::IsMultiFrame(std::string_view packet)
+{
+    if (packet.size() < NET_MULTI_FRAME_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t magic = 0;
+    for (size_t i = 0; i < NET_MULTI_FRAME_HEADER_SIZE; ++i) {
+        magic |= static_cast<uint32_t>(static_cast<uint8_t>(packet[i])) << (8 * i);
+    }
+    return magic == NET_MULTI_FRAME_MAGIC;
+}
+
+ToolBox::ENetErrCode NetOutputQueue::Send(uint64_t conn_id, std::string_view frame)
+{
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    if (!options_.coalesce) {
+        sends_.fetch_add(1, std::memory_order_relaxed);
+        ToolBox::ENetErrCode err = network_->Send(conn_id, frame.data(), static_cast<uint32_t>(frame.size()));
+        if (err != ToolBox::ENetErrCode::NET_SUCCESS) {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return err;
+    }
+
+    PendingOutput& output = pending_[conn_id];
+    if (output.frames == 0) {
+        output.data.clear();
+        for (size_t i = 0; i < NET_MULTI_FRAME_HEADER_SIZE; ++i) {
+            output.data.push_back(static_cast<char>((NET_MULTI_FRAME_MAGIC >> (8 * i)) & 0xFF));
+        }
+        ++pending_connections_;
+    }
+    RpcBatchFrame::Append(output.data, frame);
+    ++output.frames;
+    if (output.frames >= options_.max_frames || output.data.size() >= options_.max_bytes) {
+        flush_full_.fetch_add(1, std::memory_order_relaxed);
+        Send_(conn_id, output);
+    }
+    return ToolBox::ENetErrCode::NET_SUCCESS;
+}
+
+void NetOutputQueue::Flush()
+{
+    if (pending_connections_ == 0) {
+        return;
+    }
+    for (auto& [conn_id, output] : pending_) {
+        if (output.frames > 0) {
+            Send_(conn_id, output);
+        }
+    }
+}
+
+void NetOutputQueue::Discard(uint64_t conn_id)
+{
+    auto it = pending_.find(conn_id);
+    if (it == pending_.end()) {
+        return;
+    }
+    if (it->second.frames > 0) {
+        --pending_connections_;
+        BaseNodeLogWarn("[NetOutputQueue] Discard: drop %u pending frames, conn_id: %lu", it->second.frames, conn_id);
+    }
+    pending_.erase(it);
+}
+
+void NetOutputQueue::Clear()
+{
+    pending_.clear();
+    pending_connections_ = 0;
+}
+
+NetFrameStats NetOutputQueue::GetStats() const
+{
+    NetFrameStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.packets = sends_.load(std::memory_order_relaxed);
+    stats.flush_full = flush_full_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void NetOutputQueue::Send_(uint64_t conn_id, PendingOutput& output)
+{
+    // 只有一帧时去掉多帧包头，按普通数据包发送
+    std::string_view data(output.data);
+    size_t frame_header = NET_MULTI_FRAME_HEADER_SIZE + sizeof(uint32_t);
+    if (output.frames == 1) {
+        data.remove_prefix(frame_header);
+    }
+    sends_.fetch_add(1, std::memory_order_relaxed);
+    ToolBox::ENetErrCode err = network_->Send(conn_id, data.data(), static_cast<uint32_t>(data.size()));
+    if (err != ToolBox::ENetErrCode::NET_SUCCESS) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        BaseNodeLogError("[NetOutputQueue] Send_: failed to send %u frames, conn_id: %lu, bytes: %zu, error: %d",
+                         output.frames, conn_id, data.size(), static_cast<int>(err));
+        if (on_send_failed_) {
+            on_send_failed_(conn_id, output.frames, err);
+        }
+    }
+    // 保留缓冲区容量，下一轮复用
+    output.data.clear();
+    output.frames = 0;
+    --pending_connections_;
+}
+
+} // namespace BaseNode
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "module/module_rpc_batch.h"
+#include "network/network_api.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace BaseNode
+{
+
+#define NET_MULTI_FRAME_MAGIC 0x464D4E42u               // 多帧包的包头（"BNMF"，小端），RPC 协议头的第一个字节是协议 magic，不会与之相同
+#define NET_MULTI_FRAME_HEADER_SIZE 4
+#define NET_OUTPUT_DEFAULT_MAX_FRAMES 256               // 单个多帧包最多合并的帧数，达到后立即发送
+#define NET_OUTPUT_DEFAULT_MAX_BYTES (256 * 1024)       // 单个多帧包的最大字节数，达到后立即发送
+
+/**
+ * @brief 多帧包：发往同一连接的多个 RPC 帧合并成网络库的一个包，一次 Send（一次写系统调用）发出
+ *
+ * 布局为 magic(4 字节小端) | 长度 | 帧 | 长度 | 帧 ...，帧的排列与 RpcBatchFrame 相同。
+ * 只有一帧时不加包头，按普通数据包发送，接收方对两种格式都能处理。
+ *
+ * 多帧包是新的线上格式，不认识它的旧版本进程会把整个包当成一帧解析失败。network.output.coalesce
+ * 默认关闭，只有连接两端都是支持多帧包的版本（滚动升级完成后）才能在发送方打开。
+ */
+class NetMultiFrame
+{
+public:
+    static bool IsMultiFrame(std::string_view packet);
+
+    /**
+     * @brief 逐帧处理收到的包：多帧包按帧拆开（帧指向 packet 内部），普通包整体作为一帧
+     * @param func 回调 void(size_t offset, std::string_view frame)，offset 为帧在 packet 中的偏移
+     * @return 帧数
+     */
+    template <typename Func>
+    static size_t ForEachFrame(std::string_view packet, Func&& func);
+};
+
+/**
+ * @brief 按连接聚合的发送队列配置，对应配置文件中的 {config_name}.network.output
+ */
+struct NetOutputOptions
+{
+    bool coalesce = false;                              // 合并发送多帧包，对端须能解析多帧包；false 时每帧直接 Send（原有行为）
+    uint32_t max_frames = NET_OUTPUT_DEFAULT_MAX_FRAMES;
+    uint32_t max_bytes = NET_OUTPUT_DEFAULT_MAX_BYTES;
+};
+
+/**
+ * @brief 发送 / 接收统计（frames / sends 即每次系统调用发出的帧数）
+ */
+struct NetFrameStats
+{
+    uint64_t frames = 0;            // 帧数
+    uint64_t packets = 0;           // 网络库的包数（发送为 Send 次数，接收为收到的包数）
+    uint64_t flush_full = 0;        // 因达到 max_frames / max_bytes 发送的次数
+    uint64_t errors = 0;            // 发送失败或格式错误的包数
+};
+
+/**
+ * @brief 按连接聚合的发送队列（只在驱动网络库的线程上访问，统计可以在任意线程读取）
+ *
+ * 一轮收包处理中发往同一连接的帧先放入该连接的队列，在本轮结束时（Flush）合并成一个多帧包发送，
+ * 帧最多等待到本轮收包处理结束；达到 max_frames / max_bytes 时立即发送。
+ */
+class NetOutputQueue
+{
+public:
+    /**
+     * @brief 合并发送失败的回调 void(uint64_t conn_id, uint32_t frames, ToolBox::ENetErrCode err)
+     */
+    using SendFailedFunc = std::function<void(uint64_t, uint32_t, ToolBox::ENetErrCode)>;
+
+    void Configure(const NetOutputOptions& options) { options_ = options; }
+    void SetNetwork(ToolBox::Network* network) { network_ = network; }
+    void SetOnSendFailed(SendFailedFunc func) { on_send_failed_ = std::move(func); }
+
+    /**
+     * @brief 发送一帧（coalesce 为 false 时直接发送）
+     * @return 直接发送时的错误码；放入队列时返回 NET_SUCCESS，之后的发送错误计入统计并经 SetOnSendFailed 的回调报告
+     */
+    ToolBox::ENetErrCode Send(uint64_t conn_id, std::string_view frame);
+
+    /**
+     * @brief 发送所有连接的队列
+     */
+    void Flush();
+
+    /**
+     * @brief 丢弃连接的队列（连接关闭时调用）
+     */
+    void Discard(uint64_t conn_id);
+
+    void Clear();
+
+    NetFrameStats GetStats() const;
+
+private:
+    struct PendingOutput
+    {
+        std::string data;           // 多帧包（含包头）
+        uint32_t frames = 0;
+    };
+
+    void Send_(uint64_t conn_id, PendingOutput& output);
+
+private:
+    NetOutputOptions options_;
+    ToolBox::Network* network_ = nullptr;
+    SendFailedFunc on_send_failed_;
+    std::unordered_map<uint64_t, PendingOutput> pending_;  // 连接ID -> 待发送的帧
+    size_t pending_connections_ = 0;
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> sends_{0};
+    std::atomic<uint64_t> flush_full_{0};
+    std::atomic<uint64_t> errors_{0};
+};
+
+template <typename Func>
+size_t NetMultiFrame::ForEachFrame(std::string_view packet, Func&& func)
+{
+    if (!IsMultiFrame(packet)) {
+        func(0, packet);
+        return 1;
+    }
+    size_t frames = 0;
+    size_t offset = NET_MULTI_FRAME_HEADER_SIZE;
+    std::string_view frame;
+    while (RpcBatchFrame::Next(packet, offset, frame)) {
+        func(static_cast<size_t>(frame.data() - packet.data()), frame);
+        ++frames;
+    }
+    return frames;
+}
+
+} // namespace BaseNode
@@ -2,7 +2,11 @@
 #include "module/module_router.h"
 #include "utils/basenode_def_internal.h"
 #include "config/config_manager.h"
+#include "plugin_system/plugin_descriptor.h"
 #include <pthread.h>
+#include <algorithm>
+#include <chrono>
+#include <future>
 
 namespace BaseNode
 {
@@ -13,6 +17,7 @@ Network::Network()
 
 Network::~Network()
 {
+    StopIngressThread_();
     if (network_impl_)
     {
         delete network_impl_;
@@ -45,6 +50,8 @@ ErrorCode Network::DoInit()
         listen_ip = ConfigMgr->Get<std::string>(config_name, listen_ip_path, "0.0.0.0");
         listen_port = static_cast<uint16_t>(ConfigMgr->Get<int>(config_name, listen_port_path, 9527));
         BaseNodeLogInfo("[Network] Loaded listen config from '%s': %s:%d", config_name.c_str(), listen_ip.c_str(), listen_port);
+        LoadIngressOptions_(config_name);
+        LoadOutputOptions_(config_name);
     } else {
         BaseNodeLogWarn("[Network] No config name in ConfigManager (GetLoadedConfigNames empty), using default worker_threads: %d, listen: %s:%d", worker_threads, listen_ip.c_str(), listen_port);
     }
@@ -67,6 +74,8 @@ ErrorCode Network::DoInit()
         BaseNodeLogInfo("[Network] Accept called: %s:%d", listen_ip.c_str(), listen_port);
     }
     
+    output_.SetNetwork(network_impl_);
+
     // 启动网络库
     if (!network_impl_->Start(worker_threads))
     {
@@ -83,12 +92,7 @@ ErrorCode Network::DoInit()
     // 设置网络接收回调，使用ModuleRouter路由RPC数据包
     // RouterModule 会主动连接业务进程，接收来自 RouterModule 的请求
     network_impl_->SetOnReceived([this](ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id, const char* data, size_t size) {
-        // 创建 std::string 并移动传递，避免拷贝
-        std::string data_str(data, size);
-        ErrorCode err = ModuleRouterMgr->RouteProtocolPacket(std::move(data_str));
-        if (err != ErrorCode::BN_SUCCESS) {
-            BaseNodeLogWarn("[Network] Failed to route protocol packet, error: %d, size: %zu", static_cast<int>(err), size);
-        }
+        OnReceived_(data, size);
     });
 
     // 设置连接接受回调（RouterModule 主动连接时会触发）
@@ -103,6 +107,15 @@ ErrorCode Network::DoInit()
     SetServerSendCallback([this](uint64_t, std::string &&){
 
     });
+
+    // 回调都设置好之后再启动收包线程，此后 network_impl_->Update() 只在收包线程上调用，
+    // 其他模块替换回调、发起连接等操作经 PostIngressTask 在收包线程上执行
+    if (ingress_dedicated_thread_) {
+        ingress_running_.store(true, std::memory_order_release);
+        ingress_thread_ = std::thread(&Network::IngressLoop_, this);
+        BaseNodeLogInfo("[Network] Ingress thread started, idle_sleep_us: %u, idle_max_sleep_us: %u",
+                        ingress_idle_sleep_us_, ingress_idle_max_sleep_us_);
+    }
     
     BaseNodeLogInfo("Network Init success");
     return ErrorCode::BN_SUCCESS;
@@ -110,10 +123,10 @@ ErrorCode Network::DoInit()
 
 ErrorCode Network::DoUpdate()
 {
-    // 驱动网络库主线程事件处理
-    if (network_impl_)
+    // 驱动网络库主线程事件处理（使用收包线程时由收包线程驱动）
+    if (network_impl_ && !ingress_dedicated_thread_)
     {
-        network_impl_->Update();
+        PollOnce_();
     }
     return ErrorCode::BN_SUCCESS;
 }
@@ -122,6 +135,22 @@ ErrorCode Network::DoUninit()
 {
     BaseNodeLogInfo("Network DoUninit");
     
+    // 先停止收包线程，之后不再有线程调用 network_impl_->Update()
+    StopIngressThread_();
+    {
+        std::lock_guard<std::mutex> lock(ingress_tasks_mutex_);
+        if (!ingress_tasks_.empty()) {
+            BaseNodeLogWarn("[Network] DoUninit: drop %zu pending ingress tasks", ingress_tasks_.size());
+        }
+        ingress_tasks_.clear();
+        ingress_tasks_pending_.store(false, std::memory_order_relaxed);
+    }
+    output_.Clear();
+    NetFrameStats ingress = GetIngressStats();
+    NetFrameStats output = GetOutputStats();
+    BaseNodeLogInfo("[Network] ingress: packets: %lu, frames: %lu, errors: %lu; output: frames: %lu, sends: %lu, flush_full: %lu, errors: %lu",
+                    ingress.packets, ingress.frames, ingress.errors, output.frames, output.packets, output.flush_full, output.errors);
+
     if (network_impl_)
     {
         // 停止并等待工作线程结束
@@ -135,16 +164,158 @@ ErrorCode Network::DoUninit()
     return ErrorCode::BN_SUCCESS;
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT() {
+void Network::LoadIngressOptions_(const std::string& config_name)
+{
+    // {config_name}.network.ingress：收包线程配置
+    std::string ingress_path = config_name + ".network.ingress";
+    ingress_dedicated_thread_ = ConfigMgr->Get<bool>(config_name, ingress_path + ".dedicated_thread", true);
+    int idle_sleep_us = ConfigMgr->Get<int>(config_name, ingress_path + ".idle_sleep_us", NETWORK_INGRESS_IDLE_SLEEP_US);
+    ingress_idle_sleep_us_ = idle_sleep_us > 0 ? static_cast<uint32_t>(idle_sleep_us) : 0;
+    int idle_max_sleep_us = ConfigMgr->Get<int>(config_name, ingress_path + ".idle_max_sleep_us", NETWORK_INGRESS_IDLE_MAX_SLEEP_US);
+    ingress_idle_max_sleep_us_ = std::max(ingress_idle_sleep_us_, idle_max_sleep_us > 0 ? static_cast<uint32_t>(idle_max_sleep_us) : 0u);
+    BaseNodeLogInfo("[Network] Loaded ingress config from '%s': dedicated_thread: %d, idle_sleep_us: %u, idle_max_sleep_us: %u",
+                    config_name.c_str(), ingress_dedicated_thread_, ingress_idle_sleep_us_, ingress_idle_max_sleep_us_);
+}
+
+void Network::LoadOutputOptions_(const std::string& config_name)
+{
+    // {config_name}.network.output：按连接聚合发送的配置
+    std::string output_path = config_name + ".network.output";
+    NetOutputOptions options;
+    options.coalesce = ConfigMgr->Get<bool>(config_name, output_path + ".coalesce", options.coalesce);
+    options.max_frames = std::max(1, ConfigMgr->Get<int>(config_name, output_path + ".max_frames", static_cast<int>(options.max_frames)));
+    options.max_bytes = std::max(1, ConfigMgr->Get<int>(config_name, output_path + ".max_bytes", static_cast<int>(options.max_bytes)));
+    output_.Configure(options);
+    BaseNodeLogInfo("[Network] Loaded output config from '%s': coalesce: %d, max_frames: %u, max_bytes: %u",
+                    config_name.c_str(), options.coalesce, options.max_frames, options.max_bytes);
+}
+
+void Network::PostIngressTask(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(ingress_tasks_mutex_);
+    ingress_tasks_.push_back(std::move(task));
+    ingress_tasks_pending_.store(true, std::memory_order_release);
+}
+
+void Network::RunIngressTaskAndWait(std::function<void()> task)
+{
+    if (!ingress_running_.load(std::memory_order_acquire) || std::this_thread::get_id() == ingress_thread_.get_id()) {
+        RunIngressTasks_();
+        task();
+        return;
+    }
+    std::promise<void> done;
+    std::future<void> future = done.get_future();
+    PostIngressTask([&task, &done]() {
+        task();
+        done.set_value();
+    });
+    future.wait();
+}
+
+bool Network::RunIngressTasks_()
+{
+    if (!ingress_tasks_pending_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(ingress_tasks_mutex_);
+        tasks.swap(ingress_tasks_);
+        ingress_tasks_pending_.store(false, std::memory_order_relaxed);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+    return !tasks.empty();
+}
+
+NetFrameStats Network::GetIngressStats() const
+{
+    NetFrameStats stats;
+    stats.packets = ingress_packets_.load(std::memory_order_relaxed);
+    stats.frames = ingress_frames_.load(std::memory_order_relaxed);
+    stats.errors = ingress_errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Network::OnReceived_(const char* data, size_t size)
+{
+    ingress_packets_.fetch_add(1, std::memory_order_relaxed);
+    // 直接填充缓冲池切片，多帧包的各帧是它的子切片，之后路由、入队、RPC 解析全程共享这块内存
+    BufferSlice packet = BufferSlice::CopyFrom(data, size);
+    size_t frames = NetMultiFrame::ForEachFrame(packet.View(), [this, &packet](size_t offset, std::string_view frame) {
+        ingress_batch_.push_back(packet.Slice(offset, frame.size()));
+    });
+    if (frames == 0) {
+        ingress_errors_.fetch_add(1, std::memory_order_relaxed);
+        BaseNodeLogWarn("[Network] OnReceived_: malformed multi-frame packet, size: %zu", size);
+        return;
+    }
+    ingress_frames_.fetch_add(frames, std::memory_order_relaxed);
+}
+
+bool Network::PollOnce_()
+{
+    bool ran_tasks = RunIngressTasks_();
+    uint64_t packets = ingress_packets_.load(std::memory_order_relaxed);
+    network_impl_->Update();
+    if (!ingress_batch_.empty()) {
+        // 路由快照查找无锁，PushModuleEvent 可在任意线程调用，入队后唤醒目标模块所在的线程
+        size_t frames = ingress_batch_.size();
+        size_t failed = ModuleRouterMgr->RouteProtocolPackets(ingress_batch_);
+        if (failed > 0) {
+            ingress_errors_.fetch_add(failed, std::memory_order_relaxed);
+            BaseNodeLogWarn("[Network] PollOnce_: failed to route %zu of %zu frames", failed, frames);
+        }
+    }
+    output_.Flush();
+    return ran_tasks || ingress_packets_.load(std::memory_order_relaxed) != packets;
+}
+
+void Network::IngressLoop_()
+{
+    pthread_setname_np(pthread_self(), "bn_net_ingress");
+    BaseNodeLogInfo("[Network] IngressLoop_: started");
+    uint32_t sleep_us = ingress_idle_sleep_us_;
+    while (ingress_running_.load(std::memory_order_acquire)) {
+        // 本轮收到了数据（或执行了任务，如发起连接）时立即再取一轮
+        if (PollOnce_()) {
+            sleep_us = ingress_idle_sleep_us_;
+            continue;
+        }
+        if (sleep_us == 0) {
+            continue;
+        }
+        // 空闲时休眠，连续空闲时逐轮加倍直到上限，避免空闲进程频繁唤醒
+        ingress_idle_sleeps_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        sleep_us = std::min(sleep_us * 2, ingress_idle_max_sleep_us_);
+    }
+    BaseNodeLogInfo("[Network] IngressLoop_: stopped, idle sleeps: %lu", ingress_idle_sleeps_.load(std::memory_order_relaxed));
+}
+
+void Network::StopIngressThread_()
+{
+    ingress_running_.store(false, std::memory_order_release);
+    if (ingress_thread_.joinable()) {
+        ingress_thread_.join();
+    }
+}
+
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
     NetworkMgr->Init();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
+static void UpdatePlugin() {
     NetworkMgr->Update();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT() {
+static void UninitPlugin() {
     NetworkMgr->UnInit();
 }
 
+BASENODE_PLUGIN_DESCRIPTOR("network", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
+
 } // namespace BaseNode
\ No newline at end of file
@@ -2,12 +2,35 @@
 
 #include "module_interface.h"
 #include "network/network_api.h"
+#include "net_frame_batch.h"
 #include "tools/singleton.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace BaseNode
 {
 
-class Network : public IModule
+#define NETWORK_INGRESS_IDLE_SLEEP_US 50        // 收包线程一轮没有收到数据时的初始休眠时间（微秒）
+#define NETWORK_INGRESS_IDLE_MAX_SLEEP_US 1000  // 连续空闲时休眠时间逐轮加倍的上限（微秒）
+
+/**
+ * @brief 网络模块
+ *
+ * 网络库的回调在 network_impl_->Update() 中触发。network.ingress.dedicated_thread 为 true（默认）时
+ * 由独立的收包线程驱动 Update：收到的包直接解析协议头，经 ModuleRouter 的无锁路由快照投递到目标模块的邮箱，
+ * 并唤醒驱动该模块的线程（主循环或 actor），收包延迟不再受主循环 tick 周期影响。
+ * 为 false 时保持原有行为，在主循环的 DoUpdate 中驱动。
+ *
+ * 每轮 Update 收到的包（多帧包拆成各帧，见 NetMultiFrame）攒成一批，在本轮结束时整批交给 ModuleRouter；
+ * network.output.coalesce 打开时（默认关闭，对端须能解析多帧包，见 NetMultiFrame），SendFrame 发出的帧按连接聚合，
+ * 同样在本轮结束时每个连接合并成一个包发送（见 NetOutputQueue）。
+ */
+class Network : public ModuleBase<Network>
 {
 public:
     Network();
@@ -16,13 +39,96 @@ public:
     // 提供访问底层网络库的接口（可选，用于高级功能）
     ToolBox::Network* GetNetwork() { return network_impl_; }
 
+    /**
+     * @brief 在驱动网络库的线程（收包线程，或不使用收包线程时的主循环）上执行任务，可在任意线程调用
+     *
+     * 任务在下一轮 Update 之前按提交顺序执行。替换网络库回调、Connect / Close、访问按连接聚合的发送队列等
+     * 只能在驱动网络库的线程上进行的操作都经由这里（如 RouterModule）。卸载时尚未执行的任务被丢弃。
+     */
+    void PostIngressTask(std::function<void()> task);
+
+    /**
+     * @brief 同 PostIngressTask，但等待任务（及之前投递的任务）执行完再返回
+     *
+     * 收包线程未运行或在驱动网络库的线程上调用时直接执行。用于卸载：模块卸载后插件随即被 dlclose，
+     * 替换回调等任务必须在返回前完成。
+     */
+    void RunIngressTaskAndWait(std::function<void()> task);
+
+    /**
+     * @brief 发送一帧（只在驱动网络库的线程上调用）
+     *
+     * coalesce 打开时按连接聚合，在本轮 Update 结束时合并发送，返回 NET_SUCCESS，发送失败经 SetOnOutputFailed 的回调报告；
+     * 否则直接发送并返回网络库的错误码。
+     */
+    ToolBox::ENetErrCode SendFrame(uint64_t conn_id, std::string_view frame) { return output_.Send(conn_id, frame); }
+
+    /**
+     * @brief 设置合并发送失败的回调（只在驱动网络库的线程上调用）
+     */
+    void SetOnOutputFailed(NetOutputQueue::SendFailedFunc func) { output_.SetOnSendFailed(std::move(func)); }
+
+    /**
+     * @brief 丢弃连接上尚未发送的帧（连接关闭时调用）
+     */
+    void DiscardOutput(uint64_t conn_id) { output_.Discard(conn_id); }
+
+    NetFrameStats GetIngressStats() const;
+    NetFrameStats GetOutputStats() const { return output_.GetStats(); }
+
 protected:
     virtual ErrorCode DoInit() override;
     virtual ErrorCode DoUpdate() override;
     virtual ErrorCode DoUninit() override;
 
+private:
+    void LoadIngressOptions_(const std::string& config_name);
+    void LoadOutputOptions_(const std::string& config_name);
+
+    /**
+     * @brief 收到数据包（在驱动 network_impl_->Update() 的线程上调用），拆帧后加入本轮的批次
+     */
+    void OnReceived_(const char* data, size_t size);
+
+    /**
+     * @brief 驱动网络库一轮：执行投递的任务，Update，然后把本轮收到的帧整批路由，发送各连接聚合的帧
+     * @return 本轮是否收到了数据或执行了任务
+     */
+    bool PollOnce_();
+
+    /**
+     * @return 是否执行了任务
+     */
+    bool RunIngressTasks_();
+
+    /**
+     * @brief 收包线程：循环驱动网络库，一轮没有收到数据时休眠
+     *
+     * 网络库没有提供可等待的就绪通知，空闲时只能轮询：休眠时间从 idle_sleep_us 开始，连续空闲时逐轮加倍，
+     * 直到 idle_max_sleep_us（与主循环的空闲模式对应，空闲进程每秒只唤醒约 1000000 / idle_max_sleep_us 次），
+     * 收到数据后恢复为 idle_sleep_us。idle_sleep_us 为 0 时一直忙轮询。
+     */
+    void IngressLoop_();
+    void StopIngressThread_();
+
 private:
     ToolBox::Network* network_impl_;  // 第三方网络库实例
+
+    bool ingress_dedicated_thread_ = true;
+    uint32_t ingress_idle_sleep_us_ = NETWORK_INGRESS_IDLE_SLEEP_US;
+    uint32_t ingress_idle_max_sleep_us_ = NETWORK_INGRESS_IDLE_MAX_SLEEP_US;
+    std::atomic<uint64_t> ingress_idle_sleeps_{0};      // 收包线程空闲休眠的次数
+    std::thread ingress_thread_;
+    std::atomic<bool> ingress_running_{false};
+    std::vector<BufferSlice> ingress_batch_;            // 本轮收到的帧（只在驱动网络库的线程上访问）
+    std::atomic<uint64_t> ingress_packets_{0};          // 收到的包数（即读取次数）
+    std::atomic<uint64_t> ingress_frames_{0};           // 收到的帧数
+    std::atomic<uint64_t> ingress_errors_{0};           // 格式错误或路由失败的帧数
+    std::mutex ingress_tasks_mutex_;
+    std::vector<std::function<void()>> ingress_tasks_;  // PostIngressTask 投递的任务
+    std::atomic<bool> ingress_tasks_pending_{false};    // 有未执行的任务（收包线程无锁检查）
+
+    NetOutputQueue output_;
 };
 
 #define NetworkMgr ToolBox::Singleton<Network>::Instance()
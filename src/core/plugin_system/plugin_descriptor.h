@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include "utils/basenode_def_internal.h"
+
+namespace BaseNode
+{
+
+#define BASENODE_PLUGIN_ABI_VERSION 1                                   // PluginDescriptor 布局变化（删除或调整已有字段）时递增
+#define BASENODE_PLUGIN_DESCRIPTOR_FUNC basenodePluginDescriptor
+#define BASENODE_PLUGIN_DESCRIPTOR_SYMBOL "basenodePluginDescriptor"
+
+// 插件入口函数类型
+using PluginEntryFunc = void (*)(void);
+
+/**
+ * @brief 插件描述符：插件导出的唯一入口，加载时解析一次
+ *
+ * 只在末尾追加字段时 abi_version 不变，加载方用 struct_size 判断新字段是否存在。
+ * 入口函数可以为 nullptr（插件没有对应的逻辑）。
+ */
+struct PluginDescriptor
+{
+    uint32_t abi_version;               // BASENODE_PLUGIN_ABI_VERSION
+    uint32_t struct_size;               // sizeof(PluginDescriptor)
+    const char* name;                   // 插件名，用于日志
+    const char* version;                // 插件版本，用于日志
+    PluginEntryFunc init;               // 加载后调用一次
+    PluginEntryFunc update;             // 主循环每次 tick 调用
+    PluginEntryFunc uninit;             // 卸载前调用一次
+    PluginEntryFunc after_all_init;     // 所有插件 init 完成后调用一次
+};
+
+using PluginDescriptorFunc = const PluginDescriptor* (*)(void);
+
+#define BASENODE_STATIC_PLUGIN_SECTION "basenode_plugins"              // 单体构建的链接期注册表所在的段（须为合法的 C 标识符）
+
+/**
+ * @brief 链接期注册表的表项（BASENODE_MONOLITH 构建）
+ *
+ * 单体构建中各模块静态链接进主程序，BASENODE_PLUGIN_DESCRIPTOR 把表项放入 BASENODE_STATIC_PLUGIN_SECTION 段，
+ * 链接器把所有模块的表项拼成一张表（__start_basenode_plugins ~ __stop_basenode_plugins），加载方按库文件名查找。
+ */
+struct StaticPluginEntry
+{
+    const char* library_name;           // 动态构建时的库文件名（BASENODE_PLUGIN_LIBRARY_NAME），如 libplayer_module.so
+    PluginDescriptorFunc descriptor;
+};
+
+} // namespace BaseNode
+
+#define BASENODE_PLUGIN_DESCRIPTOR_BODY_(plugin_name, plugin_version, init_func, update_func, uninit_func, after_all_init_func) \
+    {                                                                                                                     \
+        static const BaseNode::PluginDescriptor descriptor = {                                                            \
+            BASENODE_PLUGIN_ABI_VERSION, sizeof(BaseNode::PluginDescriptor), plugin_name, plugin_version,                 \
+            init_func, update_func, uninit_func, after_all_init_func};                                                    \
+        return &descriptor;                                                                                               \
+    }
+
+/**
+ * @brief 导出插件描述符
+ *
+ * 入口函数应为本文件内的 static 函数：导出的同名符号（如各插件都有的 initSo）在 RTLD_GLOBAL 下
+ * 可能被先加载的库中的同名符号覆盖，取地址时不一定得到本插件的实现。
+ *
+ * 单体构建（BASENODE_MONOLITH）中不导出符号（各模块的 basenodePluginDescriptor 会重复定义），
+ * 改为在链接期注册表中登记；BASENODE_PLUGIN_LIBRARY_NAME 由 CMake 为每个模块定义。
+ */
+#if defined(BASENODE_MONOLITH)
+#define BASENODE_PLUGIN_DESCRIPTOR(plugin_name, plugin_version, init_func, update_func, uninit_func, after_all_init_func) \
+    static const BaseNode::PluginDescriptor* BasenodeStaticPluginDescriptor()                                            \
+    BASENODE_PLUGIN_DESCRIPTOR_BODY_(plugin_name, plugin_version, init_func, update_func, uninit_func, after_all_init_func) \
+    __attribute__((used, section(BASENODE_STATIC_PLUGIN_SECTION)))                                                        \
+    static const BaseNode::StaticPluginEntry basenode_static_plugin_entry = {                                            \
+        BASENODE_PLUGIN_LIBRARY_NAME, &BasenodeStaticPluginDescriptor};
+#else
+#define BASENODE_PLUGIN_DESCRIPTOR(plugin_name, plugin_version, init_func, update_func, uninit_func, after_all_init_func) \
+    extern "C" SO_EXPORT_SYMBOL const BaseNode::PluginDescriptor* BASENODE_PLUGIN_DESCRIPTOR_FUNC()                       \
+    BASENODE_PLUGIN_DESCRIPTOR_BODY_(plugin_name, plugin_version, init_func, update_func, uninit_func, after_all_init_func)
+#endif
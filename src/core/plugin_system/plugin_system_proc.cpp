@@ -6,20 +6,40 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #if defined(PLATFORM_WINDOWS)
     #include <windows.h>
 #else
     #include <dlfcn.h>
 #endif
 
+#if defined(BASENODE_MONOLITH)
+// 链接器为段 BASENODE_STATIC_PLUGIN_SECTION 生成的起止符号（没有模块登记时为 nullptr）
+extern "C" const BaseNode::StaticPluginEntry __start_basenode_plugins[] __attribute__((weak));
+extern "C" const BaseNode::StaticPluginEntry __stop_basenode_plugins[] __attribute__((weak));
+#endif
+
 namespace BaseNode
 {
 
+static int64_t SteadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 int PluginLoadManager::Init()
 {
     std::filesystem::path cwd = std::filesystem::current_path();
     std::string lib_dir = cwd.string() + "/lib";
     std::vector<std::string> modules;
+    nlohmann::json depends_json = nlohmann::json::object();
+    nlohmann::json trusted_json = nlohmann::json::array();
+    bool parallel_init = false;
     
     // 自动检测已加载的配置名称
     // 支持通过不同配置文件加载不同的 .so 模块
@@ -60,6 +80,13 @@ int PluginLoadManager::Init()
             }
             BaseNodeLogInfo("[PluginLoadManager] Loaded %zu modules from config '%s'", modules.size(), config_name.c_str());
         }
+
+        // {config_name}.plugins.depends：插件 -> 需要先完成 initSo 的插件列表
+        // {config_name}.plugins.parallel_init：互不依赖的插件并行加载
+        depends_json = ConfigMgr->Get<nlohmann::json>(config_name, config_name + ".plugins.depends", nlohmann::json::object());
+        parallel_init = ConfigMgr->Get<bool>(config_name, config_name + ".plugins.parallel_init", false);
+        // {config_name}.plugins.trusted：update 不经过 SafeCall 的插件
+        trusted_json = ConfigMgr->Get<nlohmann::json>(config_name, config_name + ".plugins.trusted", nlohmann::json::array());
     }
     
     // 如果配置中没有模块列表，使用默认值
@@ -75,14 +102,23 @@ int PluginLoadManager::Init()
         };
     }
     
-    // 依次加载所有模块
-    for (const auto& module : modules) {
-        std::string module_path = lib_dir + "/" + module;
-        if (LoadPluginSo_(module_path) != 0) {
-            BaseNodeLogError("[PluginLoadManager] Failed to load module: %s", module_path.c_str());
-            return -1;
-        }
-        BaseNodeLogInfo("[PluginLoadManager] load module:%s", module.c_str());
+#if defined(BASENODE_MONOLITH)
+    std::string linked_modules;
+    for (const StaticPluginEntry* entry = __start_basenode_plugins; entry != __stop_basenode_plugins; ++entry) {
+        linked_modules += linked_modules.empty() ? entry->library_name : std::string(", ") + entry->library_name;
+    }
+    BaseNodeLogInfo("[PluginLoadManager] monolith build, linked modules: %s", linked_modules.c_str());
+#endif
+
+    std::vector<PluginLoadStep> steps;
+    if (BuildLoadGraph_(modules, lib_dir, depends_json, trusted_json, parallel_init, steps) != 0) {
+        return -1;
+    }
+    int64_t begin_ns = SteadyNowNs();
+    int ret = RunLoadGraph_(steps, parallel_init);
+    LogLoadTimings_(steps, SteadyNowNs() - begin_ns);
+    if (ret != 0) {
+        return -1;
     }
     BaseNodeLogInfo("[PluginLoadManager] load all module done. size:%d", modules.size());
     AfterAllModulesInit_();
@@ -93,35 +129,306 @@ int PluginLoadManager::Init()
 int PluginLoadManager::Update()
 {
     // BaseNodeLogDebug("PluginLoadManager Update------------------------------------------------------------------------------------------------");
-    for (auto& [so_path, handle] : plugin_map_) {
-        if (!handle) continue; // 跳过无效 handle
-        SafeCallSimple_(handle, so_path, "updateSo");
+    for (const auto& plugin : plugins_) {
+        if (!plugin.update) {
+            continue;
+        }
+        if (plugin.trusted) {
+            plugin.update();
+        } else {
+            SafeCallSimple_(plugin.update, plugin.update_context);
+        }
     }
     return 0;
 }
 
 int PluginLoadManager::Uninit()
 {
-    for (auto& [so_path, handle] : plugin_map_) {
-        CloseDynamicLibrary_(handle, so_path);
+    // 逆序卸载：依赖方先于被依赖方
+    for (auto it = plugins_.rbegin(); it != plugins_.rend(); ++it) {
+        CloseDynamicLibrary_(*it);
     }
+    plugins_.clear();
     return 0;
 }
 
-int PluginLoadManager::LoadPluginSo_(const std::string& so_path)
+int PluginLoadManager::BuildLoadGraph_(const std::vector<std::string>& modules, const std::string& lib_dir, const nlohmann::json& depends_json,
+                                       const nlohmann::json& trusted_json, bool parallel_init, std::vector<PluginLoadStep>& steps)
 {
-    // 加载动态库
-    void* handle = LoadDynamicLibrary_(so_path.c_str());
-    if (!handle) {
-        BaseNodeLogError("dlopen error: %s\n", GetLastLibraryError_().c_str());
+    std::map<std::string, size_t> index_of;
+    steps.resize(modules.size());
+    for (size_t i = 0; i < modules.size(); ++i) {
+        steps[i].plugin.name = modules[i];
+        steps[i].plugin.so_path = lib_dir + "/" + modules[i];
+        index_of[modules[i]] = i;
+    }
+    if (trusted_json.is_array()) {
+        for (const auto& trusted : trusted_json) {
+            auto it = trusted.is_string() ? index_of.find(trusted.get<std::string>()) : index_of.end();
+            if (it == index_of.end()) {
+                BaseNodeLogWarn("[PluginLoadManager] BuildLoadGraph_: trusted plugin %s is not in plugins.modules", trusted.dump().c_str());
+                continue;
+            }
+            steps[it->second].plugin.trusted = true;
+        }
+    }
+
+    auto add_edge = [&steps](size_t from, size_t to) {
+        std::vector<size_t>& dependents = steps[from].dependents;
+        if (from != to && std::find(dependents.begin(), dependents.end(), to) == dependents.end()) {
+            dependents.push_back(to);
+            ++steps[to].pending_depends;
+        }
+    };
+
+    auto core_it = index_of.find(PLUGIN_CORE_SO_NAME);
+    // 服务发现插件依赖的插件不能再隐式依赖它，否则成环
+    auto discovery_it = index_of.find(PLUGIN_SERVICE_DISCOVERY_SO_NAME);
+    std::vector<bool> discovery_depends(steps.size(), false);
+    if (discovery_it != index_of.end()) {
+        auto depends_it = depends_json.find(PLUGIN_SERVICE_DISCOVERY_SO_NAME);
+        if (depends_it != depends_json.end() && depends_it->is_array()) {
+            for (const auto& depend : *depends_it) {
+                auto it = depend.is_string() ? index_of.find(depend.get<std::string>()) : index_of.end();
+                if (it != index_of.end()) {
+                    discovery_depends[it->second] = true;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (!parallel_init) {
+            // 保持原有行为：按配置顺序逐个加载
+            if (i > 0) {
+                add_edge(i - 1, i);
+            }
+            continue;
+        }
+        if (core_it != index_of.end()) {
+            add_edge(core_it->second, i);
+        }
+        // 模块 Init 时向服务发现注册（IModule::RegisterToZk_），服务发现必须先完成 initSo
+        if (discovery_it != index_of.end() && (core_it == index_of.end() || i != core_it->second) && !discovery_depends[i]) {
+            add_edge(discovery_it->second, i);
+        }
+        auto depends_it = depends_json.find(steps[i].plugin.name);
+        if (depends_it == depends_json.end() || !depends_it->is_array()) {
+            continue;
+        }
+        for (const auto& depend : *depends_it) {
+            auto it = depend.is_string() ? index_of.find(depend.get<std::string>()) : index_of.end();
+            if (it == index_of.end()) {
+                BaseNodeLogError("[PluginLoadManager] BuildLoadGraph_: %s depends on %s which is not in plugins.modules",
+                                 steps[i].plugin.name.c_str(), depend.dump().c_str());
+                return -1;
+            }
+            add_edge(it->second, i);
+        }
+    }
+
+    // 检查环：按拓扑序能走完所有步骤
+    std::vector<size_t> pending(steps.size());
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        pending[i] = steps[i].pending_depends;
+        if (pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t i = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t dependent : steps[i].dependents) {
+            if (--pending[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (visited != steps.size()) {
+        for (size_t i = 0; i < steps.size(); ++i) {
+            if (pending[i] != 0) {
+                BaseNodeLogError("[PluginLoadManager] BuildLoadGraph_: dependency cycle involving %s", steps[i].plugin.name.c_str());
+            }
+        }
         return -1;
     }
-    plugin_map_[so_path] = handle;
-    SafeCallSimple_(handle, so_path, "initSo");
-    BaseNodeLogInfo("[PluginLoadManager] load module:%s Finished --------------------------------------------------------------", so_path.c_str());
     return 0;
 }
 
+int PluginLoadManager::RunLoadGraph_(std::vector<PluginLoadStep>& steps, bool parallel_init)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> finished;        // 已完成、等待主线程处理的步骤
+    std::vector<std::thread> threads;
+    int64_t begin_ns = SteadyNowNs();
+
+    auto start = [&](size_t i) {
+        steps[i].started = true;
+        if (!parallel_init) {
+            // 逐个加载时仍在主线程执行 initSo
+            LoadPluginStep_(steps[i], begin_ns);
+            finished.push_back(i);
+            return;
+        }
+        threads.emplace_back([this, &steps, &mutex, &cv, &finished, i, begin_ns]() {
+            LoadPluginStep_(steps[i], begin_ns);
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(i);
+            cv.notify_one();
+        });
+    };
+
+    size_t running = 0;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (steps[i].pending_depends == 0) {
+            start(i);
+            ++running;
+        }
+    }
+
+    bool failed = false;
+    while (running > 0) {
+        size_t i = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&finished]() { return !finished.empty(); });
+            i = finished.front();
+            finished.pop_front();
+        }
+        --running;
+        PluginLoadStep& step = steps[i];
+        LoadedPlugin& plugin = step.plugin;
+        if (step.ok) {
+            // plugins_ 只在主线程修改
+            plugins_.push_back(plugin);
+        } else {
+            if (plugin.handle) {
+                // 已打开但入口不兼容，未执行 initSo
+                CloseDynamicLibrary_(plugin);
+            }
+            BaseNodeLogError("[PluginLoadManager] Failed to load module: %s", plugin.so_path.c_str());
+            failed = true;
+        }
+        BaseNodeLogInfo("[PluginLoadManager] load module:%s", plugin.name.c_str());
+        if (failed) {
+            continue;  // 不再启动新的步骤，等已启动的完成
+        }
+        for (size_t dependent : step.dependents) {
+            if (--steps[dependent].pending_depends == 0) {
+                start(dependent);
+                ++running;
+            }
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return failed ? -1 : 0;
+}
+
+void PluginLoadManager::LoadPluginStep_(PluginLoadStep& step, int64_t begin_ns)
+{
+    int64_t start_ns = SteadyNowNs();
+    step.start_ns = start_ns - begin_ns;
+    LoadedPlugin& plugin = step.plugin;
+#if defined(BASENODE_MONOLITH)
+    // 单体构建：模块已静态链接进主程序，不需要 dlopen，入口在 ResolveEntryPoints_ 中从链接期注册表取得
+    bool opened = FindStaticPlugin_(plugin.name) != nullptr;
+    if (!opened) {
+        BaseNodeLogError("[PluginLoadManager] %s is not linked into this binary (see BASENODE_MONOLITH_MODULES)", plugin.name.c_str());
+    }
+#else
+    // 加载动态库
+    plugin.handle = LoadDynamicLibrary_(plugin.so_path);
+    bool opened = plugin.handle != nullptr;
+    if (!opened) {
+        BaseNodeLogError("dlopen error: %s\n", GetLastLibraryError_().c_str());
+    }
+#endif
+    int64_t loaded_ns = SteadyNowNs();
+    step.dlopen_ns = loaded_ns - start_ns;
+    if (!opened) {
+        return;
+    }
+    if (!ResolveEntryPoints_(plugin)) {
+        return;
+    }
+    if (plugin.init) {
+        SafeCallSimple_(plugin.init, plugin.so_path + " FUNC[init]");
+    }
+    step.init_ns = SteadyNowNs() - loaded_ns;
+    step.ok = true;
+    BaseNodeLogInfo("[PluginLoadManager] load module:%s Finished --------------------------------------------------------------", plugin.so_path.c_str());
+}
+
+bool PluginLoadManager::ResolveEntryPoints_(LoadedPlugin& plugin)
+{
+#if defined(BASENODE_MONOLITH)
+    const StaticPluginEntry* entry = FindStaticPlugin_(plugin.name);
+    PluginDescriptorFunc descriptor_func = entry ? entry->descriptor : nullptr;
+#else
+    auto descriptor_func = reinterpret_cast<PluginDescriptorFunc>(GetOwnSymbolAddress_(plugin.handle, BASENODE_PLUGIN_DESCRIPTOR_SYMBOL));
+#endif
+    const PluginDescriptor* descriptor = descriptor_func ? descriptor_func() : nullptr;
+    if (descriptor) {
+        if (descriptor->abi_version != BASENODE_PLUGIN_ABI_VERSION || descriptor->struct_size < sizeof(PluginDescriptor)) {
+            BaseNodeLogError("[PluginLoadManager] %s: incompatible plugin descriptor, abi_version: %u (expected %u), struct_size: %u (expected >= %zu)",
+                             plugin.so_path.c_str(), descriptor->abi_version, BASENODE_PLUGIN_ABI_VERSION,
+                             descriptor->struct_size, sizeof(PluginDescriptor));
+            return false;
+        }
+        plugin.descriptor = descriptor;
+        plugin.init = descriptor->init;
+        plugin.update = descriptor->update;
+        plugin.uninit = descriptor->uninit;
+        plugin.after_all_init = descriptor->after_all_init;
+        BaseNodeLogInfo("[PluginLoadManager] %s: plugin %s version %s, abi_version: %u%s", plugin.so_path.c_str(),
+                        descriptor->name ? descriptor->name : "", descriptor->version ? descriptor->version : "",
+                        descriptor->abi_version, plugin.trusted ? ", trusted" : "");
+    } else {
+#if defined(BASENODE_MONOLITH)
+        BaseNodeLogError("[PluginLoadManager] %s: no plugin descriptor in the monolith registry", plugin.name.c_str());
+        return false;
+#endif
+        // 未导出描述符的旧插件：按符号名查找入口
+        plugin.init = reinterpret_cast<PluginEntryFunc>(GetOwnSymbolAddress_(plugin.handle, "initSo"));
+        plugin.update = reinterpret_cast<PluginEntryFunc>(GetOwnSymbolAddress_(plugin.handle, "updateSo"));
+        plugin.uninit = reinterpret_cast<PluginEntryFunc>(GetOwnSymbolAddress_(plugin.handle, "uninitSo"));
+        BaseNodeLogInfo("[PluginLoadManager] %s: no plugin descriptor, using initSo/updateSo/uninitSo%s", plugin.so_path.c_str(),
+                        plugin.trusted ? ", trusted" : "");
+    }
+    plugin.update_context = plugin.so_path + " FUNC[update]";
+    return true;
+}
+
+void PluginLoadManager::LogLoadTimings_(const std::vector<PluginLoadStep>& steps, int64_t total_ns)
+{
+    // 按开始时间排列，start 为相对加载开始的时间，可以看出哪些插件是并行加载的
+    std::vector<const PluginLoadStep*> ordered;
+    int64_t sum_ns = 0;
+    for (const auto& step : steps) {
+        if (!step.started) {
+            continue;
+        }
+        ordered.push_back(&step);
+        sum_ns += step.dlopen_ns + step.init_ns;
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const PluginLoadStep* a, const PluginLoadStep* b) {
+        return a->start_ns < b->start_ns;
+    });
+    BaseNodeLogInfo("[PluginLoadManager] startup timing: %-28s %10s %10s %10s %10s", "plugin", "start(ms)", "dlopen(ms)", "initSo(ms)", "total(ms)");
+    for (const PluginLoadStep* step : ordered) {
+        BaseNodeLogInfo("[PluginLoadManager] startup timing: %-28s %10.2f %10.2f %10.2f %10.2f%s", step->plugin.name.c_str(),
+                        step->start_ns / 1e6, step->dlopen_ns / 1e6, step->init_ns / 1e6, (step->dlopen_ns + step->init_ns) / 1e6,
+                        step->ok ? "" : "  FAILED");
+    }
+    BaseNodeLogInfo("[PluginLoadManager] startup timing: wall %.2fms, sum of plugins %.2fms", total_ns / 1e6, sum_ns / 1e6);
+}
+
 int PluginLoadManager::AfterAllModulesInit_()
 {
     BaseNodeLogInfo("[PluginLoadManager] AfterAllModulesInit_: calling all modules' AfterAllModulesInit via ModuleRouter");
@@ -134,10 +441,28 @@ int PluginLoadManager::AfterAllModulesInit_()
         return -1;
     }
     
+    for (const auto& plugin : plugins_) {
+        if (plugin.after_all_init) {
+            SafeCallSimple_(plugin.after_all_init, plugin.so_path + " FUNC[after_all_init]");
+        }
+    }
+
     BaseNodeLogInfo("[PluginLoadManager] AfterAllModulesInit_: completed successfully");
     return 0;
 }
 
+#if defined(BASENODE_MONOLITH)
+const StaticPluginEntry* PluginLoadManager::FindStaticPlugin_(const std::string& name)
+{
+    for (const StaticPluginEntry* entry = __start_basenode_plugins; entry != __stop_basenode_plugins; ++entry) {
+        if (name == entry->library_name) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+#endif
+
 LibHandle PluginLoadManager::LoadDynamicLibrary_(const std::string& so_path)
 {
 #if defined(PLATFORM_WINDOWS)
@@ -160,14 +485,40 @@ void* PluginLoadManager::GetSymbolAddress_(LibHandle handle, const std::string&
 #endif
 }
 
-void PluginLoadManager::CloseDynamicLibrary_(LibHandle handle, const std::string& so_path)
+void* PluginLoadManager::GetOwnSymbolAddress_(LibHandle handle, const std::string& symbol_name)
+{
+    void* symbol = GetSymbolAddress_(handle, symbol_name);
+#if defined(PLATFORM_WINDOWS)
+    return symbol;  // GetProcAddress 只查找该模块本身
+#else
+    // dlsym 会继续查找库的依赖（如 libbasenode_core.so），只接受定义在该库中的符号
+    Dl_info info;
+    if (!symbol || !dladdr(symbol, &info) || !info.dli_fname) {
+        return nullptr;
+    }
+    void* owner = dlopen(info.dli_fname, RTLD_NOW | RTLD_NOLOAD);
+    if (!owner) {
+        return nullptr;
+    }
+    dlclose(owner);
+    return owner == handle ? symbol : nullptr;
+#endif
+}
+
+void PluginLoadManager::CloseDynamicLibrary_(LoadedPlugin& plugin)
 {
-    SafeCallSimple_(handle, so_path, "uninitSo");
+    if (plugin.uninit) {
+        SafeCallSimple_(plugin.uninit, plugin.so_path + " FUNC[uninit]");
+    }
+    if (!plugin.handle) {
+        return;  // 单体构建中模块没有动态库句柄
+    }
 #if defined(PLATFORM_WINDOWS)
-    FreeLibrary(handle);
+    FreeLibrary(plugin.handle);
 #else
-    dlclose(handle);
+    dlclose(plugin.handle);
 #endif
+    plugin.handle = nullptr;
 }
 
 inline std::string PluginLoadManager::GetLastLibraryError_() {
@@ -189,43 +540,26 @@ inline std::string PluginLoadManager::GetLastLibraryError_() {
 
 
 // 如何仅通过日志定位崩溃位置：
-// 1) 看日志中的 FUNC[xxx]：可区分是 initSo / updateSo / uninitSo 中哪个接口崩溃。
+// 1) 看日志中的 FUNC[xxx]：可区分是 init / update / uninit / after_all_init 中哪个接口崩溃。
 // 2) 看日志中的 Backtrace：SafeCall 在捕获信号时会自动打印调用栈，直接看日志即可定位崩溃函数/行。
 //    若 Backtrace 里是地址而非符号，请确保链接时使用 -rdynamic（主程序与 .so 都建议带调试符号或 -rdynamic）。
 // 3) 若需更详细分析，可用 GDB：catch signal SIGSEGV -> run -> bt。
-void PluginLoadManager::SafeCallSimple_(void* handle, const std::string& so_path, const std::string& symbol_name)
+void PluginLoadManager::SafeCallSimple_(PluginEntryFunc func, const std::string& context)
 {
-    if (!handle) {
-        BaseNodeLogError("SafeCallSimple_: Invalid plugin handle for [%s]", so_path.c_str());
-        return;
-    }
-
-    // 自定义错误回调；context 中带 so_path 和 symbol_name，便于确定是哪个导出函数崩溃
-    std::string context = so_path + " FUNC[" + symbol_name + "]";
+    // 自定义错误回调；context 中带 so_path 和入口名，便于确定是哪个导出函数崩溃
     auto error_callback = [](const std::string& ctx, const std::string& error_msg) {
         BaseNodeLogError("XXX ---> SafeCall Error - Plugin: [%s], Error: %s", ctx.c_str(), error_msg.c_str());
     };
 
-    void* func = GetSymbolAddress_(handle, symbol_name);
-    if (func) {
-        auto update_func = reinterpret_cast<PluginUpdateFunc>(func);
-        
-        // 使用 ToolBox 子库中的 SafeCall 工具安全调用插件函数
-        // 捕获异常和信号（SIGSEGV/SIGFPE），使程序能够继续运行
-        bool success = ToolBox::SafeCallSimple(update_func, context, error_callback);
-        
-        if (!success) {
-            // 注意：由于 siglongjmp 回退栈帧的特性，SafeCall 内部的错误回调
-            // 可能不会输出。这里手动调用错误回调，确保能看到错误信息。
-            error_callback(context, "caught signal or exception");
-        }
-    }
-    else {
-        BaseNodeLogError("SafeCallSimple_: Failed to get symbol address for [%s]", symbol_name.c_str());
+    // 使用 ToolBox 子库中的 SafeCall 工具安全调用插件函数
+    // 捕获异常和信号（SIGSEGV/SIGFPE），使程序能够继续运行
+    bool success = ToolBox::SafeCallSimple(func, context, error_callback);
+
+    if (!success) {
+        // 注意：由于 siglongjmp 回退栈帧的特性，SafeCall 内部的错误回调
+        // 可能不会输出。这里手动调用错误回调，确保能看到错误信息。
+        error_callback(context, "caught signal or exception");
     }
 }
 
-
-
-
 } // namespace BaseNode
\ No newline at end of file
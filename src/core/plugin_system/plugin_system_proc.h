@@ -1,7 +1,12 @@
 #pragma once
 #include <string_view>
 #include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
 #include "tools/singleton.h"
+#include "3rdparty/nlohmann_json/json.hpp"
+#include "plugin_system/plugin_descriptor.h"
 
 #if defined(PLATFORM_WINDOWS)
     using LibHandle = HMODULE;
@@ -9,11 +14,62 @@
     using LibHandle = void*;
 #endif
 
-// 函数指针类型定义
-using PluginUpdateFunc = void (*)(void);
-
 namespace BaseNode
 {
+
+#define PLUGIN_CORE_SO_NAME "libbasenode_core.so"     // 核心库总是最先单独加载，其它插件都隐式依赖它
+#define PLUGIN_SERVICE_DISCOVERY_SO_NAME "libservice_discovery.so"  // 并行加载时其它插件（核心库和它依赖的插件除外）都隐式依赖它
+
+/**
+ * @brief 已加载的插件，入口函数在加载时解析一次
+ */
+struct LoadedPlugin
+{
+    std::string name;                   // 配置中的文件名，如 libplayer_module.so
+    std::string so_path;
+    LibHandle handle = nullptr;
+    const PluginDescriptor* descriptor = nullptr;   // 未导出描述符的旧插件为 nullptr
+    PluginEntryFunc init = nullptr;
+    PluginEntryFunc update = nullptr;
+    PluginEntryFunc uninit = nullptr;
+    PluginEntryFunc after_all_init = nullptr;
+    bool trusted = false;               // 为 true 时 update 直接调用，不经过 SafeCall 的信号保护
+    std::string update_context;         // update 的 SafeCall 上下文（加载时生成，避免每次 tick 拼接字符串）
+};
+
+/**
+ * @brief 单个插件的加载步骤（dlopen + initSo）
+ */
+struct PluginLoadStep
+{
+    LoadedPlugin plugin;
+    std::vector<size_t> dependents;     // 依赖本插件的步骤
+    size_t pending_depends = 0;         // 尚未完成的依赖数，为 0 时可以开始
+    bool started = false;
+    bool ok = false;
+    int64_t start_ns = 0;               // 相对加载开始的时间
+    int64_t dlopen_ns = 0;
+    int64_t init_ns = 0;
+};
+
+/**
+ * @brief 插件加载管理
+ *
+ * 插件列表来自 {config_name}.plugins.modules。parallel_init 为 true 时按 plugins.depends
+ * （插件 -> 依赖的插件列表）建立依赖图，依赖都已 initSo 完成的插件在各自的线程中并行 dlopen + initSo，
+ * 未声明依赖的插件只依赖核心库和服务发现插件；否则按配置顺序在主线程逐个加载。加载完成后输出各插件的耗时。
+ * 每个模块在 IModule::Init 中都会向服务发现注册（RegisterToZk_），服务发现的注册表没有加锁，
+ * 所以并行加载时服务发现插件必须在其它插件 initSo 之前完成。
+ *
+ * 插件导出 basenodePluginDescriptor（见 plugin_descriptor.h）时使用其中的入口函数，
+ * 否则按旧方式查找 initSo / updateSo / uninitSo，都只在加载时查找一次。
+ * 单体构建（BASENODE_MONOLITH）中模块静态链接进主程序，不再 dlopen：plugins.modules 选择启用哪些模块，
+ * 入口从链接期注册表（见 StaticPluginEntry）中按库文件名查找，依赖图和耗时统计不变。
+ * 单体构建只是另一种打包方式，与动态构建的启动耗时、RPC 延迟对比尚未测量（见 monolith_compare.sh）。
+ * plugins.trusted 中列出的插件 update 不经过 SafeCall 的信号保护直接调用，init / uninit 仍然受保护；
+ * 插件崩溃时不再被拦截。真实 SafeCall 与直接调用的开销差异尚未测量（plugin/update_cached_safecall 与
+ * plugin/update_trusted 两个基准），没有测量结果前不要为了性能把插件列入 trusted。
+ */
 class PluginLoadManager
 {
 public:
@@ -22,17 +78,47 @@ public:
     int Uninit();
 
 private:
-    int LoadPluginSo_(const std::string& so_path);
+    /**
+     * @brief 按 {config_name}.plugins.depends 建立加载依赖图
+     * @param parallel_init 为 false 时每个插件依赖前一个（按配置顺序逐个加载）
+     * @return 0 成功；依赖了未配置的插件或存在环时返回 -1
+     */
+    int BuildLoadGraph_(const std::vector<std::string>& modules, const std::string& lib_dir, const nlohmann::json& depends_json,
+                        const nlohmann::json& trusted_json, bool parallel_init, std::vector<PluginLoadStep>& steps);
+
+    /**
+     * @brief 执行加载依赖图：依赖都已完成的插件在各自的线程中并行 dlopen + initSo
+     * @param parallel_init 为 false 时在调用线程上逐个执行
+     * @return 0 成功；有插件加载失败时不再启动新的步骤，等已启动的完成后返回 -1
+     */
+    int RunLoadGraph_(std::vector<PluginLoadStep>& steps, bool parallel_init);
+
+    void LoadPluginStep_(PluginLoadStep& step, int64_t begin_ns);
+
+    /**
+     * @brief 解析插件入口函数（优先使用描述符）
+     * @return false 描述符的 ABI 版本不兼容
+     */
+    bool ResolveEntryPoints_(LoadedPlugin& plugin);
+    void LogLoadTimings_(const std::vector<PluginLoadStep>& steps, int64_t total_ns);
     int AfterAllModulesInit_();
 
+#if defined(BASENODE_MONOLITH)
+    /**
+     * @brief 在链接期注册表中按库文件名查找模块
+     * @return nullptr 该模块没有链接进主程序
+     */
+    const StaticPluginEntry* FindStaticPlugin_(const std::string& name);
+#endif
     LibHandle LoadDynamicLibrary_(const std::string& so_path);
     void* GetSymbolAddress_(LibHandle handle, const std::string& symbol_name);
-    void CloseDynamicLibrary_(LibHandle handle, const std::string& so_path);
+    void* GetOwnSymbolAddress_(LibHandle handle, const std::string& symbol_name);
+    void CloseDynamicLibrary_(LoadedPlugin& plugin);
     std::string GetLastLibraryError_();
-    void SafeCallSimple_(void* handle, const std::string& so_path, const std::string& symbol_name);
+    void SafeCallSimple_(PluginEntryFunc func, const std::string& context);
 
 private:
-    std::map<std::string, void*> plugin_map_;
+    std::vector<LoadedPlugin> plugins_;     // 按 initSo 完成的顺序（依赖在前），卸载时逆序
 };
 } // namespace BaseNode
 
@@ -0,0 +1,317 @@
+#include "service_discovery/zookeeper/local_zk_client.h"
+#include "utils/basenode_def_internal.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace BaseNode::ServiceDiscovery::Zookeeper
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+const char *const kDataFile = ".data";
+const char *const kOwnerFile = ".owner";
+
+// 临时节点的创建进程是否还在（进程不存在时节点视为已删除）
+bool OwnerAlive(const std::string &dir)
+{
+    std::ifstream file(dir + "/" + kOwnerFile);
+    if (!file)
+    {
+        return true;  // 持久节点
+    }
+    pid_t pid = 0;
+    file >> pid;
+    if (pid <= 0)
+    {
+        return false;
+    }
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+} // namespace
+
+LocalZkClient::~LocalZkClient()
+{
+    Disconnect();
+}
+
+bool LocalZkClient::Connect(const std::string &hosts, int /*timeout_ms*/)
+{
+    root_dir_ = hosts.empty() ? LOCAL_ZK_DEFAULT_ROOT_DIR : hosts;
+    std::error_code ec;
+    fs::create_directories(root_dir_, ec);
+    if (ec)
+    {
+        BaseNodeLogError("[LocalZkClient] Connect: failed to create root dir %s: %s", root_dir_.c_str(), ec.message().c_str());
+        return false;
+    }
+    if (!running_.exchange(true))
+    {
+        poll_thread_ = std::thread([this]() { PollLoop_(); });
+    }
+    BaseNodeLogInfo("[LocalZkClient] Connected, root dir: %s", root_dir_.c_str());
+    return true;
+}
+
+void LocalZkClient::Disconnect()
+{
+    if (running_.exchange(false) && poll_thread_.joinable())
+    {
+        poll_thread_.join();
+    }
+    std::vector<std::string> ephemerals;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ephemerals.swap(ephemerals_);
+        watches_.clear();
+    }
+    // 后创建的先删除（子节点在父节点之前）
+    for (auto it = ephemerals.rbegin(); it != ephemerals.rend(); ++it)
+    {
+        Delete(*it);
+    }
+}
+
+std::string LocalZkClient::DirOf_(const std::string &path) const
+{
+    if (path.empty() || path == "/")
+    {
+        return root_dir_;
+    }
+    return path[0] == '/' ? root_dir_ + path : root_dir_ + "/" + path;
+}
+
+bool LocalZkClient::Exists_(const std::string &dir) const
+{
+    std::error_code ec;
+    return fs::is_directory(dir, ec) && OwnerAlive(dir);
+}
+
+std::vector<std::string> LocalZkClient::ListChildren_(const std::string &dir) const
+{
+    std::vector<std::string> children;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+    {
+        std::string name = it->path().filename().string();
+        if (name.empty() || name[0] == '.' || !it->is_directory(ec))
+        {
+            continue;
+        }
+        if (OwnerAlive(it->path().string()))
+        {
+            children.push_back(std::move(name));
+        }
+    }
+    std::sort(children.begin(), children.end());
+    return children;
+}
+
+bool LocalZkClient::WriteFile_(const std::string &file, const std::string &data)
+{
+    // 先写临时文件再改名，读取方不会看到写了一半的数据
+    std::string tmp_file = file + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp_file, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out)
+        {
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp_file, file, ec);
+    return !ec;
+}
+
+bool LocalZkClient::EnsurePath(const std::string &path)
+{
+    std::error_code ec;
+    fs::create_directories(DirOf_(path), ec);
+    if (ec)
+    {
+        BaseNodeLogError("[LocalZkClient] EnsurePath failed for path %s: %s", path.c_str(), ec.message().c_str());
+        return false;
+    }
+    return true;
+}
+
+bool LocalZkClient::CreateEphemeral(const std::string &path, const std::string &data)
+{
+    std::string dir = DirOf_(path);
+    std::error_code ec;
+    if (fs::is_directory(dir, ec))
+    {
+        if (OwnerAlive(dir))
+        {
+            return false;  // 与 Zookeeper 一致：节点已存在
+        }
+        // 已退出进程留下的临时节点
+        fs::remove_all(dir, ec);
+    }
+    if (!fs::is_directory(fs::path(dir).parent_path(), ec))
+    {
+        BaseNodeLogError("[LocalZkClient] CreateEphemeral: parent of %s does not exist", path.c_str());
+        return false;
+    }
+    if (!fs::create_directory(dir, ec) ||
+        !WriteFile_(dir + "/" + kOwnerFile, std::to_string(getpid())) ||
+        !WriteFile_(dir + "/" + kDataFile, data))
+    {
+        BaseNodeLogError("[LocalZkClient] CreateEphemeral failed for path %s", path.c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ephemerals_.push_back(path);
+    return true;
+}
+
+bool LocalZkClient::Delete(const std::string &path)
+{
+    std::string dir = DirOf_(path);
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec))
+    {
+        return true;  // 节点不存在，忽略
+    }
+    if (!ListChildren_(dir).empty())
+    {
+        BaseNodeLogError("[LocalZkClient] Delete failed for path %s: node has children", path.c_str());
+        return false;
+    }
+    fs::remove_all(dir, ec);
+    if (ec)
+    {
+        BaseNodeLogError("[LocalZkClient] Delete failed for path %s: %s", path.c_str(), ec.message().c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ephemerals_.erase(std::remove(ephemerals_.begin(), ephemerals_.end(), path), ephemerals_.end());
+    return true;
+}
+
+bool LocalZkClient::SetData(const std::string &path, const std::string &data)
+{
+    std::string dir = DirOf_(path);
+    if (!Exists_(dir))
+    {
+        return false;
+    }
+    return WriteFile_(dir + "/" + kDataFile, data);
+}
+
+bool LocalZkClient::GetData(const std::string &path, std::string &out_data)
+{
+    std::string dir = DirOf_(path);
+    if (!Exists_(dir))
+    {
+        return false;
+    }
+    std::ifstream file(dir + "/" + kDataFile, std::ios::binary);
+    std::ostringstream buffer;
+    if (file)
+    {
+        buffer << file.rdbuf();
+    }
+    out_data = buffer.str();
+    return true;
+}
+
+std::vector<std::string> LocalZkClient::GetChildren(const std::string &path)
+{
+    std::string dir = DirOf_(path);
+    if (!Exists_(dir))
+    {
+        return {};
+    }
+    return ListChildren_(dir);
+}
+
+bool LocalZkClient::WatchChildren(const std::string &path, ChildrenChangedCallback cb)
+{
+    if (!cb)
+    {
+        BaseNodeLogError("[LocalZkClient] Invalid callback for WatchChildren");
+        return false;
+    }
+    std::string dir = DirOf_(path);
+    if (!Exists_(dir))
+    {
+        BaseNodeLogError("[LocalZkClient] WatchChildren failed for path %s: node does not exist", path.c_str());
+        return false;
+    }
+    std::vector<std::string> children = ListChildren_(dir);
+    std::lock_guard<std::mutex> lock(mutex_);
+    watches_[path] = Watch{std::move(children), std::move(cb)};
+    return true;
+}
+
+bool LocalZkClient::WatchSessionState(SessionStateCallback cb)
+{
+    if (!cb)
+    {
+        BaseNodeLogError("[LocalZkClient] Invalid callback for WatchSessionState");
+        return false;
+    }
+    // 本地目录没有会话，连接后一直可用
+    std::thread([callback = std::move(cb)]() {
+        callback(true);
+    }).detach();
+    return true;
+}
+
+void LocalZkClient::PollLoop_()
+{
+    while (running_.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOCAL_ZK_POLL_INTERVAL_MS));
+
+        std::vector<std::pair<std::string, std::vector<std::string>>> watched;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            watched.reserve(watches_.size());
+            for (const auto &pair : watches_)
+            {
+                watched.emplace_back(pair.first, pair.second.children);
+            }
+        }
+
+        for (const auto &[path, children] : watched)
+        {
+            if (GetChildren(path) == children)
+            {
+                continue;
+            }
+            ChildrenChangedCallback callback;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = watches_.find(path);
+                if (it == watches_.end() || it->second.children != children)
+                {
+                    continue;  // 期间被重新设置
+                }
+                callback = std::move(it->second.callback);
+                watches_.erase(it);
+            }
+            // 与 ZkClientImpl 一致：在单独的线程中执行回调，回调中可以重新设置监听
+            std::thread([callback = std::move(callback), path]() {
+                callback(path);
+            }).detach();
+        }
+    }
+}
+
+} // namespace BaseNode::ServiceDiscovery::Zookeeper
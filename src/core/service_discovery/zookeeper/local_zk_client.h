@@ -0,0 +1,72 @@
+#pragma once
+
+#include "service_discovery/zookeeper/zk_client.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BaseNode::ServiceDiscovery::Zookeeper
+{
+
+#define LOCAL_ZK_DEFAULT_ROOT_DIR "/tmp/basenode_sd"    // 默认的节点树根目录
+#define LOCAL_ZK_POLL_INTERVAL_MS 200                   // 检查被监听节点子节点变化的间隔
+
+/**
+ * @brief 基于本机目录的 IZkClient 实现（用于压测和本机多进程联调，替代 Zookeeper）
+ *
+ * 每个节点对应根目录下的一个子目录，节点数据保存在目录中的 .data 文件，
+ * 同一台机器上指向同一根目录的进程看到同一棵节点树。
+ * 临时节点在目录中写入 .owner（创建进程的 pid），进程退出时删除自己创建的临时节点；
+ * 进程异常退出留下的临时节点在 pid 不存在后视为已删除，与 Zookeeper 会话过期的效果一致。
+ * 子节点监听与 Zookeeper 一样是一次性的：后台线程轮询被监听节点的子节点列表，变化后触发一次回调并移除监听。
+ */
+class LocalZkClient : public IZkClient
+{
+public:
+    LocalZkClient() = default;
+    ~LocalZkClient() override;
+
+    LocalZkClient(const LocalZkClient &) = delete;
+    LocalZkClient &operator=(const LocalZkClient &) = delete;
+
+    /// hosts 为节点树的根目录，timeout_ms 未使用
+    bool Connect(const std::string &hosts, int timeout_ms) override;
+
+    bool EnsurePath(const std::string &path) override;
+    bool CreateEphemeral(const std::string &path, const std::string &data = "") override;
+    bool Delete(const std::string &path) override;
+    bool SetData(const std::string &path, const std::string &data) override;
+    bool GetData(const std::string &path, std::string &out_data) override;
+    std::vector<std::string> GetChildren(const std::string &path) override;
+    bool WatchChildren(const std::string &path, ChildrenChangedCallback cb) override;
+    bool WatchSessionState(SessionStateCallback cb) override;
+
+    /// 停止轮询线程并删除本进程创建的临时节点
+    void Disconnect();
+
+private:
+    std::string DirOf_(const std::string &path) const;
+    bool Exists_(const std::string &dir) const;
+    std::vector<std::string> ListChildren_(const std::string &dir) const;
+    static bool WriteFile_(const std::string &file, const std::string &data);
+    void PollLoop_();
+
+private:
+    struct Watch
+    {
+        std::vector<std::string> children;   // 设置监听时的子节点列表（已排序）
+        ChildrenChangedCallback callback;
+    };
+
+    std::string root_dir_;
+    std::mutex mutex_;                                       // 保护 watches_ 和 ephemerals_
+    std::unordered_map<std::string, Watch> watches_;
+    std::vector<std::string> ephemerals_;                    // 本进程创建的临时节点
+    std::atomic<bool> running_{false};
+    std::thread poll_thread_;
+};
+
+} // namespace BaseNode::ServiceDiscovery::Zookeeper
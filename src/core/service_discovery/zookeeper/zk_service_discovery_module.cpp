@@ -1,10 +1,12 @@
 #include "service_discovery/zookeeper/zk_service_discovery_module.h"
 #include "service_discovery/zookeeper/zk_client_impl.h"
+#include "service_discovery/zookeeper/local_zk_client.h"
 
 #include "tools/md5.h"
 #include "utils/basenode_def_internal.h"
 #include "protobuf/pb_out/errcode.pb.h"
 #include "config/config_manager.h"
+#include "plugin_system/plugin_descriptor.h"
 #include <chrono>
 #include <thread>
 #include <unistd.h>  // for getpid()
@@ -415,23 +417,40 @@ void ZkServiceDiscoveryModule::WatchServiceInstances(const std::string &service_
     discovery_->WatchServiceInstances(service_name, instance_list, std::move(cb));
 }
 
-// 插件导出符号，方便通过 PluginLoadManager 装载
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT()
+// 插件入口（通过插件描述符导出，由 PluginLoadManager 装载）
+static void InitPlugin()
 {
     // 在 Init() 之前先调用 Configure()
     std::string zk_hosts = "127.0.0.1:2181";
+    // 服务发现后端：zookeeper（默认）或 local（本机目录，压测和本机多进程联调用，不需要 Zookeeper）
+    std::string backend = "zookeeper";
+    std::string local_root_dir = LOCAL_ZK_DEFAULT_ROOT_DIR;
     std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
     if (!loaded_configs.empty()) {
         std::string config_name = loaded_configs[0];
         // 从配置读取监听参数
         std::string zk_hosts_path = config_name + ".service_discovery.zookeeper.hosts";
         zk_hosts = ConfigMgr->Get<std::string>(config_name, zk_hosts_path, "127.0.0.1:2181");
-        BaseNodeLogInfo("[Zookeeper] Loaded hosts config from '%s': %s", config_name.c_str(), zk_hosts.c_str());
+        backend = ConfigMgr->Get<std::string>(config_name, config_name + ".service_discovery.backend", backend);
+        local_root_dir = ConfigMgr->Get<std::string>(config_name, config_name + ".service_discovery.local.root_dir", local_root_dir);
+        BaseNodeLogInfo("[Zookeeper] Loaded hosts config from '%s': %s, backend: %s", config_name.c_str(), zk_hosts.c_str(), backend.c_str());
     } else {
         BaseNodeLogWarn("[ZkServiceDiscovery] No config name in ConfigManager (GetLoadedConfigNames empty), using default hosts: %s", zk_hosts.c_str());
     }
     std::string process_id = "basenode-process-" + std::to_string(getpid());  // 示例：实际应从配置读取
     ZkPaths paths{"/basenode"};  // 示例：实际应从配置读取
+
+    if (backend == "local") {
+        auto local_client = std::make_shared<LocalZkClient>();
+        if (!local_client->Connect(local_root_dir, /*timeout_ms=*/0))
+        {
+            BaseNodeLogError("[ZkServiceDiscovery] initSo: LocalZkClient Connect failed, root dir: %s", local_root_dir.c_str());
+            return;
+        }
+        ZkServiceDiscoveryMgr->Configure(local_client, paths);
+        ZkServiceDiscoveryMgr->Init();
+        return;
+    }
     
     // 创建真实的 Zookeeper 客户端并连接
     auto zk_client = std::make_shared<ZkClientImpl>();
@@ -463,16 +482,18 @@ extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT()
     ZkServiceDiscoveryMgr->Init();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE()
+static void UpdatePlugin()
 {
     ZkServiceDiscoveryMgr->Update();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT()
+static void UninitPlugin()
 {
     ZkServiceDiscoveryMgr->UnInit();
 }
 
+BASENODE_PLUGIN_DESCRIPTOR("service_discovery", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
+
 // 全局单例实例，用于实现 GetModuleZkRegistryInstance()
 static BaseNode::IModuleZkRegistry* g_module_zk_registry_instance = nullptr;
 static BaseNode::IModuleZkDiscovery* g_module_zk_discovery_instance = nullptr;
@@ -23,7 +23,7 @@ namespace BaseNode::ServiceDiscovery::Zookeeper
  *
  * 顶层业务不直接依赖 Zookeeper，只依赖本模块暴露的抽象能力。
  */
-class ZkServiceDiscoveryModule final : public BaseNode::IModule
+class ZkServiceDiscoveryModule final : public BaseNode::ModuleBase<ZkServiceDiscoveryModule>
 {
 public:
     ZkServiceDiscoveryModule() = default;
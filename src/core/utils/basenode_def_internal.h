@@ -42,6 +42,8 @@ enum class ErrorCode : int32_t
     BN_SERVICE_ID_ALREADY_REGISTERED = 7,   // 服务ID已注册
     BN_NETWORK_START_FAILED = 8,   // 网络库启动失败
     BN_REGISTER_MODULE_TO_ZK_FAILED = 9,   // 注册模块到ZK失败
+    BN_MODULE_NOT_LOCAL = 10,   // 目标模块不在本进程
+    BN_RPC_DEADLINE_EXCEEDED = 11,   // RPC 请求已超过截止时间
 };
 
 } // namespace BaseNode
\ No newline at end of file
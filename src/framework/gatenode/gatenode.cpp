@@ -1,5 +1,6 @@
 #include "tools/plugin_system.h"
 #include "utils/basenode_def_internal.h"
+#include "plugin_system/plugin_descriptor.h"
 // 1. 声明导出符号
 
 
@@ -28,6 +29,9 @@ public:
 //     delete plugin;
 // }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
+// 插件入口（通过插件描述符导出）
+static void UpdatePlugin() {
     PluginGateMgr->pluginUpdate();
-}
\ No newline at end of file
+}
+
+BASENODE_PLUGIN_DESCRIPTOR("gatenode", "1.0.0", nullptr, &UpdatePlugin, nullptr, nullptr)
@@ -0,0 +1,391 @@
+#include "loadgen/loadgen_module.h"
+#include "guild/guild_module.h"
+#include "module/module_reactor.h"
+#include "config/config_manager.h"
+#include "protobuf/pb_out/guild.pb.h"
+#include "protobuf/pb_out/errcode.pb.h"
+#include "3rdparty/nlohmann_json/json.hpp"
+#include "plugin_system/plugin_descriptor.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+
+namespace BaseNode
+{
+
+namespace
+{
+
+constexpr int64_t kNsPerMs = 1000000;
+
+double NsToMs(uint64_t ns)
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+ErrorCode LoadGen::DoInit()
+{
+    LoadOptions_();
+
+    uint32_t total_weight = 0;
+    for (size_t i = 0; i < options_.mix.size(); ++i) {
+        total_weight += options_.mix[i];
+        mix_cumulative_[i] = total_weight;
+    }
+    if (total_weight == 0) {
+        BaseNodeLogError("[LoadGen] DoInit: all mix weights are 0");
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+    if (options_.concurrency == 0 || options_.guild_id_min == 0 || options_.guild_id_max < options_.guild_id_min) {
+        BaseNodeLogError("[LoadGen] DoInit: invalid options, concurrency: %u, guild_id: [%llu, %llu]",
+                         options_.concurrency, static_cast<unsigned long long>(options_.guild_id_min),
+                         static_cast<unsigned long long>(options_.guild_id_max));
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+
+    rng_state_ = static_cast<uint64_t>(ModuleReactor::NowNs()) | 1;
+    send_interval_ns_ = options_.target_qps > 0 ? 1e9 / options_.target_qps : 0;
+    ResetStats_();
+    phase_ = Phase::WARMUP;
+    phase_start_ns_ = ModuleReactor::NowNs();
+    next_send_ns_ = static_cast<double>(phase_start_ns_);
+    last_report_ns_ = phase_start_ns_;
+    // 按节拍发送，不依赖主循环的 tick 频率（定时器会按时唤醒驱动线程）
+    pacing_timer_ = AddPeriodicTimer(LOADGEN_PACING_INTERVAL_MS, [this]() { Pump_(); });
+
+    BaseNodeLogWarn("[LoadGen] start: target_qps: %u, concurrency: %u, warmup_ms: %u, duration_ms: %u, mix: %u/%u/%u/%u/%u",
+                    options_.target_qps, options_.concurrency, options_.warmup_ms, options_.duration_ms,
+                    options_.mix[0], options_.mix[1], options_.mix[2], options_.mix[3], options_.mix[4]);
+    return ErrorCode::BN_SUCCESS;
+}
+
+ErrorCode LoadGen::DoUpdate()
+{
+    return ErrorCode::BN_SUCCESS;
+}
+
+ErrorCode LoadGen::DoUninit()
+{
+    if (pacing_timer_ != 0) {
+        CancelTimer(pacing_timer_);
+        pacing_timer_ = 0;
+    }
+    if (phase_ != Phase::DONE && generation_ > 0) {
+        // 提前退出（Ctrl+C）时输出已有的结果
+        ReportFinal_();
+    }
+    return ErrorCode::BN_SUCCESS;
+}
+
+void LoadGen::LoadOptions_()
+{
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (loaded_configs.empty()) {
+        return;
+    }
+    const std::string& config_name = loaded_configs[0];
+    const std::string prefix = config_name + ".loadgen.";
+    options_.target_qps = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "target_qps", static_cast<int>(options_.target_qps)));
+    options_.concurrency = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "concurrency", static_cast<int>(options_.concurrency)));
+    options_.warmup_ms = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "warmup_ms", static_cast<int>(options_.warmup_ms)));
+    options_.duration_ms = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "duration_ms", static_cast<int>(options_.duration_ms)));
+    options_.report_interval_ms = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "report_interval_ms", static_cast<int>(options_.report_interval_ms)));
+    options_.guild_id_min = static_cast<uint64_t>(ConfigMgr->Get<int64_t>(config_name, prefix + "guild_id_min", static_cast<int64_t>(options_.guild_id_min)));
+    options_.guild_id_max = static_cast<uint64_t>(ConfigMgr->Get<int64_t>(config_name, prefix + "guild_id_max", static_cast<int64_t>(options_.guild_id_max)));
+    options_.exit_on_finish = ConfigMgr->Get<bool>(config_name, prefix + "exit_on_finish", options_.exit_on_finish);
+    options_.report_path = ConfigMgr->Get<std::string>(config_name, prefix + "report_path", options_.report_path);
+    for (size_t i = 0; i < options_.mix.size(); ++i) {
+        const char* name = CallName_(static_cast<LoadGenCall>(i));
+        options_.mix[i] = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, prefix + "mix." + name, static_cast<int>(options_.mix[i])));
+    }
+}
+
+void LoadGen::Pump_()
+{
+    int64_t now_ns = ModuleReactor::NowNs();
+
+    switch (phase_) {
+    case Phase::WARMUP:
+        if (now_ns - phase_start_ns_ >= static_cast<int64_t>(options_.warmup_ms) * kNsPerMs) {
+            // 预热期间发出的请求完成时不再计入（代数不同）
+            ResetStats_();
+            ++generation_;
+            phase_ = Phase::MEASURE;
+            phase_start_ns_ = now_ns;
+            measure_end_ns_ = now_ns + static_cast<int64_t>(options_.duration_ms) * kNsPerMs;
+            last_report_ns_ = now_ns;
+        }
+        break;
+    case Phase::MEASURE:
+        if (now_ns >= measure_end_ns_) {
+            phase_ = Phase::DRAIN;
+            phase_start_ns_ = now_ns;
+        }
+        break;
+    case Phase::DRAIN:
+        if (in_flight_ == 0 || now_ns - phase_start_ns_ >= static_cast<int64_t>(LOADGEN_DRAIN_TIMEOUT_MS) * kNsPerMs) {
+            phase_ = Phase::DONE;
+            CancelTimer(pacing_timer_);
+            pacing_timer_ = 0;
+            ReportFinal_();
+            if (options_.exit_on_finish) {
+                // 与 Ctrl+C 相同的退出流程（主循环结束后正常卸载插件）
+                raise(SIGINT);
+            }
+        }
+        return;
+    case Phase::DONE:
+        return;
+    }
+
+    if (phase_ == Phase::MEASURE && options_.report_interval_ms > 0 &&
+        now_ns - last_report_ns_ >= static_cast<int64_t>(options_.report_interval_ms) * kNsPerMs) {
+        ReportInterval_(now_ns);
+    }
+
+    if (send_interval_ns_ <= 0) {
+        // 不限速：保持 concurrency 个请求在途
+        while (in_flight_ < options_.concurrency) {
+            Issue_(PickCall_(), now_ns);
+        }
+        return;
+    }
+
+    // 调度落后太多（被调用方或本线程长时间卡住）时放弃最旧的部分，避免恢复后集中补发
+    double oldest_ns = static_cast<double>(now_ns - static_cast<int64_t>(LOADGEN_MAX_SCHEDULE_LAG_MS) * kNsPerMs);
+    if (next_send_ns_ < oldest_ns) {
+        uint64_t skipped = static_cast<uint64_t>((oldest_ns - next_send_ns_) / send_interval_ns_);
+        next_send_ns_ += static_cast<double>(skipped) * send_interval_ns_;
+        if (phase_ == Phase::MEASURE) {
+            missed_ += skipped;
+        }
+    }
+    while (next_send_ns_ <= static_cast<double>(now_ns) && in_flight_ < options_.concurrency) {
+        Issue_(PickCall_(), static_cast<int64_t>(next_send_ns_));
+        next_send_ns_ += send_interval_ns_;
+    }
+}
+
+uint64_t LoadGen::NextRandom_()
+{
+    // xorshift64*
+    rng_state_ ^= rng_state_ >> 12;
+    rng_state_ ^= rng_state_ << 25;
+    rng_state_ ^= rng_state_ >> 27;
+    return rng_state_ * 2685821657736338717ULL;
+}
+
+LoadGenCall LoadGen::PickCall_()
+{
+    uint32_t value = static_cast<uint32_t>(NextRandom_() % mix_cumulative_.back());
+    size_t index = std::upper_bound(mix_cumulative_.begin(), mix_cumulative_.end(), value) - mix_cumulative_.begin();
+    return static_cast<LoadGenCall>(index);
+}
+
+uint64_t LoadGen::PickGuildId_()
+{
+    return options_.guild_id_min + NextRandom_() % (options_.guild_id_max - options_.guild_id_min + 1);
+}
+
+void LoadGen::Issue_(LoadGenCall call, int64_t scheduled_ns)
+{
+    ++in_flight_;
+    if (phase_ == Phase::MEASURE) {
+        ++issued_;
+    }
+    RunCall_(call, PickGuildId_(), scheduled_ns, generation_).then([](auto) {});
+}
+
+ToolBox::coro::Task<std::monostate> LoadGen::RunCall_(LoadGenCall call, uint64_t guild_id, int64_t scheduled_ns, uint32_t generation)
+{
+    bool ok = false;
+    uint64_t items = 0;
+    try {
+        if (call == LoadGenCall::GET_GUILD_INFO || call == LoadGenCall::GET_GUILD_INFO_CORO) {
+            guild::GetGuildInfoRequest request;
+            request.set_guild_id(guild_id);
+            if (call == LoadGenCall::GET_GUILD_INFO) {
+                auto result = co_await CallModuleService<&Guild::GetGuildInfo>(request);
+                const guild::GetGuildInfoResponse& response = *result;
+                ok = static_cast<errcode::ErrCode>(response.ret()) == errcode::ErrCode::ERR_SUCCESS;
+            } else {
+                auto result = co_await CallModuleService<&Guild::GetGuildInfoCoro>(request);
+                const guild::GetGuildInfoResponse& response = *result;
+                ok = static_cast<errcode::ErrCode>(response.ret()) == errcode::ErrCode::ERR_SUCCESS;
+            }
+        } else {
+            std::shared_ptr<ToolBox::CoroRpc::StreamReader<std::string>> reader;
+            if (call == LoadGenCall::GUILD_MEMBERS_STREAM) {
+                reader = co_await CallModuleServiceStream<&Guild::GetGuildMembersStream>(guild_id);
+            } else if (call == LoadGenCall::GUILD_MEMBER_IDS_STREAM) {
+                reader = co_await CallModuleServiceStream<&Guild::GetGuildMemberIdsStream>(guild_id);
+            } else {
+                guild::GetGuildMembersStreamRequest request;
+                request.set_guild_id(guild_id);
+                reader = co_await CallModuleServiceStream<&Guild::GetGuildMembersStreamPB>(request);
+            }
+            if (reader) {
+                while (!reader->IsFinished()) {
+                    auto value = co_await *reader;
+                    if (!value.has_value()) {
+                        break;
+                    }
+                    ++items;
+                }
+                ok = !reader->GetError();
+            }
+        }
+    } catch (const std::exception& e) {
+        BaseNodeLogDebug("[LoadGen] %s failed: %s", CallName_(call), e.what());
+    }
+    OnDone_(call, scheduled_ns, generation, ok, items);
+    co_return std::monostate{};
+}
+
+void LoadGen::OnDone_(LoadGenCall call, int64_t scheduled_ns, uint32_t generation, bool ok, uint64_t stream_items)
+{
+    --in_flight_;
+    if (generation != generation_ || generation_ == 0) {
+        return;
+    }
+    int64_t now_ns = ModuleReactor::NowNs();
+    uint64_t latency_ns = static_cast<uint64_t>(std::max<int64_t>(now_ns - scheduled_ns, 0));
+    for (LoadGenCallStats* stats : {stats_[static_cast<size_t>(call)].get(), total_.get()}) {
+        ++stats->completed;
+        stats->errors += ok ? 0 : 1;
+        stats->stream_items += stream_items;
+        stats->latency.Record(latency_ns);
+    }
+    if (now_ns <= measure_end_ns_) {
+        ++completed_in_window_;
+    }
+    ++interval_completed_;
+    interval_errors_ += ok ? 0 : 1;
+    interval_latency_->Record(latency_ns);
+}
+
+void LoadGen::ResetStats_()
+{
+    for (auto& stats : stats_) {
+        stats = std::make_unique<LoadGenCallStats>();
+    }
+    total_ = std::make_unique<LoadGenCallStats>();
+    interval_latency_ = std::make_unique<LatencyHistogram>();
+    completed_in_window_ = 0;
+    issued_ = 0;
+    missed_ = 0;
+    interval_completed_ = 0;
+    interval_errors_ = 0;
+}
+
+void LoadGen::ReportInterval_(int64_t now_ns)
+{
+    double seconds = static_cast<double>(now_ns - last_report_ns_) / 1e9;
+    printf("[LoadGen] %6.1fs  qps %10.1f  in_flight %5u  errors %6llu  p50 %8.3fms  p99 %8.3fms  max %8.3fms\n",
+           static_cast<double>(now_ns - (measure_end_ns_ - static_cast<int64_t>(options_.duration_ms) * kNsPerMs)) / 1e9,
+           seconds > 0 ? static_cast<double>(interval_completed_) / seconds : 0.0, in_flight_,
+           static_cast<unsigned long long>(interval_errors_),
+           NsToMs(interval_latency_->Percentile(0.5)), NsToMs(interval_latency_->Percentile(0.99)), NsToMs(interval_latency_->MaxNs()));
+    fflush(stdout);
+    interval_latency_ = std::make_unique<LatencyHistogram>();
+    interval_completed_ = 0;
+    interval_errors_ = 0;
+    last_report_ns_ = now_ns;
+}
+
+void LoadGen::ReportFinal_()
+{
+    int64_t window_ns = static_cast<int64_t>(options_.duration_ms) * kNsPerMs;
+    if (phase_ == Phase::MEASURE) {
+        // 提前退出：按实际经过的时间计算
+        window_ns = ModuleReactor::NowNs() - phase_start_ns_;
+    }
+    double seconds = window_ns > 0 ? static_cast<double>(window_ns) / 1e9 : 0;
+    double throughput = seconds > 0 ? static_cast<double>(completed_in_window_) / seconds : 0;
+
+    nlohmann::json report;
+    report["target_qps"] = options_.target_qps;
+    report["concurrency"] = options_.concurrency;
+    report["duration_s"] = seconds;
+    report["issued"] = issued_;
+    report["missed"] = missed_;
+    report["throughput_qps"] = throughput;
+    report["latency_from"] = "scheduled_send_time";
+
+    printf("\n[LoadGen] %.1fs, target %u qps, concurrency %u: throughput %.1f qps, issued %llu, missed %llu\n",
+           seconds, options_.target_qps, options_.concurrency, throughput,
+           static_cast<unsigned long long>(issued_), static_cast<unsigned long long>(missed_));
+    printf("%-26s %10s %8s %10s %10s %10s %10s %10s\n", "call", "completed", "errors", "mean(ms)", "p50(ms)", "p99(ms)", "p999(ms)", "max(ms)");
+
+    auto add_row = [&](const char* name, const LoadGenCallStats& stats) {
+        const LatencyHistogram& latency = stats.latency;
+        double mean_ms = stats.completed > 0 ? NsToMs(latency.SumNs()) / static_cast<double>(stats.completed) : 0;
+        printf("%-26s %10llu %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", name,
+               static_cast<unsigned long long>(stats.completed), static_cast<unsigned long long>(stats.errors), mean_ms,
+               NsToMs(latency.Percentile(0.5)), NsToMs(latency.Percentile(0.99)), NsToMs(latency.Percentile(0.999)), NsToMs(latency.MaxNs()));
+        report["calls"][name] = {
+            {"completed", stats.completed},
+            {"errors", stats.errors},
+            {"stream_items", stats.stream_items},
+            {"mean_ms", mean_ms},
+            {"p50_ms", NsToMs(latency.Percentile(0.5))},
+            {"p99_ms", NsToMs(latency.Percentile(0.99))},
+            {"p999_ms", NsToMs(latency.Percentile(0.999))},
+            {"max_ms", NsToMs(latency.MaxNs())},
+        };
+    };
+    for (size_t i = 0; i < stats_.size(); ++i) {
+        if (options_.mix[i] > 0) {
+            add_row(CallName_(static_cast<LoadGenCall>(i)), *stats_[i]);
+        }
+    }
+    add_row("all", *total_);
+    fflush(stdout);
+
+    if (options_.report_path.empty()) {
+        return;
+    }
+    std::ofstream file(options_.report_path);
+    if (!file) {
+        BaseNodeLogError("[LoadGen] ReportFinal: failed to open %s", options_.report_path.c_str());
+        return;
+    }
+    file << report.dump(2) << "\n";
+    printf("[LoadGen] report written to %s\n", options_.report_path.c_str());
+}
+
+const char* LoadGen::CallName_(LoadGenCall call)
+{
+    switch (call) {
+    case LoadGenCall::GET_GUILD_INFO: return "get_guild_info";
+    case LoadGenCall::GET_GUILD_INFO_CORO: return "get_guild_info_coro";
+    case LoadGenCall::GUILD_MEMBERS_STREAM: return "guild_members_stream";
+    case LoadGenCall::GUILD_MEMBER_IDS_STREAM: return "guild_member_ids_stream";
+    case LoadGenCall::GUILD_MEMBERS_STREAM_PB: return "guild_members_stream_pb";
+    default: return "unknown";
+    }
+}
+
+} // namespace BaseNode
+
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
+    using namespace BaseNode;
+    LoadGenMgr->Init();
+}
+
+static void UpdatePlugin() {
+    using namespace BaseNode;
+    LoadGenMgr->Update();
+}
+
+static void UninitPlugin() {
+    using namespace BaseNode;
+    LoadGenMgr->UnInit();
+}
+
+BASENODE_PLUGIN_DESCRIPTOR("loadgen", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
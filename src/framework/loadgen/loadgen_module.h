@@ -0,0 +1,148 @@
+#pragma once
+
+#include "module_interface.h"
+#include "module/module_metrics.h"
+#include "tools/cpp20_coroutine.h"
+#include "utils/basenode_def_internal.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace BaseNode
+{
+
+#define LOADGEN_PACING_INTERVAL_MS 1            // 发送节拍：每 1ms 按目标 QPS 补发到期的请求
+#define LOADGEN_MAX_SCHEDULE_LAG_MS 1000        // 调度落后超过该时长的请求不再补发，计为 missed
+#define LOADGEN_DRAIN_TIMEOUT_MS 35000          // 压测结束后等待在途请求完成的最长时间（大于流式调用的超时）
+
+/**
+ * @brief 压测的调用类型（对应 Guild 的服务）
+ */
+enum class LoadGenCall : uint8_t
+{
+    GET_GUILD_INFO = 0,             // Guild::GetGuildInfo（PB）
+    GET_GUILD_INFO_CORO = 1,        // Guild::GetGuildInfoCoro（PB，协程处理）
+    GUILD_MEMBERS_STREAM = 2,       // Guild::GetGuildMembersStream（流式，字符串）
+    GUILD_MEMBER_IDS_STREAM = 3,    // Guild::GetGuildMemberIdsStream（流式，数值）
+    GUILD_MEMBERS_STREAM_PB = 4,    // Guild::GetGuildMembersStreamPB（流式，PB）
+    COUNT
+};
+
+/**
+ * @brief 压测配置，对应配置文件中的 {config_name}.loadgen
+ */
+struct LoadGenOptions
+{
+    uint32_t target_qps = 1000;             // 目标请求速率，0 表示不限速（只受 concurrency 限制）
+    uint32_t concurrency = 256;             // 最多同时在途的请求数（闭环：在途请求满时暂停发送）
+    uint32_t warmup_ms = 2000;              // 预热时长，期间的请求不计入结果
+    uint32_t duration_ms = 10000;           // 计入结果的压测时长
+    uint32_t report_interval_ms = 1000;     // 压测过程中输出区间统计的间隔，0 表示不输出
+    uint64_t guild_id_min = 1;              // 请求的公会ID范围（均匀随机）
+    uint64_t guild_id_max = 1000;
+    bool exit_on_finish = true;             // 输出结果后退出进程
+    std::string report_path;                // 结果 JSON 文件，空表示只输出到标准输出
+    std::array<uint32_t, static_cast<size_t>(LoadGenCall::COUNT)> mix = {60, 30, 4, 3, 3};  // 各调用类型的权重
+};
+
+/**
+ * @brief 单个调用类型的统计（只在 LoadGen 模块线程上写入）
+ */
+struct LoadGenCallStats
+{
+    LatencyHistogram latency;       // 响应时间：从计划发送时间到完成（流式调用为收完最后一条）
+    uint64_t completed = 0;
+    uint64_t errors = 0;            // 调用失败、超时或返回码非 0
+    uint64_t stream_items = 0;      // 流式调用收到的消息数
+};
+
+/**
+ * @brief Player -> Guild RPC 压测模块
+ *
+ * 代替 Player 向 Guild 发起调用：按权重（mix）混合各调用类型，按 target_qps 匀速发送，
+ * 同时在途请求不超过 concurrency（闭环）。响应时间从请求的计划发送时间算起，
+ * 在途请求满或调度落后导致的排队也计入延迟（避免 coordinated omission 低估尾延迟）。
+ * 预热后统计 duration_ms 内的吞吐和 p50/p99/p999 延迟，输出到标准输出和 report_path。
+ *
+ * 单进程：与 libguild_module / libplayer_module 一起加载（config/loadgen.json），调用走进程内路由；
+ * 多进程：与 libnetwork 一起加载，Guild 在另一个进程（config/loadgen_remote.json），
+ * 经 RouterModule 转发，服务发现使用本机目录（service_discovery.backend = local）代替 Zookeeper。
+ */
+class LoadGen : public ModuleBase<LoadGen>
+{
+protected:
+    virtual ErrorCode DoInit() override;
+    virtual ErrorCode DoUpdate() override;
+    virtual ErrorCode DoUninit() override;
+
+private:
+    enum class Phase : uint8_t
+    {
+        WARMUP,
+        MEASURE,
+        DRAIN,      // 停止发送，等待在途请求完成
+        DONE
+    };
+
+    void LoadOptions_();
+
+    /**
+     * @brief 发送节拍：推进阶段，补发计划时间已到的请求
+     */
+    void Pump_();
+
+    LoadGenCall PickCall_();
+    uint64_t PickGuildId_();
+    uint64_t NextRandom_();
+
+    void Issue_(LoadGenCall call, int64_t scheduled_ns);
+
+    /**
+     * @brief 发起一次调用并等待完成（流式调用收完全部消息），结束时调用 OnDone_
+     */
+    ToolBox::coro::Task<std::monostate> RunCall_(LoadGenCall call, uint64_t guild_id, int64_t scheduled_ns, uint32_t generation);
+
+    /**
+     * @brief 请求完成（在模块线程上调用）
+     * @param generation 发出时的统计代数，与当前不同（预热期间发出）时不计入结果
+     */
+    void OnDone_(LoadGenCall call, int64_t scheduled_ns, uint32_t generation, bool ok, uint64_t stream_items);
+
+    void ResetStats_();
+    void ReportInterval_(int64_t now_ns);
+    void ReportFinal_();
+
+    static const char* CallName_(LoadGenCall call);
+
+private:
+    LoadGenOptions options_;
+    Phase phase_ = Phase::WARMUP;
+    TimerId pacing_timer_ = 0;
+
+    int64_t phase_start_ns_ = 0;
+    int64_t measure_end_ns_ = 0;
+    double next_send_ns_ = 0;           // 下一个请求的计划发送时间
+    double send_interval_ns_ = 0;       // 0 表示不限速
+    uint32_t in_flight_ = 0;
+    uint32_t generation_ = 0;           // 统计代数，进入 MEASURE 时递增
+    uint64_t rng_state_ = 0;
+    std::array<uint32_t, static_cast<size_t>(LoadGenCall::COUNT)> mix_cumulative_ = {};
+
+    // 计入结果的统计（MEASURE 阶段发出的请求）
+    std::array<std::unique_ptr<LoadGenCallStats>, static_cast<size_t>(LoadGenCall::COUNT)> stats_;
+    std::unique_ptr<LoadGenCallStats> total_;
+    uint64_t completed_in_window_ = 0;  // MEASURE 阶段内完成的请求数（用于计算吞吐）
+    uint64_t issued_ = 0;
+    uint64_t missed_ = 0;               // 调度落后太多而放弃的请求数
+
+    // 区间统计
+    std::unique_ptr<LatencyHistogram> interval_latency_;
+    uint64_t interval_completed_ = 0;
+    uint64_t interval_errors_ = 0;
+    int64_t last_report_ns_ = 0;
+};
+
+#define LoadGenMgr ToolBox::Singleton<LoadGen>::Instance()
+
+} // namespace BaseNode
@@ -0,0 +1,130 @@
+#include "metrics/metrics_module.h"
+#include "module/module_reactor.h"
+#include "module/module_router.h"
+#include "config/config_manager.h"
+#include "plugin_system/plugin_descriptor.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace BaseNode
+{
+
+ErrorCode MetricsModule::DoInit()
+{
+    BaseNodeLogInfo("[MetricsModule] DoInit");
+
+    std::vector<std::string> loaded_configs = ConfigMgr->GetLoadedConfigNames();
+    if (!loaded_configs.empty()) {
+        const std::string& config_name = loaded_configs[0];
+        dump_path_ = ConfigMgr->Get<std::string>(config_name, config_name + ".metrics.dump_path", dump_path_);
+        dump_interval_ms_ = static_cast<uint32_t>(ConfigMgr->Get<int>(config_name, config_name + ".metrics.dump_interval_ms", static_cast<int>(dump_interval_ms_)));
+    }
+
+    // 统计请求不应排在业务请求之后
+    RegisterService<&MetricsModule::GetStats, &MetricsModule::GetTraces>(RpcPriority::CONTROL, this);
+
+    if (dump_interval_ms_ > 0 && !dump_path_.empty()) {
+        dump_timer_ = AddPeriodicTimer(dump_interval_ms_, [this]() { DumpToFile_(); });
+    }
+    BaseNodeLogInfo("[MetricsModule] DoInit: dump_path: %s, dump_interval_ms: %u", dump_path_.c_str(), dump_interval_ms_);
+    return ErrorCode::BN_SUCCESS;
+}
+
+ErrorCode MetricsModule::DoUpdate()
+{
+    return ErrorCode::BN_SUCCESS;
+}
+
+ErrorCode MetricsModule::DoUninit()
+{
+    BaseNodeLogInfo("[MetricsModule] DoUninit");
+    if (dump_timer_ != 0) {
+        CancelTimer(dump_timer_);
+        dump_timer_ = 0;
+    }
+    return ErrorCode::BN_SUCCESS;
+}
+
+std::string MetricsModule::GetStats()
+{
+    return FormatStats_();
+}
+
+std::string MetricsModule::GetTraces(uint64_t trace_id)
+{
+    return RpcTracerMgr->ExportChromeJson(trace_id);
+}
+
+std::string MetricsModule::FormatStats_()
+{
+    std::string stats = MetricsExporter::FormatPrometheus();
+    stats += rate_lines_;
+    return stats;
+}
+
+void MetricsModule::UpdateRates_()
+{
+    int64_t now_ns = ModuleReactor::NowNs();
+    double elapsed_s = last_rate_ns_ > 0 ? static_cast<double>(now_ns - last_rate_ns_) / 1e9 : 0.0;
+    last_rate_ns_ = now_ns;
+
+    std::string lines = "# HELP basenode_service_requests_per_second Requests per second between the last two metric dumps.\n"
+                        "# TYPE basenode_service_requests_per_second gauge\n";
+    char line[256];
+    for (IModule* module : ModuleRouterMgr->GetAllModules()) {
+        for (const auto& [service_id, metrics] : module->GetMetrics().Services()) {
+            uint64_t key = (static_cast<uint64_t>(module->GetModuleId()) << 32) | service_id;
+            uint64_t requests = metrics->requests.load(std::memory_order_relaxed);
+            uint64_t& last = last_requests_[key];
+            double rate = elapsed_s > 0 && requests >= last ? static_cast<double>(requests - last) / elapsed_s : 0.0;
+            last = requests;
+            snprintf(line, sizeof(line), "basenode_service_requests_per_second{module=\"%s\",service=\"%u\"} %.2f\n",
+                     module->GetModuleName().c_str(), service_id, rate);
+            lines += line;
+        }
+    }
+    rate_lines_ = std::move(lines);
+}
+
+void MetricsModule::DumpToFile_()
+{
+    UpdateRates_();
+    std::string stats = FormatStats_();
+
+    // 先写临时文件再改名，采集方不会读到写了一半的文件
+    std::string tmp_path = dump_path_ + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "w");
+    if (!file) {
+        BaseNodeLogError("[MetricsModule] DumpToFile: failed to open %s", tmp_path.c_str());
+        return;
+    }
+    size_t written = fwrite(stats.data(), 1, stats.size(), file);
+    fclose(file);
+    if (written != stats.size()) {
+        BaseNodeLogError("[MetricsModule] DumpToFile: short write to %s, %zu/%zu bytes", tmp_path.c_str(), written, stats.size());
+        return;
+    }
+    if (rename(tmp_path.c_str(), dump_path_.c_str()) != 0) {
+        BaseNodeLogError("[MetricsModule] DumpToFile: failed to rename %s to %s", tmp_path.c_str(), dump_path_.c_str());
+    }
+}
+
+} // namespace BaseNode
+
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
+    using namespace BaseNode;
+    MetricsModuleMgr->Init();
+}
+
+static void UpdatePlugin() {
+    using namespace BaseNode;
+    MetricsModuleMgr->Update();
+}
+
+static void UninitPlugin() {
+    using namespace BaseNode;
+    MetricsModuleMgr->UnInit();
+}
+
+BASENODE_PLUGIN_DESCRIPTOR("metrics", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
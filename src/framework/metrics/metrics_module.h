@@ -0,0 +1,73 @@
+#pragma once
+
+#include "module_interface.h"
+#include "module/module_metrics.h"
+#include "module/module_rpc_trace.h"
+#include "utils/basenode_def_internal.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace BaseNode
+{
+
+#define METRICS_DEFAULT_DUMP_INTERVAL_MS 10000                    // 默认的指标文件输出间隔
+#define METRICS_DEFAULT_DUMP_PATH "./logs/basenode_metrics.prom"  // 默认的指标文件路径
+
+/**
+ * @brief 指标模块
+ *
+ * 1. 提供内置的统计 RPC（GetStats），返回本进程所有模块的指标（Prometheus 文本格式）；
+ *    以及调用链 RPC（GetTraces），返回本进程记录的 span（Chrome trace JSON）
+ * 2. 按 {config_name}.metrics.dump_interval_ms 定期把指标写入 {config_name}.metrics.dump_path，
+ *    先写临时文件再改名，可以直接交给 node_exporter 的 textfile collector 采集
+ * 除各计数器外，额外输出两次输出之间各服务的请求速率（basenode_service_requests_per_second）。
+ */
+class MetricsModule : public ModuleBase<MetricsModule>
+{
+public:
+    /**
+     * @brief 内置统计 RPC：本进程所有模块的指标
+     * @return Prometheus 文本格式的指标
+     */
+    std::string GetStats();
+
+    /**
+     * @brief 内置调用链 RPC：本进程环形缓冲区中的 span
+     * @param trace_id 只返回该 trace，0 表示全部
+     * @return Chrome trace JSON，多个进程的结果合并 traceEvents 后即可查看完整链路
+     */
+    std::string GetTraces(uint64_t trace_id);
+
+protected:
+    virtual ErrorCode DoInit() override;
+    virtual ErrorCode DoUpdate() override;
+    virtual ErrorCode DoUninit() override;
+
+private:
+    /**
+     * @brief 生成完整的指标文本（含请求速率）
+     */
+    std::string FormatStats_();
+
+    /**
+     * @brief 按两次调用之间的请求数变化计算各服务的请求速率
+     */
+    void UpdateRates_();
+
+    void DumpToFile_();
+
+private:
+    std::string dump_path_ = METRICS_DEFAULT_DUMP_PATH;
+    uint32_t dump_interval_ms_ = METRICS_DEFAULT_DUMP_INTERVAL_MS;
+    TimerId dump_timer_ = 0;
+
+    // 请求速率：(模块ID << 32 | 服务ID) -> 上次的请求数
+    std::unordered_map<uint64_t, uint64_t> last_requests_;
+    int64_t last_rate_ns_ = 0;
+    std::string rate_lines_;       // 最近一次计算出的请求速率（Prometheus 文本）
+};
+
+#define MetricsModuleMgr ToolBox::Singleton<MetricsModule>::Instance()
+
+} // namespace BaseNode
@@ -0,0 +1,181 @@
+#include "router/router_instance_index.h"
+#include "utils/basenode_def_internal.h"
+#include <cassert>
+
+namespace BaseNode
+{
+
+const ServiceDiscovery::ServiceInstance* RouterInstanceIndex::Find(uint64_t instance_id) const
+{
+    auto it = instances_.find(instance_id);
+    return it == instances_.end() ? nullptr : &it->second;
+}
+
+void RouterInstanceIndex::Upsert(const ServiceDiscovery::ServiceInstance& instance)
+{
+    AssertOwnerThread_();
+    auto it = instances_.find(instance.instance_id);
+    if (it == instances_.end()) {
+        it = instances_.emplace(instance.instance_id, instance).first;
+        Link_(it->second);
+        return;
+    }
+    Unlink_(it->second);
+    it->second = instance;
+    Link_(it->second);
+}
+
+bool RouterInstanceIndex::Erase(uint64_t instance_id)
+{
+    AssertOwnerThread_();
+    auto it = instances_.find(instance_id);
+    if (it == instances_.end()) {
+        return false;
+    }
+    Unlink_(it->second);
+    instances_.erase(it);
+    return true;
+}
+
+bool RouterInstanceIndex::HasEndpoint(std::string_view host, uint16_t port) const
+{
+    return by_endpoint_.find(RouterEndpointView{host, port}) != by_endpoint_.end();
+}
+
+uint64_t RouterInstanceIndex::GetConnectionID(std::string_view host, uint16_t port) const
+{
+    auto it = by_endpoint_.find(RouterEndpointView{host, port});
+    if (it == by_endpoint_.end()) {
+        return 0;
+    }
+    // 同一地址下的实例通常都已设置为同一条连接，只有刚加入、尚未复用连接的实例为 0
+    for (uint64_t instance_id : it->second) {
+        uint64_t connection_id = instances_.at(instance_id).connection_id;
+        if (connection_id != 0) {
+            return connection_id;
+        }
+    }
+    return 0;
+}
+
+int RouterInstanceIndex::SetConnectionID(std::string_view host, uint16_t port, uint64_t connection_id)
+{
+    AssertOwnerThread_();
+    auto it = by_endpoint_.find(RouterEndpointView{host, port});
+    if (it == by_endpoint_.end()) {
+        return 0;
+    }
+    int count = 0;
+    for (uint64_t instance_id : it->second) {
+        ServiceDiscovery::ServiceInstance& instance = instances_.at(instance_id);
+        if (instance.connection_id != connection_id) {
+            if (instance.connection_id != 0) {
+                auto conn_it = by_connection_.find(instance.connection_id);
+                conn_it->second.erase(instance_id);
+                if (conn_it->second.empty()) {
+                    by_connection_.erase(conn_it);
+                }
+            }
+            if (connection_id != 0) {
+                by_connection_[connection_id].insert(instance_id);
+            }
+            instance.connection_id = connection_id;
+        }
+        instance.healthy = true;
+        count++;
+        BaseNodeLogDebug("[RouterInstanceIndex] SetConnectionID: conn_id=%lu for instance %lu", connection_id, instance_id);
+    }
+    return count;
+}
+
+std::vector<uint64_t> RouterInstanceIndex::GetInstanceIDsByConnectionID(uint64_t connection_id) const
+{
+    auto it = by_connection_.find(connection_id);
+    if (it == by_connection_.end()) {
+        return {};
+    }
+    return std::vector<uint64_t>(it->second.begin(), it->second.end());
+}
+
+void RouterInstanceIndex::AddPending(uint64_t opaque, const std::string& host, uint16_t port)
+{
+    AssertOwnerThread_();
+    RouterEndpoint endpoint{host, port};
+    pending_by_endpoint_[endpoint] = opaque;
+    pending_[opaque] = std::move(endpoint);
+}
+
+bool RouterInstanceIndex::TakePending(uint64_t opaque, RouterEndpoint& endpoint)
+{
+    AssertOwnerThread_();
+    auto it = pending_.find(opaque);
+    if (it == pending_.end()) {
+        return false;
+    }
+    auto endpoint_it = pending_by_endpoint_.find(it->second);
+    if (endpoint_it != pending_by_endpoint_.end() && endpoint_it->second == opaque) {
+        pending_by_endpoint_.erase(endpoint_it);
+    }
+    endpoint = std::move(it->second);
+    pending_.erase(it);
+    return true;
+}
+
+bool RouterInstanceIndex::HasPending(std::string_view host, uint16_t port) const
+{
+    return pending_by_endpoint_.find(RouterEndpointView{host, port}) != pending_by_endpoint_.end();
+}
+
+void RouterInstanceIndex::Clear()
+{
+    AssertOwnerThread_();
+    instances_.clear();
+    by_endpoint_.clear();
+    by_connection_.clear();
+    pending_.clear();
+    pending_by_endpoint_.clear();
+}
+
+void RouterInstanceIndex::AssertOwnerThread_()
+{
+#ifndef NDEBUG
+    if (owner_thread_ == std::thread::id()) {
+        owner_thread_ = std::this_thread::get_id();
+    }
+    assert(owner_thread_ == std::this_thread::get_id() && "RouterInstanceIndex modified outside its owner thread");
+#endif
+}
+
+void RouterInstanceIndex::Link_(const ServiceDiscovery::ServiceInstance& instance)
+{
+    auto it = by_endpoint_.find(RouterEndpointView{instance.host, instance.port});
+    if (it == by_endpoint_.end()) {
+        it = by_endpoint_.emplace(RouterEndpoint{instance.host, instance.port}, InstanceSet()).first;
+    }
+    it->second.insert(instance.instance_id);
+    if (instance.connection_id != 0) {
+        by_connection_[instance.connection_id].insert(instance.instance_id);
+    }
+}
+
+void RouterInstanceIndex::Unlink_(const ServiceDiscovery::ServiceInstance& instance)
+{
+    auto it = by_endpoint_.find(RouterEndpointView{instance.host, instance.port});
+    if (it != by_endpoint_.end()) {
+        it->second.erase(instance.instance_id);
+        if (it->second.empty()) {
+            by_endpoint_.erase(it);
+        }
+    }
+    if (instance.connection_id != 0) {
+        auto conn_it = by_connection_.find(instance.connection_id);
+        if (conn_it != by_connection_.end()) {
+            conn_it->second.erase(instance.instance_id);
+            if (conn_it->second.empty()) {
+                by_connection_.erase(conn_it);
+            }
+        }
+    }
+}
+
+} // namespace BaseNode
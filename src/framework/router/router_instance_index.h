@@ -0,0 +1,144 @@
+#pragma once
+
+#include "service_discovery/service_discovery_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 实例的地址（host:port），同一地址下的所有实例共用一条连接
+ */
+struct RouterEndpoint
+{
+    std::string host;
+    uint16_t port = 0;
+};
+
+/**
+ * @brief 地址的查找键，查找时不需要构造 std::string
+ */
+struct RouterEndpointView
+{
+    std::string_view host;
+    uint16_t port = 0;
+};
+
+struct RouterEndpointHash
+{
+    using is_transparent = void;
+
+    size_t operator()(const RouterEndpointView& endpoint) const
+    {
+        return std::hash<std::string_view>()(endpoint.host) ^ (static_cast<size_t>(endpoint.port) * 0x9E3779B97F4A7C15ull);
+    }
+    size_t operator()(const RouterEndpoint& endpoint) const { return (*this)(RouterEndpointView{endpoint.host, endpoint.port}); }
+};
+
+struct RouterEndpointEqual
+{
+    using is_transparent = void;
+
+    template <typename L, typename R>
+    bool operator()(const L& lhs, const R& rhs) const
+    {
+        return lhs.port == rhs.port && std::string_view(lhs.host) == std::string_view(rhs.host);
+    }
+};
+
+/**
+ * @brief RouterModule 的实例和连接簿记
+ *
+ * 以实例ID为主表，同时维护 地址 -> 实例集合、连接ID -> 实例集合、地址 -> 待连接 三个索引，
+ * 所有修改都经过本类，索引与主表一起更新。服务发现变化和连接事件上的查找都是 O(1)（按地址下的实例数线性），
+ * 不再随实例总数线性扫描、比较 host 字符串。只在主循环线程上访问：Debug 构建下第一次修改时记录所在线程，
+ * 之后在其他线程上修改会触发断言。
+ */
+class RouterInstanceIndex
+{
+public:
+    using InstanceMap = std::unordered_map<uint64_t, ServiceDiscovery::ServiceInstance>;
+
+    const ServiceDiscovery::ServiceInstance* Find(uint64_t instance_id) const;
+
+    /**
+     * @brief 插入或替换实例（按 instance_id），地址或连接ID变化时同步更新索引
+     */
+    void Upsert(const ServiceDiscovery::ServiceInstance& instance);
+
+    /**
+     * @return false 实例不存在
+     */
+    bool Erase(uint64_t instance_id);
+
+    size_t Size() const { return instances_.size(); }
+    const InstanceMap& Instances() const { return instances_; }
+
+    /**
+     * @brief 该地址下是否有实例
+     */
+    bool HasEndpoint(std::string_view host, uint16_t port) const;
+
+    /**
+     * @brief 该地址已建立的连接
+     * @return 连接ID，0 表示没有
+     */
+    uint64_t GetConnectionID(std::string_view host, uint16_t port) const;
+
+    /**
+     * @brief 对该地址下所有实例设置连接ID，并标记为健康
+     * @return 设置了多少个实例
+     */
+    int SetConnectionID(std::string_view host, uint16_t port, uint64_t connection_id);
+
+    std::vector<uint64_t> GetInstanceIDsByConnectionID(uint64_t connection_id) const;
+
+    /**
+     * @brief 记录向该地址发起的连接（同一地址只有一个待连接）
+     */
+    void AddPending(uint64_t opaque, const std::string& host, uint16_t port);
+
+    /**
+     * @brief 取出并删除待连接记录
+     * @return false 没有该待连接
+     */
+    bool TakePending(uint64_t opaque, RouterEndpoint& endpoint);
+
+    /**
+     * @brief 该地址是否有待连接
+     */
+    bool HasPending(std::string_view host, uint16_t port) const;
+
+    size_t PendingSize() const { return pending_.size(); }
+
+    void Clear();
+
+private:
+    using InstanceSet = std::unordered_set<uint64_t>;
+
+    /**
+     * @brief 检查修改是否在所属线程上（第一次修改时绑定），只在 Debug 构建下检查
+     */
+    void AssertOwnerThread_();
+
+    void Link_(const ServiceDiscovery::ServiceInstance& instance);
+    void Unlink_(const ServiceDiscovery::ServiceInstance& instance);
+
+private:
+    InstanceMap instances_;                                                                         // 实例ID -> 实例
+    std::unordered_map<RouterEndpoint, InstanceSet, RouterEndpointHash, RouterEndpointEqual> by_endpoint_;     // 地址 -> 实例ID
+    std::unordered_map<uint64_t, InstanceSet> by_connection_;                                       // 连接ID -> 实例ID（不含 0）
+    std::unordered_map<uint64_t, RouterEndpoint> pending_;                                          // opaque -> 地址
+    std::unordered_map<RouterEndpoint, uint64_t, RouterEndpointHash, RouterEndpointEqual> pending_by_endpoint_;  // 地址 -> opaque
+    std::thread::id owner_thread_;                                                                  // 所属线程（第一次修改时绑定）
+};
+
+} // namespace BaseNode
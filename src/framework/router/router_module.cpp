@@ -1,6 +1,8 @@
 #include "router/router_module.h"
+#include "module/module_reactor.h"
 #include "net/network.h"
 #include "service_discovery/zookeeper/zk_paths.h"
+#include "plugin_system/plugin_descriptor.h"
 
 namespace BaseNode
 {
@@ -28,16 +30,76 @@ ErrorCode RouterModule::DoInit()
 
 ErrorCode RouterModule::DoUpdate()
 {
+    ReportMailboxMemory_();
     return ErrorCode::BN_SUCCESS;
 }
 
+void RouterModule::ReportMailboxMemory_()
+{
+    int64_t now_ns = ModuleReactor::NowNs();
+    if (last_mailbox_report_ns_ == 0) {
+        last_mailbox_report_ns_ = now_ns;
+        return;
+    }
+    if (now_ns - last_mailbox_report_ns_ < ROUTER_MAILBOX_REPORT_INTERVAL_MS * 1000000LL) {
+        return;
+    }
+    last_mailbox_report_ns_ = now_ns;
+
+    uint64_t total_bytes = 0;
+    for (IModule* module : ModuleRouterMgr->GetAllModules()) {
+        MailboxStats stats = module->GetMailboxStats();
+        total_bytes += stats.queue.memory_bytes;
+        BaseNodeLogInfo("[RouterModule] mailbox memory: module: %s, bytes: %lu, chunks: %lu, chunk_allocs: %lu, chunk_releases: %lu, depth: %u, high_water_mark: %lu",
+                        module->GetModuleName().c_str(), stats.queue.memory_bytes, stats.queue.allocated_chunks,
+                        stats.queue.chunk_allocs, stats.queue.chunk_releases, stats.leftover_depth, stats.queue.high_water_mark);
+        for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+            const MailboxLaneStats& lane_stats = stats.lanes[lane];
+            if (lane_stats.popped == 0) {
+                continue;
+            }
+            BaseNodeLogInfo("[RouterModule] mailbox lane: module: %s, lane: %u, popped: %lu, depth: %lu, queue_time avg: %luus max: %luus",
+                            module->GetModuleName().c_str(), lane, lane_stats.popped, lane_stats.depth,
+                            lane_stats.queue_time_sum_us / lane_stats.popped, lane_stats.queue_time_max_us);
+        }
+    }
+    BaseNodeLogInfo("[RouterModule] mailbox memory: total bytes: %lu", total_bytes);
+    // 与邮箱统计同一周期输出
+    ReportNetworkStats_();
+}
+
+void RouterModule::ReportNetworkStats_()
+{
+    if (!network_) {
+        return;
+    }
+    NetFrameStats output = network_->GetOutputStats();
+    uint64_t received_packets = received_packets_.load(std::memory_order_relaxed);
+    uint64_t received_frames = received_frames_.load(std::memory_order_relaxed);
+    BaseNodeLogInfo("[RouterModule] network: received packets: %lu, frames: %lu, frames/read: %.2f; sent frames: %lu, sends: %lu, frames/send: %.2f, flush_full: %lu, errors: %lu, forward failed frames: %lu",
+                    received_packets, received_frames, received_packets ? static_cast<double>(received_frames) / received_packets : 0.0,
+                    output.frames, output.packets, output.packets ? static_cast<double>(output.frames) / output.packets : 0.0,
+                    output.flush_full, output.errors, forward_failed_frames_.load(std::memory_order_relaxed));
+}
+
 ErrorCode RouterModule::DoUninit()
 {
     BaseNodeLogInfo("[RouterModule] DoUninit");
 
-    service_to_conn_.clear();
-
-    network_impl_ = nullptr;
+    instances_.Clear();
+
+    // 回调和路由表属于收包线程：在收包线程上换成空回调后清理，等待完成后本插件才能被卸载
+    // （Network 在本模块之后卸载，network_ 在此之前一直有效）
+    if (network_) {
+        network_->RunIngressTaskAndWait([this]() {
+            network_impl_->SetOnConnected([](ToolBox::NetworkType, uint64_t, uint64_t) {});
+            network_impl_->SetOnConnectFailed([](ToolBox::NetworkType, uint64_t, ToolBox::ENetErrCode, int32_t) {});
+            network_impl_->SetOnClose([](ToolBox::NetworkType, uint64_t, uint64_t, ToolBox::ENetErrCode, int32_t) {});
+            network_impl_->SetOnReceived([](ToolBox::NetworkType, uint64_t, uint64_t, const char*, size_t) {});
+            network_->SetOnOutputFailed(nullptr);
+            service_to_conn_.clear();
+        });
+    }
     initialized_ = false;
 
     return ErrorCode::BN_SUCCESS;
@@ -80,19 +142,43 @@ ErrorCode RouterModule::DoAfterAllModulesInit()
     
     BaseNodeLogInfo("[RouterModule] DoAfterAllModulesInit: Network module found, network_impl_=%p", network_impl_);
 
-    // 设置网络回调（主动连接模式）
+    // 网络库可能正由收包线程驱动，回调在收包线程上替换（见 InstallNetworkCallbacks_）
+    network_ = network;
+    network_->PostIngressTask([this]() { InstallNetworkCallbacks_(); });
+
+    if (!ModuleZkDiscoveryMgr) {
+        BaseNodeLogError("[RouterModule] DoAfterAllModulesInit: ModuleZkDiscoveryMgr is null");
+        return ErrorCode::BN_INVALID_ARGUMENTS;
+    }
+
+    // 发现所有服务并建立连接
+    DiscoverAndConnectAllServices();
+
+    // 监听服务目录变化，动态发现新服务
+    // 通过 Zookeeper 客户端监听 /basenode/services 目录
+    // 当发现新服务时，自动监听其实例变化
+    
+    BaseNodeLogInfo("[RouterModule] DoAfterAllModulesInit: service discovery ready");
+    return ErrorCode::BN_SUCCESS;
+}
+
+void RouterModule::InstallNetworkCallbacks_()
+{
+    // 设置网络回调（主动连接模式）：转发留在收包线程上，连接事件交给主循环更新实例簿记
     network_impl_->SetOnConnected([this](ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id) {
-        OnConnected(type, opaque, conn_id);
+        RunOnModule_([this, type, opaque, conn_id]() { OnConnected(type, opaque, conn_id); });
     });
 
     network_impl_->SetOnConnectFailed([this](ToolBox::NetworkType type, uint64_t opaque,
                                             ToolBox::ENetErrCode err_code, int32_t err_no) {
-        OnConnectFailed(type, opaque, err_code, err_no);
+        RunOnModule_([this, type, opaque, err_code, err_no]() { OnConnectFailed(type, opaque, err_code, err_no); });
     });
 
     network_impl_->SetOnClose([this](ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id,
                                     ToolBox::ENetErrCode net_err, int32_t sys_err) {
-        OnClose(type, opaque, conn_id, net_err, sys_err);
+        // 发送队列属于收包线程，在这里直接丢弃
+        network_->DiscardOutput(conn_id);
+        RunOnModule_([this, type, opaque, conn_id, net_err, sys_err]() { OnClose(type, opaque, conn_id, net_err, sys_err); });
     });
 
     network_impl_->SetOnReceived([this](ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id,
@@ -100,41 +186,36 @@ ErrorCode RouterModule::DoAfterAllModulesInit()
         OnReceived(type, opaque, conn_id, data, size);
     });
 
-    if (!ModuleZkDiscoveryMgr) {
-        BaseNodeLogError("[RouterModule] DoAfterAllModulesInit: ModuleZkDiscoveryMgr is null");
-        return ErrorCode::BN_INVALID_ARGUMENTS;
-    }
-
-    // 发现所有服务并建立连接
-    DiscoverAndConnectAllServices();
+    // 合并发送时 SendFrame 总是成功，发送失败在本轮结束时才报告（Network 已记录错误日志）
+    network_->SetOnOutputFailed([this](uint64_t, uint32_t frames, ToolBox::ENetErrCode) {
+        forward_failed_frames_.fetch_add(frames, std::memory_order_relaxed);
+    });
+    BaseNodeLogInfo("[RouterModule] InstallNetworkCallbacks_: network callbacks installed");
+}
 
-    // 监听服务目录变化，动态发现新服务
-    // 通过 Zookeeper 客户端监听 /basenode/services 目录
-    // 当发现新服务时，自动监听其实例变化
-    
-    BaseNodeLogInfo("[RouterModule] DoAfterAllModulesInit: service discovery ready");
-    return ErrorCode::BN_SUCCESS;
+void RouterModule::RunOnModule_(std::function<void()> func)
+{
+    ModuleEvent event;
+    event.type_ = ModuleEvent::EventType::ET_LOCAL_CALL;
+    event.task_ = MakeModuleTask([func = std::move(func)](IModule&) { func(); });
+    ErrorCode err = ModuleRouterMgr->PostLocalEvent(GetModuleId(), std::move(event));
+    if (err != ErrorCode::BN_SUCCESS) {
+        BaseNodeLogError("[RouterModule] RunOnModule_: failed to post connection event to module thread, error: %d", static_cast<int>(err));
+    }
 }
 
 void RouterModule::OnConnected(ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id)
 {
-    std::string host;
-    uint16_t port = 0;
-    {
-        auto it = pending_connections_.find(opaque);
-        if (it == pending_connections_.end()) {
-            BaseNodeLogWarn("[RouterModule] OnConnected: pending connection not found, opaque=%lu", opaque);
-            return;
-        }
-        host = it->second.first;
-        port = it->second.second;
-        pending_connections_.erase(it);
+    RouterEndpoint endpoint;
+    if (!instances_.TakePending(opaque, endpoint)) {
+        BaseNodeLogWarn("[RouterModule] OnConnected: pending connection not found, opaque=%lu", opaque);
+        return;
     }
 
     // 同一 host:port 下所有实例共用这一条连接
-    int count = SetConnectionID(host, port, conn_id);
+    int count = instances_.SetConnectionID(endpoint.host, endpoint.port, conn_id);
     BaseNodeLogInfo("[RouterModule] OnConnected: connected to %s:%u, conn_id=%lu, instances=%d (one connection shared)",
-                   host.c_str(), port, conn_id, count);
+                   endpoint.host.c_str(), endpoint.port, conn_id, count);
 }
 
 void RouterModule::OnConnectFailed(ToolBox::NetworkType type, uint64_t opaque,
@@ -144,9 +225,8 @@ void RouterModule::OnConnectFailed(ToolBox::NetworkType type, uint64_t opaque,
                     static_cast<int>(type), opaque, static_cast<int>(err_code), err_no);
 
     // 清理待连接记录
-    {
-        pending_connections_.erase(opaque);
-    }
+    RouterEndpoint endpoint;
+    instances_.TakePending(opaque, endpoint);
 }
 
 void RouterModule::OnClose(ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id,
@@ -156,47 +236,40 @@ void RouterModule::OnClose(ToolBox::NetworkType type, uint64_t opaque, uint64_t
                    static_cast<int>(type), opaque, conn_id, static_cast<int>(net_err), sys_err);
 
     // 查找对应的实例键
-    std::vector<uint64_t> instance_keys = GetInstanceIDsByConnectionID(conn_id);
+    std::vector<uint64_t> instance_keys = instances_.GetInstanceIDsByConnectionID(conn_id);
 
     for (const auto& instance_key : instance_keys) {
-        key_to_instance_.erase(instance_key);
+        instances_.Erase(instance_key);
     }
 }
 
 void RouterModule::OnReceived(ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id,
                              const char* data, size_t size)
 {
-    std::string rpc_data(data, size);
-
-    // 提取服务ID和客户端ID
-    auto [service_id, client_id] = ExtractServiceIdClientId(std::string_view(rpc_data));
-    if (service_id == 0 || client_id == 0) {
-        BaseNodeLogError("[RouterModule] OnReceived: failed to extract service_id/client_id");
-        return;
+    received_packets_.fetch_add(1, std::memory_order_relaxed);
+    size_t frames = NetMultiFrame::ForEachFrame(std::string_view(data, size), [this, conn_id](size_t, std::string_view frame) {
+        OnFrameReceived_(conn_id, frame);
+    });
+    if (frames == 0) {
+        BaseNodeLogError("[RouterModule] OnReceived: malformed multi-frame packet, conn_id=%lu, size=%zu", conn_id, size);
     }
+    received_frames_.fetch_add(frames, std::memory_order_relaxed);
+}
 
-    // 判断是请求还是响应
-    using namespace ToolBox::CoroRpc;
-    CoroRpcProtocol::ReqHeader header;
-    Errc err = CoroRpcProtocol::ReadHeader(rpc_data, header);
-    if (err != Errc::SUCCESS) {
-        BaseNodeLogError("[RouterModule] OnReceived: failed to read header");
+void RouterModule::OnFrameReceived_(uint64_t conn_id, std::string_view rpc_data)
+{
+    // 协议头只解析一次，数据包直接转发，不再拷贝
+    RpcEnvelope envelope;
+    if (RpcEnvelope::Parse(rpc_data, envelope) != ErrorCode::BN_SUCCESS ||
+        envelope.service_id == 0 || envelope.client_id == 0) {
+        BaseNodeLogError("[RouterModule] OnReceived: failed to extract service_id/client_id");
         return;
     }
 
-    // 判断是请求还是响应：请求的 msg_type 通常是 0 或特定值
-    // 简化判断：根据协议头判断，实际需要根据协议定义
-    bool is_request = true;  // TODO: 根据实际协议判断请求/响应
-
-    if (is_request) {
-        // RPC 请求：路由到目标进程
-        RouteRpcRequest(service_id, client_id, conn_id, std::move(rpc_data));
-    } else {
-        // RPC 响应：路由回源进程
-        // 响应来自目标进程（conn_id），需要路由回源进程
-        // 简化：通过 client_id（目标模块ID）查找源连接
-        RouteRpcResponse(client_id, conn_id, std::move(rpc_data));
-    }
+    // 目前所有帧都按请求转发：协议头的 msg_type 是 CoroRpc 的保留字段，请求和响应都不设置，
+    // 不能用来区分（ModuleRouter 对网络包也同样按请求处理）。响应路由（RouteRpcResponse）需要先记录请求上下文，
+    // 届时由发送响应的一方在协议头中标记
+    RouteRpcRequest(envelope, conn_id, rpc_data);
 }
 
 void RouterModule::OnServiceInstancesChanged(const std::string& zk_path, const ServiceDiscovery::InstanceList& instances)
@@ -215,7 +288,7 @@ void RouterModule::OnServiceInstancesChanged(const std::string& zk_path, const S
     // 断开不再存在的实例
     std::vector<ServiceDiscovery::ServiceInstance> instances_to_disconnect;
     {
-        for (auto& [instance_key, instance_struct] : key_to_instance_) {
+        for (auto& [instance_key, instance_struct] : instances_.Instances()) {
             if (current_instance_keys.find(instance_struct.instance_id) == current_instance_keys.end()) {
                 instances_to_disconnect.push_back(instance_struct);
             }
@@ -241,10 +314,10 @@ void RouterModule::OnServiceInstancesChanged(const std::string& zk_path, const S
         }
         BaseNodeLogDebug("[RouterModule] OnServiceInstancesChanged: instance %s.", instance.SerializeInstance().c_str());
 
-        auto iter_instance = key_to_instance_.find(instance.instance_id);
-        if (iter_instance == key_to_instance_.end()) {
-            if (CheckIPPortExist(instance.host, instance.port)) {
-                key_to_instance_[instance.instance_id] = instance;
+        const ServiceDiscovery::ServiceInstance* found_instance = instances_.Find(instance.instance_id);
+        if (!found_instance) {
+            if (instances_.HasEndpoint(instance.host, instance.port)) {
+                instances_.Upsert(instance);
             } else {
                 // 新实例，需要连接
                 ConnectToInstance(instance);
@@ -253,7 +326,8 @@ void RouterModule::OnServiceInstancesChanged(const std::string& zk_path, const S
         }
         
         // 已存在的实例，检查是否需要更新
-        auto &exist_instance = iter_instance->second;
+        // DisconnectFromInstance 会删除该实例，这里拷贝一份
+        const ServiceDiscovery::ServiceInstance exist_instance = *found_instance;
         if (exist_instance.connection_id == 0) {
             ConnectToInstance(instance);
             continue;
@@ -272,8 +346,8 @@ void RouterModule::OnServiceInstancesChanged(const std::string& zk_path, const S
             continue;
         }
     }
-    BaseNodeLogInfo("[RouterModule] OnServiceInstancesChanged: instances changed, current_instance_keys=%zu, instances:%d, key_to_instance_size:%d", 
-        current_instance_keys.size(), instances.size(), key_to_instance_.size());
+    BaseNodeLogInfo("[RouterModule] OnServiceInstancesChanged: instances changed, current_instance_keys=%zu, instances:%d, instance_count:%zu",
+        current_instance_keys.size(), instances.size(), instances_.Size());
 }
 
 void RouterModule::ConnectToInstance(const ServiceDiscovery::ServiceInstance& instance)
@@ -285,12 +359,12 @@ void RouterModule::ConnectToInstance(const ServiceDiscovery::ServiceInstance& in
 
     // 已有同一 host:port 的已建立连接 -> 复用，只把本实例加入并设 connection_id
     {
-        uint64_t existing_conn_id = GetConnectionIDbyIPPort(instance.host, instance.port);
+        uint64_t existing_conn_id = instances_.GetConnectionID(instance.host, instance.port);
         if (existing_conn_id != 0) {
             auto inst_copy = instance;
             inst_copy.connection_id = existing_conn_id;
             inst_copy.healthy = true;
-            key_to_instance_[instance.instance_id] = inst_copy;
+            instances_.Upsert(inst_copy);
             BaseNodeLogTrace("[RouterModule] ConnectToInstance: reusing connection %s:%u conn_id=%lu for instance %lu",
                              instance.host.c_str(), instance.port, existing_conn_id, instance.instance_id);
             return;
@@ -298,22 +372,21 @@ void RouterModule::ConnectToInstance(const ServiceDiscovery::ServiceInstance& in
     }
 
     // 已有同一 host:port 的待连接 -> 只把本实例加入，等 OnConnected 时一起设 conn_id
-    {
-        for (const auto& pair : pending_connections_) {
-            if (pair.second.first == instance.host && pair.second.second == instance.port) {
-                key_to_instance_[instance.instance_id] = instance;
-                BaseNodeLogTrace("[RouterModule] ConnectToInstance: connection in progress to %s:%u for instance %lu",
-                                 instance.host.c_str(), instance.port, instance.instance_id);
-                return;
-            }
-        }
+    if (instances_.HasPending(instance.host, instance.port)) {
+        instances_.Upsert(instance);
+        BaseNodeLogTrace("[RouterModule] ConnectToInstance: connection in progress to %s:%u for instance %lu",
+                         instance.host.c_str(), instance.port, instance.instance_id);
+        return;
     }
 
     // 首次对该 host:port 发起连接
     uint64_t opaque = next_opaque_.fetch_add(1);
-    pending_connections_[opaque] = std::make_pair(instance.host, instance.port);
-    key_to_instance_[instance.instance_id] = instance;
-    network_impl_->Connect(ToolBox::NetworkType::NT_TCP, opaque, instance.host, instance.port);
+    instances_.AddPending(opaque, instance.host, instance.port);
+    instances_.Upsert(instance);
+    // Connect 只能在驱动网络库的线程上调用
+    network_->PostIngressTask([this, opaque, host = instance.host, port = instance.port]() {
+        network_impl_->Connect(ToolBox::NetworkType::NT_TCP, opaque, host, port);
+    });
     BaseNodeLogInfo("[RouterModule] ConnectToInstance: connecting to %s:%u, opaque=%lu (one connection for all instances at this address)",
                     instance.host.c_str(), instance.port, opaque);
 }
@@ -324,34 +397,33 @@ void RouterModule::DisconnectFromInstance(const ServiceDiscovery::ServiceInstanc
         return;
     uint64_t conn_id = instance.connection_id;
     // 同一连接被多个实例复用，只 Close 一次并清理所有共享该连接的实例
-    std::vector<uint64_t> instance_ids = GetInstanceIDsByConnectionID(conn_id);
-    network_impl_->Close(conn_id);
+    std::vector<uint64_t> instance_ids = instances_.GetInstanceIDsByConnectionID(conn_id);
+    network_->PostIngressTask([this, conn_id]() {
+        network_->DiscardOutput(conn_id);
+        network_impl_->Close(conn_id);
+    });
     for (uint64_t id : instance_ids)
-        key_to_instance_.erase(id);
+        instances_.Erase(id);
     BaseNodeLogInfo("[RouterModule] DisconnectFromInstance: closed conn_id=%lu, cleared %zu instances at %s:%u",
                    conn_id, instance_ids.size(), instance.host.c_str(), instance.port);
 }
 
-std::tuple<uint32_t, uint64_t> RouterModule::ExtractServiceIdClientId(std::string_view rpc_data)
+ErrorCode RouterModule::RouteRpcRequest(const RpcEnvelope& envelope, uint64_t source_conn_id, std::string_view rpc_data)
 {
-    using namespace ToolBox::CoroRpc;
-    
-    CoroRpcProtocol::ReqHeader header;
-    Errc err = CoroRpcProtocol::ReadHeader(rpc_data, header);
-    if (err != Errc::SUCCESS) {
-        return std::make_tuple(0, 0);
+    uint32_t service_id = envelope.service_id;
+    BaseNodeLogTrace("[RouterModule] RouteRpcRequest: service_id=%u, client_id=%lu, request_id=%u, source_conn_id=%lu",
+                    service_id, envelope.client_id, envelope.request_id, source_conn_id);
+    // 被采样的请求记录网络和转发 span（数据包原样转发，下游看到的父 span 仍是调用方的发送 span）
+    const int64_t receive_us = envelope.trace_id != 0 ? RpcTracer::NowUs() : 0;
+
+    // 调用方已经放弃的请求不再转发
+    if (envelope.Expired()) {
+        RpcDropStatsMgr->Record(RpcDropReason::DEADLINE_AT_FORWARD);
+        BaseNodeLogDebug("[RouterModule] RouteRpcRequest: drop expired request, service_id=%u, request_id=%u, deadline_ms=%ld",
+                         service_id, envelope.request_id, envelope.deadline_ms);
+        return ErrorCode::BN_RPC_DEADLINE_EXCEEDED;
     }
 
-    uint32_t service_id = CoroRpcProtocol::GetRpcFuncKey(header);
-    uint64_t client_id = CoroRpcProtocol::GetClientID(header);
-    return std::make_tuple(service_id, client_id);
-}
-
-ErrorCode RouterModule::RouteRpcRequest(uint32_t service_id, uint64_t client_id, uint64_t source_conn_id, std::string&& rpc_data)
-{
-    BaseNodeLogTrace("[RouterModule] RouteRpcRequest: service_id=%u, client_id=%lu, source_conn_id=%lu",
-                    service_id, client_id, source_conn_id);
-
     // 查找目标连接
     uint64_t target_conn_id = 0;
     {
@@ -368,10 +440,12 @@ ErrorCode RouterModule::RouteRpcRequest(uint32_t service_id, uint64_t client_id,
     // 更好的方式：使用请求ID
     // TODO: 实现请求上下文管理
 
-    // 发送到目标进程
-    if (network_impl_ && target_conn_id != 0) {
-        ToolBox::ENetErrCode err = network_impl_->Send(target_conn_id, rpc_data.data(), static_cast<uint32_t>(rpc_data.size()));
+    // 发送到目标进程：coalesce 打开时同一轮收包中发往同一连接的帧合并成一个包，在本轮结束时发送，
+    // 这时的发送失败经 SetOnOutputFailed 的回调计数；下面的错误只在直接发送时出现
+    if (network_ && target_conn_id != 0) {
+        ToolBox::ENetErrCode err = network_->SendFrame(target_conn_id, rpc_data);
         if (err != ToolBox::ENetErrCode::NET_SUCCESS) {
+            forward_failed_frames_.fetch_add(1, std::memory_order_relaxed);
             BaseNodeLogError("[RouterModule] RouteRpcRequest: failed to send, error: %d", static_cast<int>(err));
             return ErrorCode::BN_NETWORK_START_FAILED;
         }
@@ -379,13 +453,38 @@ ErrorCode RouterModule::RouteRpcRequest(uint32_t service_id, uint64_t client_id,
                         service_id, source_conn_id, target_conn_id);
     }
 
+    if (envelope.trace_id != 0) {
+        RecordForwardSpans_(envelope, receive_us);
+    }
     return ErrorCode::BN_SUCCESS;
 }
 
-ErrorCode RouterModule::RouteRpcResponse(uint64_t target_module_id, uint64_t response_conn_id, std::string&& rpc_data)
+void RouterModule::RecordForwardSpans_(const RpcEnvelope& envelope, int64_t receive_us)
 {
-    BaseNodeLogTrace("[RouterModule] RouteRpcResponse: target_module_id=%lu, response_conn_id=%lu", 
-                    target_module_id, response_conn_id);
+    RpcSpan span;
+    span.trace_id = envelope.trace_id;
+    span.parent_span_id = envelope.parent_span_id;
+    span.service_id = envelope.service_id;
+    span.request_id = envelope.request_id;
+    span.module_id = GetModuleId();
+    if (envelope.trace_send_us > 0) {
+        span.span_id = RpcTracer::NewId();
+        span.begin_us = envelope.trace_send_us;
+        span.end_us = receive_us;
+        span.kind = RpcSpanKind::NETWORK;
+        RpcTracerMgr->Record(span);
+    }
+    span.span_id = RpcTracer::NewId();
+    span.begin_us = receive_us;
+    span.end_us = RpcTracer::NowUs();
+    span.kind = RpcSpanKind::ROUTER_FORWARD;
+    RpcTracerMgr->Record(span);
+}
+
+ErrorCode RouterModule::RouteRpcResponse(const RpcEnvelope& envelope, uint64_t response_conn_id, std::string_view rpc_data)
+{
+    BaseNodeLogTrace("[RouterModule] RouteRpcResponse: target_module_id=%lu, request_id=%u, response_conn_id=%lu", 
+                    envelope.client_id, envelope.request_id, response_conn_id);
 
     // 响应路由：响应来自目标进程（response_conn_id），需要路由回源进程
     // 简化实现：通过请求上下文查找源连接
@@ -428,7 +527,8 @@ void RouterModule::DiscoverAndConnectAllServices()
             ModuleZkDiscoveryMgr->WatchServiceInstances(services_path,
                 instance_list,
                 [this](const std::string& svc_name, const ServiceDiscovery::InstanceList& instances) {
-                    OnServiceInstancesChanged(svc_name, instances);
+                    // watch 回调在服务发现的线程上触发，实例簿记只在主循环上访问
+                    RunOnModule_([this, svc_name, instances]() { OnServiceInstancesChanged(svc_name, instances); });
                 });
         }
     }
@@ -440,7 +540,7 @@ void RouterModule::DiscoverAndConnectAllServices()
 
     // 监听服务目录变化，动态发现新服务
     ModuleZkDiscoveryMgr->WatchServicesDirectory(
-        [this, &instance_list](const std::string& service_name, const ServiceDiscovery::InstanceList& instances) {
+        [this, instance_list](const std::string& service_name, const ServiceDiscovery::InstanceList& instances) {
             // 检查是否是新服务
             bool is_new_service = false;
             {
@@ -456,7 +556,7 @@ void RouterModule::DiscoverAndConnectAllServices()
                 ModuleZkDiscoveryMgr->WatchServiceInstances(service_name,
                     instance_list,
                     [this](const std::string& svc_name, const ServiceDiscovery::InstanceList& insts) {
-                        OnServiceInstancesChanged(svc_name, insts);
+                        RunOnModule_([this, svc_name, insts]() { OnServiceInstancesChanged(svc_name, insts); });
                     });
             }
             
@@ -481,66 +581,22 @@ void RouterModule::OnServicesDirectoryChanged(const std::string& path)
     // 暂时通过其他方式实现
 }
 
-uint64_t RouterModule::GetConnectionIDbyIPPort(const std::string& ip, uint16_t port)
-{
-    for (const auto& [key, instance] : key_to_instance_) {
-        if (instance.host == ip && instance.port == port) {
-            return instance.connection_id;
-        }
-    }
-    return 0;
-}
-
-bool RouterModule::CheckIPPortExist(const std::string& ip, uint16_t port)
-{
-    for (const auto& [key, instance] : key_to_instance_) {
-        if (instance.host == ip && instance.port == port) {
-            return true;
-        }
-    }
-    return false;
-}
-
-int RouterModule::SetConnectionID(const std::string& ip, uint16_t port, uint64_t connection_id)
-{
-    int count = 0;
-    for (auto& [key, instance] : key_to_instance_) {
-        if (instance.host == ip && instance.port == port) {
-            instance.connection_id = connection_id;
-            instance.healthy = true;
-            count++;
-            BaseNodeLogDebug("[RouterModule] SetConnectionID: conn_id=%lu for instance %lu", connection_id, instance.instance_id);
-        }
-    }
-    return count;
-}
-
-std::vector<uint64_t> RouterModule::GetInstanceIDsByConnectionID(uint64_t connection_id)
-{
-    std::vector<uint64_t> instance_ids;
-    for (const auto& [key, instance] : key_to_instance_) {
-        if (instance.connection_id == connection_id) {
-            instance_ids.push_back(instance.instance_id);
-        }
-    }
-    return instance_ids;
-}
-
-
 } // namespace BaseNode
 
-// 导出符号
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT() {
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
     using namespace BaseNode;
     RouterModuleMgr->Init();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
+static void UpdatePlugin() {
     using namespace BaseNode;
     RouterModuleMgr->Update();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT() {
+static void UninitPlugin() {
     using namespace BaseNode;
     RouterModuleMgr->UnInit();
 }
+
+BASENODE_PLUGIN_DESCRIPTOR("router", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
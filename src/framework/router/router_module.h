@@ -1,11 +1,15 @@
 #pragma once
 
 #include "module_interface.h"
+#include "module/module_rpc_envelope.h"
+#include "module/module_rpc_trace.h"
 #include "module/module_zk.h"
 #include "service_discovery/service_discovery_core.h"
 #include "utils/basenode_def_internal.h"
 #include "network/network_api.h"
+#include "router/router_instance_index.h"
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -16,6 +20,10 @@
 namespace BaseNode
 {
 
+class Network;
+
+#define ROUTER_MAILBOX_REPORT_INTERVAL_MS 60000   // 输出各模块邮箱内存统计的间隔
+
 /**
  * @brief 中心路由模块
  * 
@@ -24,8 +32,14 @@ namespace BaseNode
  * 2. 主动连接所有业务进程
  * 3. 维护 service_id -> conn_id 的路由表
  * 4. 在不同进程间转发 RPC 请求/响应
+ *
+ * 线程：网络库的回调在收包线程（驱动网络库的线程）上触发。OnReceived 直接在收包线程上转发，
+ * service_to_conn_ 只在该线程上访问。服务发现的 watch 回调在服务发现自己的线程上触发。连接事件
+ * （OnConnected / OnConnectFailed / OnClose）和实例变化（OnServiceInstancesChanged）都经本模块邮箱
+ * 回到主循环处理，实例簿记（instances_）只在主循环上访问。主循环上的 Connect / Close
+ * 经 Network::PostIngressTask 在收包线程上执行。
  */
-class RouterModule : public IModule
+class RouterModule : public ModuleBase<RouterModule>
 {
 public:
     RouterModule();
@@ -56,7 +70,7 @@ private:
                 ToolBox::ENetErrCode net_err, int32_t sys_err);
 
     /**
-     * @brief 处理来自业务进程的数据
+     * @brief 处理来自业务进程的数据（多帧包逐帧处理，见 NetMultiFrame）
      */
     void OnReceived(ToolBox::NetworkType type, uint64_t opaque, uint64_t conn_id,
                    const char* data, size_t size);
@@ -78,22 +92,26 @@ private:
     void DisconnectFromInstance(const ServiceDiscovery::ServiceInstance& instance);
 
     /**
-     * @brief 从 RPC 数据中提取服务ID和客户端ID
+     * @brief 路由 RPC 请求到目标进程
+     * @param envelope 入口处解析好的协议头
+     * @param source_conn_id 请求来自的连接
+     * @param rpc_data RPC 请求数据
      */
-    std::tuple<uint32_t, uint64_t> ExtractServiceIdClientId(std::string_view rpc_data);
+    ErrorCode RouteRpcRequest(const RpcEnvelope& envelope, uint64_t source_conn_id, std::string_view rpc_data);
 
     /**
-     * @brief 路由 RPC 请求到目标进程
+     * @brief 记录被采样请求的网络 span（调用方发出到收到）和转发 span（收到到转发完成）
+     * @param receive_us 收到请求的时间（Unix 微秒）
      */
-    ErrorCode RouteRpcRequest(uint32_t service_id, uint64_t client_id, uint64_t source_conn_id, std::string&& rpc_data);
+    void RecordForwardSpans_(const RpcEnvelope& envelope, int64_t receive_us);
 
     /**
-     * @brief 路由 RPC 响应到源进程
-     * @param target_module_id 目标模块ID（响应要发送到的模块）
+     * @brief 路由 RPC 响应到源进程（尚未接入：目前无法从协议头区分响应，见 OnFrameReceived_）
+     * @param envelope 入口处解析好的协议头（client_id 为响应要发送到的模块）
      * @param response_conn_id 响应来自的连接（目标进程的连接）
      * @param rpc_data RPC 响应数据
      */
-    ErrorCode RouteRpcResponse(uint64_t target_module_id, uint64_t response_conn_id, std::string&& rpc_data);
+    ErrorCode RouteRpcResponse(const RpcEnvelope& envelope, uint64_t response_conn_id, std::string_view rpc_data);
 
     /**
      * @brief 发现所有服务并建立连接
@@ -106,37 +124,43 @@ private:
     void OnServicesDirectoryChanged(const std::string& path);
 
     /**
-     * @brief 获取实例
-     **/
-     uint64_t GetConnectionIDbyIPPort(const std::string& ip, uint16_t port);
+     * @brief 在本模块线程（主循环）上执行，用于把收包线程上的连接事件和服务发现线程上的实例变化交给主循环处理
+     */
+    void RunOnModule_(std::function<void()> func);
+
+    /**
+     * @brief 在收包线程上设置网络库回调
+     */
+    void InstallNetworkCallbacks_();
 
     /**
-     * @brief 获取实例
-     **/
-    bool CheckIPPortExist(const std::string& ip, uint16_t port);
+     * @brief 处理收到的一个 RPC 帧
+     */
+    void OnFrameReceived_(uint64_t conn_id, std::string_view rpc_data);
 
     /**
-     * @brief 设置连接ID
-     * @param ip 地址
-     * @param port 端口
-     * @param connection_id 连接ID
-     * @return 设置了多少个实例的连接ID
-    */
-    int SetConnectionID(const std::string& ip, uint16_t port, uint64_t connection_id);
+     * @brief 定期输出本进程各模块的邮箱内存占用
+     */
+    void ReportMailboxMemory_();
 
-    std::vector<uint64_t> GetInstanceIDsByConnectionID(uint64_t connection_id);
+    /**
+     * @brief 输出收发的帧数和包数（每次系统调用平均处理的帧数）
+     */
+    void ReportNetworkStats_();
 
 private:
+    Network* network_ = nullptr;                // 转发经 Network::SendFrame 发送（coalesce 打开时按连接聚合）
     ToolBox::Network* network_impl_ = nullptr;
+    std::atomic<uint64_t> received_packets_{0}; // 收到的包数（收包线程上累加）
+    std::atomic<uint64_t> received_frames_{0};  // 收到的帧数
+    std::atomic<uint64_t> forward_failed_frames_{0};  // 转发失败的帧数（直接发送失败或合并发送失败）
 
-    // 服务ID -> 连接ID 的映射（路由表）
+    // 服务ID -> 连接ID 的映射（路由表），只在收包线程上访问
     std::unordered_map<uint32_t, uint64_t> service_to_conn_;
 
-    // 服务ID -> instance 的映射
-    std::unordered_map<uint64_t, ServiceDiscovery::ServiceInstance> key_to_instance_;
-
-    // 待连接：opaque -> (host, port)，同一 host:port 只建立一条连接，OnConnected 时对该地址下所有实例设置 conn_id
-    std::unordered_map<uint64_t, std::pair<std::string, uint16_t>> pending_connections_;
+    // 实例ID -> instance，以及按地址、连接ID和待连接的索引
+    // 同一 host:port 只建立一条连接，OnConnected 时对该地址下所有实例设置 conn_id
+    RouterInstanceIndex instances_;
     std::atomic<uint64_t> next_opaque_{1};
 
     // 已监听的服务名集合
@@ -144,6 +168,8 @@ private:
     std::mutex watched_services_mutex_;
 
     bool initialized_ = false;
+
+    int64_t last_mailbox_report_ns_ = 0;
 };
 
 #define RouterModuleMgr ToolBox::Singleton<RouterModule>::Instance()
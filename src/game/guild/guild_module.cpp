@@ -5,6 +5,7 @@
 #include "protobuf/pb_out/errcode.pb.h"
 #include "service_discovery/service_discovery_core.h"
 #include "service_discovery/zookeeper/zk_service_discovery_module.h"
+#include "plugin_system/plugin_descriptor.h"
 #include <chrono>
 #include <exception>
 
@@ -21,11 +22,12 @@ ErrorCode Guild::DoInit()
     // 注册基于 PB 的流式 RPC 服务：GetGuildMembersStreamPB
     RegisterService<&Guild::OnPlayerLogin,
                     &Guild::OnPlayerLoginCoro,
-                    &Guild::GetGuildMembersStream,
                     &Guild::GetGuildMemberIdsStream,
                     &Guild::GetGuildInfo,
-                    &Guild::GetGuildInfoCoro,
-                    &Guild::GetGuildMembersStreamPB>(this);
+                    &Guild::GetGuildInfoCoro>(this);
+    // 成员列表传输量大，放到低优先级通道，避免登录等小请求排在后面
+    RegisterService<&Guild::GetGuildMembersStream,
+                    &Guild::GetGuildMembersStreamPB>(RpcPriority::BULK, this);
 
 
     return ErrorCode::BN_SUCCESS;
@@ -64,6 +66,8 @@ ToolBox::coro::Task<std::monostate> Guild::OnPlayerLoginCoro(uint64_t player_id)
 ToolBox::CoroRpc::StreamGenerator<std::string> Guild::GetGuildMembersStream(uint64_t guild_id)
 {
     BaseNodeLogInfo("GuildModule GetGuildMembersStream: guild_id: %llu", guild_id);
+    // 第一次挂起之前取得取消令牌，调用方已经放弃（截止时间已过）时不再继续返回
+    RpcCancellationToken token = CurrentRequestToken();
     
     // 模拟公会成员数据（实际应该从数据库或缓存中获取）
     // 假设有100个成员，每次返回10个
@@ -71,6 +75,11 @@ ToolBox::CoroRpc::StreamGenerator<std::string> Guild::GetGuildMembersStream(uint
     constexpr int kBatchSize = 10;
     
     for (int batch = 0; batch < kTotalMembers / kBatchSize; ++batch) {
+        if (token.IsCancelled()) {
+            RpcDropStatsMgr->Record(RpcDropReason::HANDLER_CANCELLED);
+            BaseNodeLogWarn("GuildModule GetGuildMembersStream: cancelled at batch %d, guild_id: %llu", batch + 1, guild_id);
+            co_return;
+        }
         // 构造一批成员信息（实际应该是结构化的数据，这里用字符串模拟）
         std::string batch_data = "Guild " + std::to_string(guild_id) + " Members Batch " + 
                                  std::to_string(batch + 1) + ": ";
@@ -292,16 +301,19 @@ ToolBox::CoroRpc::StreamGenerator<guild::GetGuildMembersStreamResponse> Guild::G
     BaseNodeLogInfo("GuildModule GetGuildMembersStreamPB: completed, guild_id: %llu", guild_id);
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT() {
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
     GuildMgr->Init();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
+static void UpdatePlugin() {
     GuildMgr->Update();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT() {
+static void UninitPlugin() {
     GuildMgr->UnInit();  // 调用基类的UnInit方法
 }
 
+BASENODE_PLUGIN_DESCRIPTOR("guild", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
+
 } // namespace BaseNode
\ No newline at end of file
@@ -21,7 +21,7 @@ class GetGuildMembersStreamResponse;
 
 namespace BaseNode
 {
-class Guild : public IModule
+class Guild : public ModuleBase<Guild>
 {
 public:
 
@@ -5,6 +5,7 @@
 #include "protobuf/pb_out/errcode.pb.h"
 #include "service_discovery/service_discovery_core.h"
 #include "service_discovery/zookeeper/zk_service_discovery_module.h"
+#include "plugin_system/plugin_descriptor.h"
 #include <exception>
 
 namespace BaseNode
@@ -41,6 +42,10 @@ ErrorCode Player::OnLogin(uint64_t player_id)
     //     BaseNodeLogInfo("PlayerModule OnLogin: Guild::OnPlayerLoginCoro completed, version 2");
     // });
 
+    // // 3 秒后推送欢迎消息（协程休眠）
+    // SendWelcomeLater(player_id);
+    // // 同进程优先直接调用 Guild 模块的 OnPlayerLogin
+    // OnLoginLocalFirst(player_id);
     // // 使用协程方式调用 Guild 模块的 OnPlayerLogin RPC 服务
     // OnLoginCoroutine(player_id);
     // // 使用协程方式直接调用 Guild 模块的 OnPlayerLoginCoro RPC 服务
@@ -76,6 +81,34 @@ ErrorCode Player::OnLogin(uint64_t player_id)
     return ErrorCode::BN_SUCCESS;
 }
 
+ErrorCode Player::OnLoginLocalFirst(uint64_t player_id)
+{
+    // Guild 在本进程时参数直接以闭包投递给 Guild，结果以闭包投递回来，都在各自模块的线程上执行
+    ErrorCode err = CallModuleServiceLocal<&Guild::OnPlayerLogin>([player_id](ErrorCode ret) {
+        BaseNodeLogInfo("PlayerModule OnLoginLocalFirst: Guild::OnPlayerLogin completed locally, player_id: %llu, result: %d", player_id, static_cast<int>(ret));
+    }, player_id);
+    if (err == ErrorCode::BN_SUCCESS) {
+        return ErrorCode::BN_SUCCESS;
+    }
+    if (err != ErrorCode::BN_MODULE_NOT_LOCAL) {
+        BaseNodeLogError("PlayerModule OnLoginLocalFirst: local call failed, error: %d, fallback to RPC", static_cast<int>(err));
+    }
+    // Guild 不在本进程（或邮箱已满）：走 RPC
+    CallModuleService<&Guild::OnPlayerLogin>(player_id).then([player_id](auto result) {
+        BaseNodeLogInfo("PlayerModule OnLoginLocalFirst: Guild::OnPlayerLogin completed via RPC, player_id: %llu, result: %d", player_id, static_cast<int>(*result));
+    });
+    return ErrorCode::BN_SUCCESS;
+}
+
+ErrorCode Player::OnLoginBatch(uint64_t player_id)
+{
+    // 与 CallModuleService 用法相同，请求在本次 tick 结束（或达到 rpc_batch 配置的上限）时整批发送
+    CallModuleServiceBatch<&Guild::OnPlayerLogin>(player_id).then([player_id](auto result) {
+        BaseNodeLogDebug("PlayerModule OnLoginBatch: Guild::OnPlayerLogin completed, player_id: %llu, result: %d", player_id, static_cast<int>(*result));
+    });
+    return ErrorCode::BN_SUCCESS;
+}
+
 ToolBox::coro::Task<std::monostate> Player::OnLoginCoroutine(uint64_t player_id)
 {
     BaseNodeLogInfo("PlayerModule OnLoginCoroutine with coroutine, player_id: %llu", player_id);
@@ -472,16 +505,64 @@ ToolBox::coro::Task<std::monostate> Player::FetchGuildMembersByPB(uint64_t guild
     co_return std::monostate{};
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_INIT() {
+void Player::AddBuff(uint64_t player_id, uint32_t buff_id, uint32_t duration_ms)
+{
+    auto& timers = buff_timers_[player_id];
+    auto it = timers.find(buff_id);
+    if (it != timers.end()) {
+        // 重复添加：取消旧定时器，重新计时
+        CancelTimer(it->second);
+    }
+    timers[buff_id] = AddTimer(duration_ms, [this, player_id, buff_id]() {
+        BaseNodeLogInfo("PlayerModule buff expired, player_id: %llu, buff_id: %u", player_id, buff_id);
+        auto player_it = buff_timers_.find(player_id);
+        if (player_it == buff_timers_.end()) {
+            return;
+        }
+        player_it->second.erase(buff_id);
+        if (player_it->second.empty()) {
+            buff_timers_.erase(player_it);
+        }
+    });
+}
+
+void Player::RemoveBuff(uint64_t player_id, uint32_t buff_id)
+{
+    auto player_it = buff_timers_.find(player_id);
+    if (player_it == buff_timers_.end()) {
+        return;
+    }
+    auto it = player_it->second.find(buff_id);
+    if (it != player_it->second.end()) {
+        CancelTimer(it->second);
+        player_it->second.erase(it);
+    }
+    if (player_it->second.empty()) {
+        buff_timers_.erase(player_it);
+    }
+}
+
+ToolBox::coro::Task<std::monostate> Player::SendWelcomeLater(uint64_t player_id)
+{
+    // 挂起协程，3 秒后由模块的时间轮在模块线程上恢复
+    co_await SleepFor(std::chrono::milliseconds(3000));
+    BaseNodeLogInfo("PlayerModule SendWelcomeLater: welcome, player_id: %llu", player_id);
+    co_return std::monostate{};
+}
+
+// 插件入口（通过插件描述符导出）
+static void InitPlugin() {
     PlayerMgr->Init();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UPDATE() {
+static void UpdatePlugin() {
     PlayerMgr->Update();
 }
 
-extern "C" SO_EXPORT_SYMBOL void SO_EXPORT_FUNC_UNINIT() {
+static void UninitPlugin() {
     PlayerMgr->UnInit();
 }
 
+BASENODE_PLUGIN_DESCRIPTOR("player", "1.0.0", &InitPlugin, &UpdatePlugin, &UninitPlugin, nullptr)
+
 } // namespace BaseNode
\ No newline at end of file
@@ -4,14 +4,19 @@
 #include "utils/basenode_def_internal.h"
 #include "tools/cpp20_coroutine.h"
 #include <cstdint>
+#include <unordered_map>
 
 namespace BaseNode
 {
-class Player : public IModule
+class Player : public ModuleBase<Player>
 {
 public:
 
     ErrorCode OnLogin(uint64_t player_id);
+    // 同进程优先直接调用 Guild::OnPlayerLogin（跳过序列化），Guild 不在本进程时再走 RPC 的示例
+    ErrorCode OnLoginLocalFirst(uint64_t player_id);
+    // 登录风暴时使用批量调用通知 Guild：同一 tick 内的大量登录合并成少量批量帧的示例
+    ErrorCode OnLoginBatch(uint64_t player_id);
     // 使用协程方式调用 RPC 的示例（调用 Guild::OnPlayerLogin）
     ToolBox::coro::Task<std::monostate> OnLoginCoroutine(uint64_t player_id);
     // 使用协程方式直接调用 Guild::OnPlayerLoginCoro 的示例
@@ -29,6 +34,12 @@ public:
     
     // 使用 Zookeeper 服务发现 + RequestContext 选择 Guild 实例，再调用 PB RPC 的示例
     ToolBox::coro::Task<std::monostate> GetGuildInfoByServiceDiscovery(uint64_t guild_id);
+
+    // 定时器示例：玩家 buff 到期（每个 buff 一个定时器，重复添加时刷新到期时间）
+    void AddBuff(uint64_t player_id, uint32_t buff_id, uint32_t duration_ms);
+    void RemoveBuff(uint64_t player_id, uint32_t buff_id);
+    // 协程休眠示例：登录后延迟推送欢迎消息
+    ToolBox::coro::Task<std::monostate> SendWelcomeLater(uint64_t player_id);
     
 protected:
     virtual ErrorCode DoInit() override;
@@ -36,6 +47,9 @@ protected:
     virtual ErrorCode DoUninit() override;
 
 private:
+    // 玩家ID -> (buff ID -> 到期定时器)
+    std::unordered_map<uint64_t, std::unordered_map<uint32_t, TimerId>> buff_timers_;
+
     // 示例：如果你后续希望缓存 Invoker，可以在这里存一份
     // BaseNode::ServiceDiscovery::IInvokerPtr guild_info_invoker_;
 };
@@ -0,0 +1,56 @@
+#include "test_harness.h"
+#include <chrono>
+#include <cstdio>
+
+namespace BaseNode
+{
+
+void TestContext::Fail(const char* file, int line, const char* expr)
+{
+    // 同一处检查在循环中可能失败很多次，只打印前若干次
+    uint32_t failures = failures_.fetch_add(1, std::memory_order_relaxed);
+    if (failures < 20) {
+        fprintf(stderr, "  %s:%d: check failed: %s\n", file, line, expr);
+    }
+}
+
+void TestRunner::Add(const std::string& name, TestFunc func)
+{
+    cases_.push_back(TestCase{name, std::move(func)});
+}
+
+int TestRunner::Run(const TestOptions& options)
+{
+    uint32_t passed = 0;
+    uint32_t failed = 0;
+    for (const TestCase& test_case : cases_) {
+        if (!options.filter.empty() && test_case.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.list_only) {
+            printf("%s\n", test_case.name.c_str());
+            continue;
+        }
+        printf("[ RUN      ] %s\n", test_case.name.c_str());
+        fflush(stdout);
+        TestContext context;
+        auto started = std::chrono::steady_clock::now();
+        test_case.func(context);
+        int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+        if (context.Failures() == 0) {
+            ++passed;
+            printf("[       OK ] %s (%ld ms)\n", test_case.name.c_str(), elapsed_ms);
+        } else {
+            ++failed;
+            printf("[  FAILED  ] %s (%u failures, %ld ms)\n", test_case.name.c_str(), context.Failures(), elapsed_ms);
+        }
+        fflush(stdout);
+    }
+    if (options.list_only) {
+        return 0;
+    }
+    printf("%u passed, %u failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
+
+} // namespace BaseNode
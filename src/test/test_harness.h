@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace BaseNode
+{
+
+/**
+ * @brief 单个用例的上下文：检查失败时记录并继续执行，用例结束后统一判定
+ * 多线程用例的各个线程可以同时调用 Fail
+ */
+class TestContext
+{
+public:
+    void Fail(const char* file, int line, const char* expr);
+
+    uint32_t Failures() const { return failures_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> failures_{0};
+};
+
+/**
+ * @brief 检查表达式，失败时打印位置和表达式，不中断用例
+ */
+#define TEST_CHECK(ctx, expr)                                   \
+    do {                                                        \
+        if (!(expr)) {                                          \
+            (ctx).Fail(__FILE__, __LINE__, #expr);              \
+        }                                                       \
+    } while (0)
+
+using TestFunc = std::function<void(TestContext&)>;
+
+/**
+ * @brief 运行参数（命令行）
+ */
+struct TestOptions
+{
+    std::string filter;                         // 只运行名称包含该子串的用例
+    bool list_only = false;
+};
+
+/**
+ * @brief 测试运行器：按注册顺序运行匹配的用例，打印每个用例的结果
+ * 并发用例应该在 ThreadSanitizer 构建下运行（-DBASENODE_TSAN=ON），数据竞争由 TSan 报告并使进程以非 0 退出
+ */
+class TestRunner
+{
+public:
+    void Add(const std::string& name, TestFunc func);
+
+    /**
+     * @brief 运行匹配的用例
+     * @return 进程退出码：有用例失败时返回 1
+     */
+    int Run(const TestOptions& options);
+
+private:
+    struct TestCase
+    {
+        std::string name;
+        TestFunc func;
+    };
+    std::vector<TestCase> cases_;
+};
+
+// 各组用例的注册函数
+void RegisterMailboxTests(TestRunner& runner);
+void RegisterRouteTableTests(TestRunner& runner);
+void RegisterTimerTests(TestRunner& runner);
+
+} // namespace BaseNode
@@ -0,0 +1,297 @@
+#include "test_harness.h"
+#include "module/module_event.h"
+#include "module/module_mailbox.h"
+#include "module/module_options.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 模块邮箱（MPSC 分块队列和优先级通道）的多生产者压力测试
+// 每个事件携带 生产者编号 / 通道 / 序号，消费者按生产者（和通道）检查序号连续递增：
+// 序号跳变说明丢失或乱序，重复说明重复投递；结束时核对总数和邮箱统计
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define TEST_MAILBOX_PRODUCERS 4            // 生产者线程数
+#define TEST_MAILBOX_EVENTS 20000           // 每个生产者（每个通道）投递的事件数
+
+ModuleEvent MakeEvent(uint32_t producer, uint32_t lane, uint32_t seq)
+{
+    ModuleEvent event;
+    event.type_ = ModuleEvent::EventType::ET_RPC_REQUEST;
+    event.envelope_.client_id = producer;
+    event.envelope_.priority = static_cast<uint8_t>(lane);
+    event.envelope_.request_id = seq;
+    return event;
+}
+
+/**
+ * @brief 按生产者和通道记录下一个期望的序号
+ */
+class SequenceChecker
+{
+public:
+    SequenceChecker(uint32_t producers, uint32_t lanes) : lanes_(lanes), next_(producers * lanes, 0) {}
+
+    void Check(TestContext& ctx, const ModuleEvent& event)
+    {
+        uint32_t producer = static_cast<uint32_t>(event.envelope_.client_id);
+        uint32_t lane = event.envelope_.priority;
+        TEST_CHECK(ctx, producer * lanes_ + lane < next_.size());
+        if (producer * lanes_ + lane >= next_.size()) {
+            return;
+        }
+        uint32_t& next = next_[producer * lanes_ + lane];
+        TEST_CHECK(ctx, event.envelope_.request_id == next);
+        next = event.envelope_.request_id + 1;
+    }
+
+    void CheckComplete(TestContext& ctx, uint32_t expected) const
+    {
+        for (uint32_t next : next_) {
+            TEST_CHECK(ctx, next == expected);
+        }
+    }
+
+private:
+    uint32_t lanes_;
+    std::vector<uint32_t> next_;
+};
+
+/**
+ * @brief 多个生产者并发入队、一个消费者并发出队，检查不丢、不重、同一生产者先后顺序不变
+ * @param retry_on_overflow 入队失败时重试（REJECT 策略），否则要求每次入队都成功
+ * @param delay_consumer 消费者等主队列写满后再开始，确保走到溢出路径
+ */
+void RunMailboxStress(TestContext& ctx, const MailboxOptions& options, bool retry_on_overflow, bool delay_consumer)
+{
+    auto mailbox = std::make_unique<ModuleMailbox>();
+    mailbox->Configure(options);
+
+    std::atomic<bool> start{false};
+    std::atomic<uint32_t> finished{0};
+    std::atomic<uint64_t> failed_pushes{0};
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < TEST_MAILBOX_PRODUCERS; ++producer) {
+        producers.emplace_back([&, producer]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (uint32_t seq = 0; seq < TEST_MAILBOX_EVENTS; ++seq) {
+                ModuleEvent event = MakeEvent(producer, 0, seq);
+                while (mailbox->Push(std::move(event)) != ErrorCode::BN_SUCCESS) {
+                    if (!retry_on_overflow) {
+                        failed_pushes.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                    // 入队失败时事件没有被移走，可以原样重试
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    mailbox->BindConsumerThread();
+    SequenceChecker checker(TEST_MAILBOX_PRODUCERS, 1);
+    const uint64_t total = static_cast<uint64_t>(TEST_MAILBOX_PRODUCERS) * TEST_MAILBOX_EVENTS;
+    start.store(true, std::memory_order_release);
+    if (delay_consumer) {
+        while (mailbox->Depth() < options.capacity && finished.load(std::memory_order_acquire) < TEST_MAILBOX_PRODUCERS) {
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t received = 0;
+    ModuleEvent event;
+    while (received < total) {
+        if (mailbox->TryPop(event)) {
+            checker.Check(ctx, event);
+            ++received;
+            continue;
+        }
+        if (finished.load(std::memory_order_acquire) == TEST_MAILBOX_PRODUCERS && mailbox->Empty()) {
+            break;  // 有事件丢失，下面的检查会报告
+        }
+        // 邮箱暂时为空时归还块，与生产者的块分配并发
+        mailbox->Trim();
+    }
+    for (std::thread& thread : producers) {
+        thread.join();
+    }
+
+    TEST_CHECK(ctx, failed_pushes.load() == 0);
+    TEST_CHECK(ctx, received == total);
+    TEST_CHECK(ctx, !mailbox->TryPop(event));
+    checker.CheckComplete(ctx, TEST_MAILBOX_EVENTS);
+    MailboxQueueStats stats = mailbox->GetStats();
+    TEST_CHECK(ctx, stats.pushed == total);
+    TEST_CHECK(ctx, stats.popped == total);
+    TEST_CHECK(ctx, mailbox->Depth() == 0);
+    if (options.overflow_policy == MailboxOverflowPolicy::SPILL) {
+        TEST_CHECK(ctx, stats.spilled > 0);
+    }
+}
+
+MailboxOptions StressOptions(MailboxOverflowPolicy policy)
+{
+    MailboxOptions options;
+    options.capacity = 256;                 // 容量远小于事件总数，队列反复写满、绕圈
+    options.chunk_size = 32;
+    options.release_idle_ms = 1;            // 空闲 1 毫秒就归还块，让块的分配和归还频繁发生
+    options.overflow_policy = policy;
+    options.block_timeout_us = 1000000;
+    return options;
+}
+
+void TestMailboxReject(TestContext& ctx)
+{
+    RunMailboxStress(ctx, StressOptions(MailboxOverflowPolicy::REJECT), true, false);
+}
+
+void TestMailboxSpill(TestContext& ctx)
+{
+    RunMailboxStress(ctx, StressOptions(MailboxOverflowPolicy::SPILL), false, true);
+}
+
+void TestMailboxBlock(TestContext& ctx)
+{
+    RunMailboxStress(ctx, StressOptions(MailboxOverflowPolicy::BLOCK), false, false);
+}
+
+/**
+ * @brief 优先级邮箱：生产者并发向三个通道入队，消费者并发出队，按生产者和通道检查顺序
+ */
+void TestPriorityMailboxConcurrent(TestContext& ctx)
+{
+    auto mailbox = std::make_unique<ModulePriorityMailbox>();
+    mailbox->Configure(StressOptions(MailboxOverflowPolicy::REJECT));
+
+    std::atomic<uint32_t> finished{0};
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < TEST_MAILBOX_PRODUCERS; ++producer) {
+        producers.emplace_back([&, producer]() {
+            uint32_t seq[MODULE_MAILBOX_LANE_NUM] = {};
+            for (uint32_t i = 0; i < TEST_MAILBOX_EVENTS * MODULE_MAILBOX_LANE_NUM; ++i) {
+                // 每个生产者以不同的步长轮换通道，各通道的入队交错进行
+                uint32_t lane = (i * (producer + 1) + i / 7) % MODULE_MAILBOX_LANE_NUM;
+                if (seq[lane] == TEST_MAILBOX_EVENTS) {
+                    lane = (lane + 1) % MODULE_MAILBOX_LANE_NUM;
+                }
+                if (seq[lane] == TEST_MAILBOX_EVENTS) {
+                    lane = (lane + 1) % MODULE_MAILBOX_LANE_NUM;
+                }
+                ModuleEvent event = MakeEvent(producer, lane, seq[lane]);
+                while (mailbox->Push(std::move(event), static_cast<RpcPriority>(lane)) != ErrorCode::BN_SUCCESS) {
+                    std::this_thread::yield();
+                }
+                ++seq[lane];
+            }
+            finished.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    mailbox->BindConsumerThread();
+    SequenceChecker checker(TEST_MAILBOX_PRODUCERS, MODULE_MAILBOX_LANE_NUM);
+    const uint64_t total = static_cast<uint64_t>(TEST_MAILBOX_PRODUCERS) * TEST_MAILBOX_EVENTS * MODULE_MAILBOX_LANE_NUM;
+    uint64_t received = 0;
+    ModuleEvent event;
+    while (received < total) {
+        if (mailbox->TryPop(event)) {
+            checker.Check(ctx, event);
+            ++received;
+        } else if (finished.load(std::memory_order_acquire) == TEST_MAILBOX_PRODUCERS && mailbox->Empty()) {
+            break;
+        } else {
+            mailbox->Trim();
+        }
+    }
+    for (std::thread& thread : producers) {
+        thread.join();
+    }
+
+    TEST_CHECK(ctx, received == total);
+    checker.CheckComplete(ctx, TEST_MAILBOX_EVENTS);
+    for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+        MailboxLaneStats stats = mailbox->GetLaneStats(static_cast<RpcPriority>(lane));
+        TEST_CHECK(ctx, stats.pushed == static_cast<uint64_t>(TEST_MAILBOX_PRODUCERS) * TEST_MAILBOX_EVENTS);
+        TEST_CHECK(ctx, stats.popped == stats.pushed);
+        TEST_CHECK(ctx, stats.depth == 0);
+    }
+}
+
+/**
+ * @brief 优先级邮箱的出队顺序：各通道由多个生产者并发写入后，出队按加权轮转进行
+ * 当前通道连续处理至多 weight 个事件后切换到下一个通道，空通道直接跳过
+ */
+void TestPriorityMailboxWeightedOrder(TestContext& ctx)
+{
+    // 各通道的事件数不同，前后两段分别覆盖三个通道都有积压和部分通道已取空的情况
+    const uint32_t lane_events[MODULE_MAILBOX_LANE_NUM] = {400, 1000, 300};
+    MailboxOptions options = StressOptions(MailboxOverflowPolicy::SPILL);
+    options.lane_weights = {4, 2, 1};
+    auto mailbox = std::make_unique<ModulePriorityMailbox>();
+    mailbox->Configure(options);
+
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < TEST_MAILBOX_PRODUCERS; ++producer) {
+        producers.emplace_back([&, producer]() {
+            for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+                for (uint32_t seq = 0; seq < lane_events[lane]; ++seq) {
+                    ModuleEvent event = MakeEvent(producer, lane, seq);
+                    TEST_CHECK(ctx, mailbox->Push(std::move(event), static_cast<RpcPriority>(lane)) == ErrorCode::BN_SUCCESS);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : producers) {
+        thread.join();
+    }
+
+    // 按文档描述的规则推算期望的通道序列
+    uint32_t remaining[MODULE_MAILBOX_LANE_NUM];
+    for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+        remaining[lane] = lane_events[lane] * TEST_MAILBOX_PRODUCERS;
+    }
+    uint32_t expected_lane = 0;
+    uint32_t credit = options.lane_weights[0];
+
+    SequenceChecker checker(TEST_MAILBOX_PRODUCERS, MODULE_MAILBOX_LANE_NUM);
+    ModuleEvent event;
+    uint64_t received = 0;
+    while (mailbox->TryPop(event)) {
+        while (credit == 0 || remaining[expected_lane] == 0) {
+            expected_lane = (expected_lane + 1) % MODULE_MAILBOX_LANE_NUM;
+            credit = options.lane_weights[expected_lane];
+        }
+        TEST_CHECK(ctx, event.envelope_.priority == expected_lane);
+        --remaining[expected_lane];
+        --credit;
+        checker.Check(ctx, event);
+        ++received;
+    }
+    uint64_t total = 0;
+    for (uint32_t lane = 0; lane < MODULE_MAILBOX_LANE_NUM; ++lane) {
+        total += static_cast<uint64_t>(lane_events[lane]) * TEST_MAILBOX_PRODUCERS;
+        TEST_CHECK(ctx, remaining[lane] == 0);
+    }
+    TEST_CHECK(ctx, received == total);
+}
+
+} // namespace
+
+void RegisterMailboxTests(TestRunner& runner)
+{
+    runner.Add("mailbox/mpsc_reject_retry", TestMailboxReject);
+    runner.Add("mailbox/mpsc_spill", TestMailboxSpill);
+    runner.Add("mailbox/mpsc_block", TestMailboxBlock);
+    runner.Add("mailbox/priority_concurrent", TestPriorityMailboxConcurrent);
+    runner.Add("mailbox/priority_weighted_order", TestPriorityMailboxWeightedOrder);
+}
+
+} // namespace BaseNode
@@ -0,0 +1,45 @@
+#include "test_harness.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// 核心并发组件的测试
+// 用法: ./basenode_test [--filter=mailbox] [--list]
+// 并发用例应该在 ThreadSanitizer 构建下运行（cmake -DBASENODE_BUILD_TESTS=ON -DBASENODE_TSAN=ON）
+
+static bool ParseOption(const char* arg, const char* name, std::string& value)
+{
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = arg + length + 1;
+    return true;
+}
+
+static void PrintUsage(const char* program)
+{
+    printf("usage: %s [--filter=<substring>] [--list]\n", program);
+}
+
+int main(int argc, char* argv[])
+{
+    BaseNode::TestOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (strcmp(argv[i], "--list") == 0) {
+            options.list_only = true;
+        } else if (ParseOption(argv[i], "--filter", value)) {
+            options.filter = value;
+        } else {
+            PrintUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    BaseNode::TestRunner runner;
+    BaseNode::RegisterMailboxTests(runner);
+    BaseNode::RegisterRouteTableTests(runner);
+    BaseNode::RegisterTimerTests(runner);
+    return runner.Run(options);
+}
@@ -0,0 +1,207 @@
+#include "test_harness.h"
+#include "module/module_route_table.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 路由快照 RCU（RouteSnapshotDomain）的并发读写测试
+// 快照内容由版本号推算（模块指针只作为标记，不会被解引用），读者在读区内校验整份快照，
+// 快照被提前回收时校验失败或由 TSan 报告访问已释放的内存
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define TEST_ROUTE_READERS 6                // 并发读者线程数
+#define TEST_ROUTE_PUBLISHES 2000           // 写者发布的快照数
+#define TEST_ROUTE_SERVICES 16              // 每个快照中的服务数
+
+IModule* FakeModule(uint64_t version, uint32_t index)
+{
+    return reinterpret_cast<IModule*>(static_cast<uintptr_t>((version << 8) | (index + 1)));
+}
+
+RouteSnapshot* MakeSnapshot(uint64_t version)
+{
+    auto snapshot = new RouteSnapshot();
+    snapshot->version = version;
+    std::unordered_map<uint32_t, IModule*> services;
+    std::unordered_map<uint32_t, IModule*> modules;
+    for (uint32_t i = 0; i < TEST_ROUTE_SERVICES; ++i) {
+        services[1000 + i] = FakeModule(version, i);
+        modules[1 + i % 4] = FakeModule(version, i % 4);
+    }
+    snapshot->services.Build(services);
+    snapshot->modules.Build(modules);
+    snapshot->network_module = FakeModule(version, 0xFE);
+    snapshot->all_modules.assign(version % 8 + 1, FakeModule(version, 0));
+    return snapshot;
+}
+
+// 快照的每个字段都应与它的版本号一致
+bool CheckSnapshot(const RouteSnapshot& snapshot)
+{
+    uint64_t version = snapshot.version;
+    for (uint32_t i = 0; i < TEST_ROUTE_SERVICES; ++i) {
+        if (snapshot.services.Find(1000 + i) != FakeModule(version, i)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (snapshot.modules.Find(1 + i) != FakeModule(version, i)) {
+            return false;
+        }
+    }
+    if (snapshot.network_module != FakeModule(version, 0xFE) || snapshot.all_modules.size() != version % 8 + 1) {
+        return false;
+    }
+    for (IModule* module : snapshot.all_modules) {
+        if (module != FakeModule(version, 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 多个读者不停进出读区，写者连续发布新快照：读者看到的版本单调不减、快照内容完整，
+ * 部分读者在读区内停留跨过多次发布；结束后所有旧快照都已回收
+ */
+void TestRouteSnapshotConcurrent(TestContext& ctx)
+{
+    auto domain = std::make_unique<RouteSnapshotDomain>();
+    domain->Publish(MakeSnapshot(1), false);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (uint32_t reader = 0; reader < TEST_ROUTE_READERS; ++reader) {
+        readers.emplace_back([&, reader]() {
+            uint64_t last_version = 0;
+            for (uint64_t round = 0; !stop.load(std::memory_order_acquire); ++round) {
+                RouteSnapshotDomain::ReadGuard guard(*domain);
+                TEST_CHECK(ctx, guard->version >= last_version);
+                last_version = guard->version;
+                TEST_CHECK(ctx, CheckSnapshot(*guard));
+                if ((round + reader) % 64 == 0) {
+                    // 在读区内停留，期间写者会发布新快照；嵌套读区读到的是新快照，外层快照仍然有效
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    {
+                        RouteSnapshotDomain::ReadGuard nested(*domain);
+                        TEST_CHECK(ctx, nested->version >= guard->version);
+                        TEST_CHECK(ctx, CheckSnapshot(*nested));
+                    }
+                    TEST_CHECK(ctx, guard->version == last_version);
+                    TEST_CHECK(ctx, CheckSnapshot(*guard));
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (uint64_t version = 2; version <= TEST_ROUTE_PUBLISHES; ++version) {
+        // 每隔一段等待旧读者离开（与注销模块相同的路径）
+        domain->Publish(MakeSnapshot(version), version % 100 == 0);
+        if (version % 16 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    stop.store(true, std::memory_order_release);
+    for (std::thread& thread : readers) {
+        thread.join();
+    }
+
+    TEST_CHECK(ctx, reads.load() > 0);
+    // 读者都已离开读区，再发布一次应回收所有旧快照
+    domain->Publish(MakeSnapshot(TEST_ROUTE_PUBLISHES + 1), false);
+    TEST_CHECK(ctx, domain->RetiredCount() == 0);
+}
+
+/**
+ * @brief 读者在读区内时发布新快照：旧快照保留到读者离开，读者离开后的下一次发布将其回收
+ */
+void TestRouteSnapshotReaderAcrossPublish(TestContext& ctx)
+{
+    auto domain = std::make_unique<RouteSnapshotDomain>();
+    domain->Publish(MakeSnapshot(1), false);
+    TEST_CHECK(ctx, domain->RetiredCount() == 0);
+
+    std::atomic<int> stage{0};
+    std::thread reader([&]() {
+        RouteSnapshotDomain::ReadGuard guard(*domain);
+        TEST_CHECK(ctx, guard->version == 1);
+        stage.store(1, std::memory_order_release);
+        while (stage.load(std::memory_order_acquire) != 2) {
+            std::this_thread::yield();
+        }
+        // 写者已经发布了两个新快照，读区内的快照仍然有效
+        TEST_CHECK(ctx, guard->version == 1);
+        TEST_CHECK(ctx, CheckSnapshot(*guard));
+    });
+    std::thread writer([&]() {
+        while (stage.load(std::memory_order_acquire) != 1) {
+            std::this_thread::yield();
+        }
+        domain->Publish(MakeSnapshot(2), false);
+        domain->Publish(MakeSnapshot(3), false);
+        // 版本 1 有读者在用不能回收；版本 2 在读者进入读区之后才发布，读者没有读到它，但按 epoch 判断同样要等读者离开
+        TEST_CHECK(ctx, domain->RetiredCount() == 2);
+        stage.store(2, std::memory_order_release);
+    });
+    writer.join();
+    reader.join();
+
+    std::thread next_writer([&]() {
+        domain->Publish(MakeSnapshot(4), false);
+        TEST_CHECK(ctx, domain->RetiredCount() == 0);
+    });
+    next_writer.join();
+}
+
+/**
+ * @brief 等待读者的发布（注销模块）：读者离开读区之前不返回，返回时旧快照已回收
+ */
+void TestRouteSnapshotWaitReaders(TestContext& ctx)
+{
+    auto domain = std::make_unique<RouteSnapshotDomain>();
+    domain->Publish(MakeSnapshot(1), false);
+
+    std::atomic<int> stage{0};
+    std::atomic<bool> reader_left{false};
+    std::thread reader([&]() {
+        {
+            RouteSnapshotDomain::ReadGuard guard(*domain);
+            stage.store(1, std::memory_order_release);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            TEST_CHECK(ctx, CheckSnapshot(*guard));
+            reader_left.store(true, std::memory_order_release);
+        }
+    });
+    std::thread writer([&]() {
+        while (stage.load(std::memory_order_acquire) != 1) {
+            std::this_thread::yield();
+        }
+        domain->Publish(MakeSnapshot(2), true);
+        TEST_CHECK(ctx, reader_left.load(std::memory_order_acquire));
+        TEST_CHECK(ctx, domain->RetiredCount() == 0);
+    });
+    writer.join();
+    reader.join();
+}
+
+} // namespace
+
+void RegisterRouteTableTests(TestRunner& runner)
+{
+    runner.Add("route_table/snapshot_concurrent", TestRouteSnapshotConcurrent);
+    runner.Add("route_table/reader_across_publish", TestRouteSnapshotReaderAcrossPublish);
+    runner.Add("route_table/publish_wait_readers", TestRouteSnapshotWaitReaders);
+}
+
+} // namespace BaseNode
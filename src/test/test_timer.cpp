@@ -0,0 +1,220 @@
+#include "test_harness.h"
+#include "module/module_reactor.h"
+#include "module/module_timer.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// 分层时间轮（ModuleTimerWheel）的测试
+// 时间轮推进到远超真实时间的虚拟时间后再添加定时器，到期 tick 完全由测试控制：
+// 在期望的 tick 之前一个 tick 检查尚未触发，推进到期望的 tick 时检查恰好触发
+
+namespace BaseNode
+{
+
+namespace
+{
+
+#define TEST_TIMER_LEVEL1_SPAN (1LL << MODULE_TIMER_LEVEL0_BITS)                                   // 第 0 层跨度（256）
+#define TEST_TIMER_LEVEL2_SPAN (1LL << (MODULE_TIMER_LEVEL0_BITS + MODULE_TIMER_LEVEL_BITS))       // 第 1 层跨度（16384）
+#define TEST_TIMER_LEVEL3_SPAN (1LL << (MODULE_TIMER_LEVEL0_BITS + 2 * MODULE_TIMER_LEVEL_BITS))   // 第 2 层跨度（2^20）
+#define TEST_TIMER_MAX_SPAN (1LL << (MODULE_TIMER_LEVEL0_BITS + 3 * MODULE_TIMER_LEVEL_BITS))      // 最高层跨度（2^26）
+
+/**
+ * @brief 用虚拟 tick 驱动的时间轮
+ */
+class VirtualWheel
+{
+public:
+    // start_tick 为开始时已推进到的 tick，远大于测试运行期间真实流逝的毫秒数
+    explicit VirtualWheel(int64_t start_tick)
+        : base_ns_(ModuleReactor::NowNs()), wheel_(std::make_unique<ModuleTimerWheel>(base_ns_))
+    {
+        AdvanceTo(start_tick);
+    }
+
+    ModuleTimerWheel& operator*() { return *wheel_; }
+    ModuleTimerWheel* operator->() { return wheel_.get(); }
+
+    size_t AdvanceTo(int64_t tick)
+    {
+        now_ = tick;
+        return wheel_->Advance(base_ns_ + tick * 1000000);
+    }
+
+    int64_t Now() const { return now_; }
+
+private:
+    int64_t base_ns_;
+    std::unique_ptr<ModuleTimerWheel> wheel_;
+    int64_t now_ = 0;
+};
+
+/**
+ * @brief 各种延迟的一次性定时器都在期望的 tick 触发：覆盖每层跨度的边界（需要逐层降级）和超出最高层跨度被截断的延迟
+ * @param start_tick 开始的 tick，分别取对齐到最高层一圈的位置和一圈将尽的位置，使降级发生在不同的相位
+ */
+void RunCascadeBoundaries(TestContext& ctx, int64_t start_tick)
+{
+    const int64_t delays[] = {
+        1, 2, 100,
+        TEST_TIMER_LEVEL1_SPAN - 1, TEST_TIMER_LEVEL1_SPAN, TEST_TIMER_LEVEL1_SPAN + 1,
+        TEST_TIMER_LEVEL2_SPAN - 1, TEST_TIMER_LEVEL2_SPAN, TEST_TIMER_LEVEL2_SPAN + 1,
+        TEST_TIMER_LEVEL3_SPAN - 1, TEST_TIMER_LEVEL3_SPAN, TEST_TIMER_LEVEL3_SPAN + 1,
+        TEST_TIMER_MAX_SPAN - 1,
+        // 超出最高层跨度：先放在最高层最远的槽，降级时按真实到期时间重新放置
+        TEST_TIMER_MAX_SPAN, TEST_TIMER_MAX_SPAN + TEST_TIMER_LEVEL3_SPAN + 5,
+    };
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+
+    VirtualWheel wheel(start_tick);
+    std::vector<int64_t> fired_at(count, -1);
+    for (size_t i = 0; i < count; ++i) {
+        wheel->AddTimer(static_cast<uint32_t>(delays[i]), [&, i]() { fired_at[i] = wheel.Now(); });
+    }
+    TEST_CHECK(ctx, wheel->Size() == count);
+
+    for (size_t i = 0; i < count; ++i) {
+        int64_t expire = start_tick + delays[i];
+        wheel.AdvanceTo(expire - 1);
+        TEST_CHECK(ctx, fired_at[i] == -1);
+        wheel.AdvanceTo(expire);
+        TEST_CHECK(ctx, fired_at[i] == expire);
+    }
+    TEST_CHECK(ctx, wheel->Size() == 0);
+}
+
+void TestTimerCascadeAligned(TestContext& ctx)
+{
+    RunCascadeBoundaries(ctx, TEST_TIMER_MAX_SPAN);
+}
+
+void TestTimerCascadeUnaligned(TestContext& ctx)
+{
+    RunCascadeBoundaries(ctx, 2 * TEST_TIMER_MAX_SPAN - TEST_TIMER_LEVEL2_SPAN - 3);
+}
+
+/**
+ * @brief 同一个 tick 到期的定时器在回调中互相取消：先触发的取消后触发的，被取消的不再触发；
+ * 取消正在触发的一次性定时器返回 false；回调中新加的定时器在之后的 tick 触发
+ */
+void TestTimerCancelDuringTick(TestContext& ctx)
+{
+    VirtualWheel wheel(TEST_TIMER_MAX_SPAN);
+    int64_t expire = wheel.Now() + 10;
+    TimerId ids[2] = {0, 0};
+    int fired[2] = {0, 0};
+    bool cancel_self = true;
+    bool cancel_other = false;
+    for (int i = 0; i < 2; ++i) {
+        ids[i] = wheel->AddTimer(10, [&, i]() {
+            ++fired[i];
+            cancel_self = wheel->Cancel(ids[i]);
+            cancel_other = wheel->Cancel(ids[1 - i]);
+        });
+    }
+    // 同一个 tick 到期、但已经被取消的定时器，以及回调中新加的定时器
+    TimerId cancelled = wheel->AddTimer(10, [&]() { TEST_CHECK(ctx, false); });
+    TEST_CHECK(ctx, wheel->Cancel(cancelled));
+    TEST_CHECK(ctx, !wheel->Cancel(cancelled));
+    int64_t added_fired_at = -1;
+    wheel->AddTimer(10, [&]() {
+        wheel->AddTimer(1, [&]() { added_fired_at = wheel.Now(); });
+    });
+
+    TEST_CHECK(ctx, wheel.AdvanceTo(expire) == 2);
+    TEST_CHECK(ctx, fired[0] + fired[1] == 1);
+    TEST_CHECK(ctx, !cancel_self);
+    TEST_CHECK(ctx, cancel_other);
+    TEST_CHECK(ctx, added_fired_at == -1);
+    TEST_CHECK(ctx, wheel->Size() == 1);
+    wheel.AdvanceTo(expire + 1);
+    TEST_CHECK(ctx, added_fired_at == expire + 1);
+    TEST_CHECK(ctx, wheel->Size() == 0);
+
+    // 周期定时器在回调中取消自身：返回 true，之后不再触发
+    int periodic_fired = 0;
+    TimerId periodic = 0;
+    periodic = wheel->AddPeriodicTimer(5, [&]() {
+        ++periodic_fired;
+        TEST_CHECK(ctx, wheel->Cancel(periodic));
+    });
+    wheel.AdvanceTo(expire + 100);
+    TEST_CHECK(ctx, periodic_fired == 1);
+    TEST_CHECK(ctx, wheel->Size() == 0);
+}
+
+/**
+ * @brief 周期定时器每次触发后按周期重新挂回：逐 tick 推进和一次推进很多 tick 时触发的 tick 都准确，
+ * 周期跨过第 0 层时同样经过降级；定时器 ID 在多次触发后仍然有效
+ */
+void TestTimerPeriodicReinsert(TestContext& ctx)
+{
+    VirtualWheel wheel(TEST_TIMER_MAX_SPAN - 7);
+    int64_t start = wheel.Now();
+    std::vector<int64_t> short_ticks;
+    std::vector<int64_t> long_ticks;
+    TimerId short_id = wheel->AddPeriodicTimer(3, [&]() { short_ticks.push_back(wheel.Now()); });
+    wheel->AddPeriodicTimer(300, [&]() { long_ticks.push_back(wheel.Now()); });
+
+    // 逐 tick 推进
+    for (int64_t tick = start + 1; tick <= start + 1000; ++tick) {
+        wheel.AdvanceTo(tick);
+    }
+    TEST_CHECK(ctx, short_ticks.size() == 333);
+    for (size_t i = 0; i < short_ticks.size(); ++i) {
+        TEST_CHECK(ctx, short_ticks[i] == start + 3 * static_cast<int64_t>(i + 1));
+    }
+    TEST_CHECK(ctx, long_ticks.size() == 3);
+    for (size_t i = 0; i < long_ticks.size(); ++i) {
+        TEST_CHECK(ctx, long_ticks[i] == start + 300 * static_cast<int64_t>(i + 1));
+    }
+
+    // 一次推进 10000 个 tick：错过的每个周期都会逐个触发
+    short_ticks.clear();
+    long_ticks.clear();
+    TEST_CHECK(ctx, wheel.AdvanceTo(start + 11000) == 3333 + 33);
+    TEST_CHECK(ctx, short_ticks.size() == 3333);
+    TEST_CHECK(ctx, long_ticks.size() == 33);
+
+    TEST_CHECK(ctx, wheel->Size() == 2);
+    TEST_CHECK(ctx, wheel->Cancel(short_id));
+    TEST_CHECK(ctx, wheel->Size() == 1);
+    wheel.AdvanceTo(start + 11100);
+    TEST_CHECK(ctx, short_ticks.size() == 3333);
+}
+
+/**
+ * @brief 周期定时器的回调抛出异常：异常被时间轮吞掉并记录，定时器保留，之后的触发仍然调用同一个回调
+ */
+void TestTimerPeriodicThrow(TestContext& ctx)
+{
+    VirtualWheel wheel(TEST_TIMER_MAX_SPAN);
+    int calls = 0;
+    wheel->AddPeriodicTimer(2, [&]() {
+        ++calls;
+        if (calls % 2 == 1) {
+            throw std::runtime_error("periodic callback failure");
+        }
+    });
+    int64_t start = wheel.Now();
+    for (int64_t tick = start + 1; tick <= start + 20; ++tick) {
+        wheel.AdvanceTo(tick);
+    }
+    TEST_CHECK(ctx, calls == 10);
+    TEST_CHECK(ctx, wheel->Size() == 1);
+}
+
+} // namespace
+
+void RegisterTimerTests(TestRunner& runner)
+{
+    runner.Add("timer/cascade_aligned", TestTimerCascadeAligned);
+    runner.Add("timer/cascade_unaligned", TestTimerCascadeUnaligned);
+    runner.Add("timer/cancel_during_tick", TestTimerCancelDuringTick);
+    runner.Add("timer/periodic_reinsert", TestTimerPeriodicReinsert);
+    runner.Add("timer/periodic_throw", TestTimerPeriodicThrow);
+}
+
+} // namespace BaseNode